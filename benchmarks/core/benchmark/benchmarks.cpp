@@ -0,0 +1,146 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <Kaleidoscope-LEDControl.h>
+#include <Kaleidoscope-LEDEffect-Chase.h>
+#include <Kaleidoscope-LEDEffect-Rainbow.h>
+
+#include "testing/setup-benchmarks.h"
+
+SETUP_BENCHMARKS("core");
+
+namespace {
+
+using kaleidoscope::KeyEvent;
+using kaleidoscope::Runtime;
+using kaleidoscope::live_keys;
+using kaleidoscope::testing::Benchmark;
+using kaleidoscope::testing::SimHarness;
+
+// These match the layers & key positions of the keymap in `core.ino`.
+constexpr uint8_t NUMPAD   = 1;
+constexpr uint8_t FUNCTION = 2;
+
+constexpr KeyAddr key_a{2, 1};
+constexpr KeyAddr key_h{2, 10};
+constexpr KeyAddr key_shift{3, 7};
+constexpr KeyAddr key_fn{3, 6};
+constexpr KeyAddr key_space{1, 8};
+
+constexpr uint32_t iterations = 20000;
+
+void press(KeyAddr addr) {
+  Runtime.handleKeyswitchEvent(KeyEvent::next(addr, IS_PRESSED));
+}
+
+void release(KeyAddr addr) {
+  Runtime.handleKeyswitchEvent(KeyEvent::next(addr, WAS_PRESSED));
+}
+
+void benchmarkKeyswitchEvents(Benchmark &benchmark) {
+  benchmark.measure("handleKeyswitchEvent/tap", iterations, 2, []() {
+    press(key_a);
+    release(key_a);
+  });
+  benchmark.measure("handleKeyswitchEvent/shifted-tap", iterations, 4, []() {
+    press(key_shift);
+    press(key_a);
+    release(key_a);
+    release(key_shift);
+  });
+  // `Fn+H` is the left arrow key, so this includes the layer change, and
+  // looking up a key on a layer other than the base layer.
+  benchmark.measure("handleKeyswitchEvent/layer-shift", iterations, 4, []() {
+    press(key_fn);
+    press(key_h);
+    release(key_h);
+    release(key_fn);
+  });
+}
+
+void benchmarkLayers(Benchmark &benchmark) {
+  benchmark.measure("Layer.updateActiveLayers/1-layer", iterations, 1, []() {
+    Layer.updateActiveLayers();
+  });
+  Layer.activate(NUMPAD);
+  Layer.activate(FUNCTION);
+  benchmark.measure("Layer.updateActiveLayers/3-layers", iterations, 1, []() {
+    Layer.updateActiveLayers();
+  });
+  Layer.move(0);
+}
+
+void benchmarkKeyboardReports(Benchmark &benchmark) {
+  // The report is prepared for the release of a key that isn't held, as if it
+  // had just been released.
+  KeyEvent event = KeyEvent::next(key_space, WAS_PRESSED);
+
+  benchmark.measure("prepareKeyboardReport/0-keys", iterations, 1, [&event]() {
+    Runtime.prepareKeyboardReport(event);
+  });
+
+  // Six keys held at once: a modifier, and the rest of the home row.
+  for (KeyAddr key_addr : {key_shift, key_a, KeyAddr(2, 2), KeyAddr(2, 3),
+                           KeyAddr(2, 4), KeyAddr(2, 5)})
+    live_keys.activate(key_addr, Runtime.lookupKey(key_addr));
+  benchmark.measure("prepareKeyboardReport/6-keys", iterations, 1, [&event]() {
+    Runtime.prepareKeyboardReport(event);
+  });
+  live_keys.clear();
+}
+
+void benchmarkLEDEffects(Benchmark &benchmark) {
+  // The effects only update when their update delay has passed, and the time
+  // doesn't change during a benchmark, so the delays are set to zero to make
+  // them do their work every time.
+  LEDRainbowEffect.update_delay(0);
+  LEDRainbowEffect.activate();
+  benchmark.measure("LEDRainbowEffect.update", iterations, 1, []() {
+    ::LEDControl.update();
+  });
+
+  LEDRainbowWaveEffect.update_delay(0);
+  LEDRainbowWaveEffect.activate();
+  benchmark.measure("LEDRainbowWaveEffect.update", iterations, 1, []() {
+    ::LEDControl.update();
+  });
+
+  LEDChaseEffect.update_delay(0);
+  LEDChaseEffect.activate();
+  benchmark.measure("LEDChaseEffect.update", iterations, 1, []() {
+    ::LEDControl.update();
+  });
+
+  ::LEDControl.set_mode(0);
+}
+
+void benchmarkCycles(Benchmark &benchmark) {
+  SimHarness sim;
+  benchmark.measure("Runtime.loop/idle", iterations, 1, [&sim]() {
+    sim.RunCycle();
+  });
+}
+
+}  // namespace
+
+void runBenchmarks(Benchmark &benchmark) {
+  benchmarkKeyswitchEvents(benchmark);
+  benchmarkLayers(benchmark);
+  benchmarkKeyboardReports(benchmark);
+  benchmarkLEDEffects(benchmark);
+  benchmarkCycles(benchmark);
+}
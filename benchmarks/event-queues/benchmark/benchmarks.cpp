@@ -0,0 +1,154 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vector>  // for vector
+
+#include "kaleidoscope/KeyAddrEventQueue.h"  // for RingKeyAddrEventQueue, ShiftingKeyAddrE...
+#include "testing/QueueTraces.h"             // for replayQukeysTrace, rolloverTrace
+#include "testing/setup-benchmarks.h"
+
+SETUP_BENCHMARKS("event-queues");
+
+namespace {
+
+using kaleidoscope::testing::Benchmark;
+using kaleidoscope::testing::SimHarness;
+
+// Key positions in the keymap in `event-queues.ino`.
+constexpr KeyAddr key_td_0{2, 0};
+constexpr KeyAddr key_x{3, 2};
+
+constexpr uint32_t iterations = 2000;
+
+struct TraceEvent {
+  KeyAddr addr;
+  bool press;
+};
+
+// A fast typist rolling over keys on both halves of the alphanumeric block,
+// with up to three keys held at once, and keys mostly released in the order
+// they were pressed. A third of the keys are home row modifiers (Qukeys), and
+// they get resolved one way or the other as the trace goes on. All the keys are
+// released at the end. The trace is generated by a fixed pseudo-random
+// sequence, so it's the same on every run.
+std::vector<TraceEvent> rolloverTrace() {
+  static constexpr KeyAddr keys[] = {
+    KeyAddr(1, 1), KeyAddr(1, 2), KeyAddr(1, 3), KeyAddr(1, 4), KeyAddr(1, 5),
+    KeyAddr(2, 1), KeyAddr(2, 2), KeyAddr(2, 3), KeyAddr(2, 4), KeyAddr(2, 5),
+    KeyAddr(1, 10), KeyAddr(1, 11), KeyAddr(1, 12), KeyAddr(1, 13), KeyAddr(1, 14),
+    KeyAddr(2, 10), KeyAddr(2, 11), KeyAddr(2, 12), KeyAddr(2, 13), KeyAddr(2, 14),
+  };
+  constexpr uint8_t key_count   = sizeof(keys) / sizeof(keys[0]);
+  constexpr uint8_t max_held    = 3;
+  constexpr uint16_t keystrokes = 100;
+
+  uint32_t random = 1;
+  auto next       = [&random](uint32_t limit) {
+    random = random * 1664525 + 1013904223;
+    return (random >> 8) % limit;
+  };
+
+  std::vector<TraceEvent> trace;
+  std::vector<KeyAddr> held;
+  uint16_t pressed = 0;
+  while (pressed < keystrokes || !held.empty()) {
+    bool can_press = pressed < keystrokes && held.size() < max_held;
+    if (can_press && (held.empty() || next(3) != 0)) {
+      KeyAddr addr      = keys[next(key_count)];
+      bool already_held = false;
+      for (KeyAddr h : held)
+        already_held |= (h == addr);
+      if (already_held)
+        continue;
+      held.push_back(addr);
+      trace.push_back({addr, true});
+      ++pressed;
+    } else {
+      size_t i = (next(4) == 0) ? next(held.size()) : 0;
+      trace.push_back({held[i], false});
+      held.erase(held.begin() + i);
+    }
+  }
+  return trace;
+}
+
+void benchmarkQukeys(Benchmark &benchmark, SimHarness &sim) {
+  // Each event is followed by two cycles, as if the typist were very fast
+  // indeed (or the scan rate very slow).
+  std::vector<TraceEvent> trace = rolloverTrace();
+  benchmark.measure("Qukeys/rollover", iterations / 10, trace.size(), [&]() {
+    for (const TraceEvent &event : trace) {
+      if (event.press) {
+        sim.Press(event.addr);
+      } else {
+        sim.Release(event.addr);
+      }
+      sim.RunCycles(2);
+    }
+  });
+}
+
+void benchmarkTapDance(Benchmark &benchmark, SimHarness &sim) {
+  // A double tap, resolved by the press of another key, rather than by the
+  // timeout.
+  benchmark.measure("TapDance/double-tap-interrupted", iterations, 6, [&]() {
+    for (KeyAddr addr : {key_td_0, key_td_0, key_x}) {
+      sim.Press(addr);
+      sim.RunCycles(2);
+      sim.Release(addr);
+      sim.RunCycles(2);
+    }
+  });
+}
+
+// The replays' results are kept here, so they can't be optimized away.
+volatile uint32_t queue_checksum;
+
+// The two queue implementations on their own, replaying Qukeys-like rollover
+// traces with more and more keys held at once.
+template<typename _Queue>
+void benchmarkQueue(Benchmark &benchmark, const char *name, uint8_t max_held) {
+  auto trace = kaleidoscope::testing::rolloverTrace(1000, max_held, 42);
+  benchmark.measure(name, iterations / 10, trace.size(), [&]() {
+    _Queue queue;
+    queue_checksum = kaleidoscope::testing::replayQukeysTrace(queue, trace);
+  });
+}
+
+void benchmarkQueues(Benchmark &benchmark) {
+  using kaleidoscope::RingKeyAddrEventQueue;
+  using kaleidoscope::ShiftingKeyAddrEventQueue;
+
+  benchmarkQueue<ShiftingKeyAddrEventQueue<8>>(benchmark, "KeyAddrEventQueue/shifting/rollover-2", 2);
+  benchmarkQueue<RingKeyAddrEventQueue<8>>(benchmark, "KeyAddrEventQueue/ring/rollover-2", 2);
+  benchmarkQueue<ShiftingKeyAddrEventQueue<8>>(benchmark, "KeyAddrEventQueue/shifting/rollover-4", 4);
+  benchmarkQueue<RingKeyAddrEventQueue<8>>(benchmark, "KeyAddrEventQueue/ring/rollover-4", 4);
+  benchmarkQueue<ShiftingKeyAddrEventQueue<8>>(benchmark, "KeyAddrEventQueue/shifting/rollover-6", 6);
+  benchmarkQueue<RingKeyAddrEventQueue<8>>(benchmark, "KeyAddrEventQueue/ring/rollover-6", 6);
+}
+
+}  // namespace
+
+void runBenchmarks(Benchmark &benchmark) {
+  SimHarness sim;
+  benchmark.measure("Runtime.loop/idle", iterations * 10, 1, [&sim]() {
+    sim.RunCycle();
+  });
+  benchmarkQukeys(benchmark, sim);
+  benchmarkTapDance(benchmark, sim);
+  benchmarkQueues(benchmark);
+}
@@ -0,0 +1,88 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// A sketch with home row modifiers (Qukeys) and TapDance keys, for benchmarking
+// the plugins that delay keyswitch events in a queue.
+
+#include <Kaleidoscope.h>
+#include <Kaleidoscope-OneShot.h>
+#include <Kaleidoscope-Qukeys.h>
+#include <Kaleidoscope-TapDance.h>
+
+enum {
+  PRIMARY,
+  NAVIGATION,
+};
+
+// *INDENT-OFF*
+KEYMAPS(
+  [PRIMARY] = KEYMAP_STACKED
+  (___,          Key_1,    Key_2,    Key_3,    Key_4,    Key_5, ___,
+   Key_Backtick, Key_Q,    Key_W,    Key_E,    Key_R,    Key_T, Key_Tab,
+   TD(0),        GUI_T(A), ALT_T(S), CTL_T(D), SFT_T(F), Key_G,
+   TD(1),        Key_Z,    Key_X,    Key_C,    Key_V,    Key_B, Key_Escape,
+   OSM(LeftControl), Key_Backspace, OSM(LeftGui), OSM(LeftShift),
+   LT(NAVIGATION, Escape),
+
+   ___,           Key_6, Key_7,    Key_8,     Key_9,      Key_0,            ___,
+   Key_Enter,     Key_Y, Key_U,    Key_I,     Key_O,      Key_P,            Key_Equals,
+                  Key_H, SFT_T(J), CTL_T(K),  ALT_T(L),   GUI_T(Semicolon), Key_Quote,
+   Key_RightAlt,  Key_N, Key_M,    Key_Comma, Key_Period, Key_Slash,        Key_Minus,
+   OSM(RightShift), OSM(LeftAlt), Key_Spacebar, OSM(RightControl),
+   LT(NAVIGATION, Enter)),
+
+  [NAVIGATION] =  KEYMAP_STACKED
+  (___, ___, ___, ___, ___, ___, ___,
+   ___, ___, ___, ___, ___, ___, ___,
+   ___, ___, ___, ___, ___, ___,
+   ___, ___, ___, ___, ___, ___, ___,
+   ___, ___, ___, ___,
+   ___,
+
+   ___, ___,           ___,           ___,         ___,            ___, ___,
+   ___, Key_Home,      Key_PageDown,  Key_PageUp,  Key_End,        ___, ___,
+        Key_LeftArrow, Key_DownArrow, Key_UpArrow, Key_RightArrow, ___, ___,
+   ___, ___,           ___,           ___,         ___,            ___, ___,
+   ___, ___, ___, ___,
+   ___)
+)
+// *INDENT-ON*
+
+void tapDanceAction(uint8_t tap_dance_index,
+                    KeyAddr key_addr,
+                    uint8_t tap_count,
+                    kaleidoscope::plugin::TapDance::ActionType tap_dance_action) {
+  switch (tap_dance_index) {
+  case 0:
+    return tapDanceActionKeys(tap_count, tap_dance_action,
+                              Key_PageUp, Key_Home);
+  case 1:
+    return tapDanceActionKeys(tap_count, tap_dance_action,
+                              Key_PageDown, Key_End);
+  default:
+    break;
+  }
+}
+
+KALEIDOSCOPE_INIT_PLUGINS(Qukeys, TapDance, OneShot);
+
+void setup() {
+  Kaleidoscope.setup();
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
@@ -461,9 +461,9 @@ static void toggleKeyboardProtocol(uint8_t combo_index) {
  */
 static void toggleKeymapSource(uint8_t combo_index) {
   if (Layer.getKey == Layer.getKeyFromPROGMEM) {
-    Layer.getKey = EEPROMKeymap.getKey;
+    Layer.setKeymapSource(EEPROMKeymap.getKey, EEPROMKeymap.getOpaqueKeys);
   } else {
-    Layer.getKey = Layer.getKeyFromPROGMEM;
+    Layer.setKeymapSource(Layer.getKeyFromPROGMEM, Layer.getOpaqueKeysFromPROGMEM);
   }
 }
 
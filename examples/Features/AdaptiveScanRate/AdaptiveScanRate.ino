@@ -0,0 +1,60 @@
+/* -*- mode: c++ -*-
+ * Kaleidoscope-AdaptiveScanRate -- Configure the idle and active keyscan rates
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Once configured via Focus, for example with:
+//
+//   scanrate.idle_interval 20000
+//   scanrate.idle_timeout 1000
+//
+// the keyscanner scans the matrix every 20ms after a second without any keys
+// pressed, and returns to its normal rate as soon as a key is pressed.
+
+#include <Kaleidoscope.h>
+#include <Kaleidoscope-AdaptiveScanRate.h>
+#include <Kaleidoscope-EEPROM-Settings.h>
+#include <Kaleidoscope-FocusSerial.h>
+
+// clang-format off
+KEYMAPS(
+  [0] = KEYMAP_STACKED
+  (
+       Key_Q   ,Key_W   ,Key_E       ,Key_R         ,Key_T
+      ,Key_A   ,Key_S   ,Key_D       ,Key_F         ,Key_G
+      ,Key_Z   ,Key_X   ,Key_C       ,Key_V         ,Key_B, Key_Backtick
+      ,Key_Esc ,Key_Tab ,Key_LeftGui ,Key_LeftShift ,Key_Backspace ,Key_LeftControl
+
+                     ,Key_Y     ,Key_U      ,Key_I     ,Key_O      ,Key_P
+                     ,Key_H     ,Key_J      ,Key_K     ,Key_L      ,Key_Semicolon
+       ,Key_Backslash,Key_N     ,Key_M      ,Key_Comma ,Key_Period ,Key_Slash
+       ,Key_LeftAlt  ,Key_Space ,Key_Enter  ,Key_Minus ,Key_Quote  ,Key_Enter
+  ),
+)
+// clang-format on
+
+KALEIDOSCOPE_INIT_PLUGINS(EEPROMSettings, Focus, AdaptiveScanRate);
+
+// While idle, wake up on a pin change interrupt rather than on the next idle
+// tick. Leave this out if something else in the sketch handles `PCINT0_vect`.
+KALEIDOSCOPE_KEYSCANNER_WAKEUP_ISR()
+
+void setup() {
+  Kaleidoscope.setup();
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
@@ -0,0 +1,115 @@
+/* -*- mode: c++ -*-
+ * Kaleidoscope-AdaptiveScanRate -- Configure the idle and active keyscan rates
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope/plugin/AdaptiveScanRate.h"
+
+#include <Arduino.h>                       // for F, PSTR, __FlashStringHelper
+#include <Kaleidoscope-EEPROM-Settings.h>  // for EEPROMSettings
+#include <Kaleidoscope-FocusSerial.h>      // for Focus, FocusSerial
+#include <stdint.h>                        // for uint16_t
+
+#include "kaleidoscope/Runtime.h"                     // for Runtime, Runtime_
+#include "kaleidoscope/device/device.h"               // for VirtualProps::Storage, Base<>::Storage
+#include "kaleidoscope/driver/keyscanner/ScanRate.h"  // for ScanRateSettings
+#include "kaleidoscope/event_handler_result.h"        // for EventHandlerResult, EventHandlerResult::OK
+
+namespace kaleidoscope {
+namespace plugin {
+
+uint16_t AdaptiveScanRate::settings_base_;
+
+EventHandlerResult AdaptiveScanRate::onNameQuery() {
+  return ::Focus.sendName(F("AdaptiveScanRate"));
+}
+
+EventHandlerResult AdaptiveScanRate::onSetup() {
+  driver::keyscanner::ScanRateSettings settings;
+
+  // If nothing (valid) has been stored yet, the keyscanner keeps its own
+  // defaults.
+  if (::EEPROMSettings.requestSliceAndLoadData(&settings_base_, &settings) &&
+      isValid(settings))
+    Runtime.device().setScanRate(settings);
+
+  return EventHandlerResult::OK;
+}
+
+driver::keyscanner::ScanRateSettings AdaptiveScanRate::settings() {
+  return Runtime.device().scanRate();
+}
+
+bool AdaptiveScanRate::isValid(const driver::keyscanner::ScanRateSettings &settings) {
+  // A zero interval would stop the scan timer altogether, and an idle interval
+  // shorter than the active one would make idling pointless.
+  return settings.interval != 0 &&
+         (settings.idle_interval == 0 || settings.idle_interval >= settings.interval);
+}
+
+bool AdaptiveScanRate::setSettings(const driver::keyscanner::ScanRateSettings &settings) {
+  if (!isValid(settings))
+    return false;
+
+  Runtime.device().setScanRate(settings);
+
+  // Keyscanners that can't change their scan rate ignore the new settings, and
+  // there is no point in storing those.
+  driver::keyscanner::ScanRateSettings applied = Runtime.device().scanRate();
+  if (applied.interval != settings.interval ||
+      applied.idle_interval != settings.idle_interval ||
+      applied.idle_timeout != settings.idle_timeout)
+    return false;
+
+  Runtime.storage().put(settings_base_, settings);
+  Runtime.storage().commit();
+  return true;
+}
+
+EventHandlerResult AdaptiveScanRate::onFocusEvent(const char *input) {
+  const char *cmd_interval      = PSTR("scanrate.interval");
+  const char *cmd_idle_interval = PSTR("scanrate.idle_interval");
+  const char *cmd_idle_timeout  = PSTR("scanrate.idle_timeout");
+
+  if (::Focus.inputMatchesHelp(input))
+    return ::Focus.printHelp(cmd_interval, cmd_idle_interval, cmd_idle_timeout);
+
+  driver::keyscanner::ScanRateSettings new_settings = settings();
+  uint16_t *field;
+
+  if (::Focus.inputMatchesCommand(input, cmd_interval)) {
+    field = &new_settings.interval;
+  } else if (::Focus.inputMatchesCommand(input, cmd_idle_interval)) {
+    field = &new_settings.idle_interval;
+  } else if (::Focus.inputMatchesCommand(input, cmd_idle_timeout)) {
+    field = &new_settings.idle_timeout;
+  } else {
+    return EventHandlerResult::OK;
+  }
+
+  if (::Focus.isEOL()) {
+    ::Focus.send(*field);
+  } else {
+    ::Focus.read(*field);
+    setSettings(new_settings);
+  }
+
+  return EventHandlerResult::EVENT_CONSUMED;
+}
+
+}  // namespace plugin
+}  // namespace kaleidoscope
+
+kaleidoscope::plugin::AdaptiveScanRate AdaptiveScanRate;
@@ -0,0 +1,53 @@
+/* -*- mode: c++ -*-
+ * Kaleidoscope-AdaptiveScanRate -- Configure the idle and active keyscan rates
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint16_t
+
+#include "kaleidoscope/driver/keyscanner/ScanRate.h"  // for ScanRateSettings
+#include "kaleidoscope/event_handler_result.h"        // for EventHandlerResult
+#include "kaleidoscope/plugin.h"                      // for Plugin
+
+namespace kaleidoscope {
+namespace plugin {
+
+/// Run-time configuration of the keyscanner's scan rates
+///
+/// Makes the active and idle scan intervals, and the idle timeout of the
+/// keyscanner configurable via Focus, and stores them in EEPROM, so they
+/// survive a reboot. Keyscanners that can't change their scan rate report all
+/// of the settings as zero.
+class AdaptiveScanRate : public kaleidoscope::Plugin {
+ public:
+  EventHandlerResult onSetup();
+  EventHandlerResult onNameQuery();
+  EventHandlerResult onFocusEvent(const char *input);
+
+  static driver::keyscanner::ScanRateSettings settings();
+  static bool setSettings(const driver::keyscanner::ScanRateSettings &settings);
+
+ private:
+  static uint16_t settings_base_;
+
+  static bool isValid(const driver::keyscanner::ScanRateSettings &settings);
+};
+
+}  // namespace plugin
+}  // namespace kaleidoscope
+
+extern kaleidoscope::plugin::AdaptiveScanRate AdaptiveScanRate;
@@ -21,7 +21,6 @@
 #include <Kaleidoscope-FocusSerial.h>  // for Focus, FocusSerial
 #include <Kaleidoscope-Ranges.h>       // for CS_FIRST, CS_LAST
 
-#include "kaleidoscope/KeyAddrMap.h"                      // for KeyAddrMap<>::Iterator, KeyAddrMap
 #include "kaleidoscope/KeyEvent.h"                        // for KeyEvent
 #include "kaleidoscope/KeyMap.h"                          // for KeyMap
 #include "kaleidoscope/LiveKeys.h"                        // for LiveKeys, live_keys
@@ -68,8 +67,8 @@ EventHandlerResult CharShift::onKeyEvent(KeyEvent &event) {
 
   // Determine if a shift key is being held.
   bool shift_held = false;
-  for (Key key : live_keys.all()) {
-    if (key.isKeyboardShift()) {
+  for (KeyAddr key_addr : live_keys.active()) {
+    if (live_keys.read(key_addr).isKeyboardShift()) {
       shift_held = true;
       break;
     }
@@ -30,6 +30,7 @@
 #include "kaleidoscope/progmem_helpers.h"       // for cloneFromProgmem
 #include "kaleidoscope/keyswitch_state.h"       // for keyToggledOn
 #include "kaleidoscope/Runtime.h"               // for Runtime
+#include "kaleidoscope/Timer.h"                 // for Timer
 
 namespace kaleidoscope {
 namespace plugin {
@@ -46,7 +47,7 @@ EventHandlerResult Chord::onKeyswitchEvent(KeyEvent &event) {
   appendEvent(event);
 
   if (isChordStrictSubset()) {
-    start_time_ = Runtime.millisAtCycleStart();
+    Runtime.startTimer(timer_, timeout_);
     return EventHandlerResult::ABORT;
   }
 
@@ -63,11 +64,10 @@ EventHandlerResult Chord::onKeyswitchEvent(KeyEvent &event) {
   return EventHandlerResult::OK;
 }
 
-EventHandlerResult Chord::afterEachCycle() {
-  if (Runtime.hasTimeExpired(start_time_, timeout_) && potential_chord_size_ > 0) {
-    resolveOrArpeggiate();
+void Chord::onTimeout() {
+  if (::Chord.potential_chord_size_ > 0) {
+    ::Chord.resolveOrArpeggiate();
   }
-  return EventHandlerResult::OK;
 }
 
 void Chord::setTimeout(uint8_t timeout) {
@@ -24,6 +24,7 @@
 #include "kaleidoscope/KeyAddr.h"               // for KeyAddr
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/KeyEventTracker.h"       // for KeyEventTracker
+#include "kaleidoscope/Timer.h"                 // for Timer
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
 #include "kaleidoscope/plugin.h"                // for Plugin
 #include "kaleidoscope/key_defs.h"              // for Key, Key_Transparent
@@ -35,7 +36,6 @@ namespace plugin {
 class Chord : public kaleidoscope::Plugin {
  public:
   EventHandlerResult onKeyswitchEvent(KeyEvent &event);
-  EventHandlerResult afterEachCycle();
   void setTimeout(uint8_t timeout);
 
   template<uint8_t _chord_defs_size>
@@ -56,8 +56,10 @@ class Chord : public kaleidoscope::Plugin {
   void appendEvent(KeyEvent event);
   void arpeggiate();
 
+  static void onTimeout();
+
   KeyEventTracker event_tracker_;
-  uint16_t start_time_;
+  Timer timer_{onTimeout};
 
   static constexpr uint8_t kMaxChordSize{10};
   KeyEvent potential_chord_[kMaxChordSize];
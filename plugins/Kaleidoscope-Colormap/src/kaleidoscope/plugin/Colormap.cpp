@@ -17,7 +17,7 @@
 
 #include "kaleidoscope/plugin/Colormap.h"
 
-#include <Arduino.h>                         // for F, PSTR, __FlashStringHelper
+#include <Arduino.h>                         // for F, PROGMEM, __FlashStringHelper
 #include <Kaleidoscope-FocusSerial.h>        // for Focus, FocusSerial
 #include <Kaleidoscope-LED-Palette-Theme.h>  // for LEDPaletteTheme
 #include <stdint.h>                          // for uint8_t, uint16_t
@@ -78,8 +78,39 @@ EventHandlerResult ColormapEffect::onLayerChange() {
   return EventHandlerResult::OK;
 }
 
-EventHandlerResult ColormapEffect::onFocusEvent(const char *input) {
-  return ::LEDPaletteTheme.themeFocusEvent(input, PSTR("colormap.map"), map_base_, max_layers_);
+static constexpr char cmd_map[] PROGMEM        = "colormap.map";
+static constexpr char cmd_map_binary[] PROGMEM = "colormap.map.binary";
+static constexpr char cmd_map_set[] PROGMEM    = "colormap.map.set";
+static constexpr char cmd_map_range[] PROGMEM  = "colormap.map.range";
+
+const focusserial::Command ColormapEffect::focus_commands_[] PROGMEM = {
+  FOCUS_COMMAND(cmd_map, focusMap),
+  FOCUS_COMMAND(cmd_map_binary, focusMapBinary),
+  FOCUS_COMMAND(cmd_map_set, focusMapSet),
+  FOCUS_COMMAND(cmd_map_range, focusMapRange),
+};
+focusserial::CommandTable ColormapEffect::focus_command_table_(ColormapEffect::focus_commands_);
+
+EventHandlerResult ColormapEffect::onSetup() {
+  if (Runtime.has_leds)
+    ::Focus.registerCommands(focus_command_table_);
+  return EventHandlerResult::OK;
+}
+
+void ColormapEffect::focusMap() {
+  ::LEDPaletteTheme.focusTheme(map_base_, max_layers_);
+}
+
+void ColormapEffect::focusMapBinary() {
+  ::LEDPaletteTheme.focusThemeBinary(map_base_, max_layers_);
+}
+
+void ColormapEffect::focusMapSet() {
+  ::LEDPaletteTheme.focusThemeSet(map_base_, max_layers_);
+}
+
+void ColormapEffect::focusMapRange() {
+  ::LEDPaletteTheme.focusThemeRange(map_base_, max_layers_);
 }
 
 }  // namespace plugin
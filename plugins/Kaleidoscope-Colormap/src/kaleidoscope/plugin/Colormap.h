@@ -25,6 +25,7 @@
 #include "kaleidoscope/plugin/AccessTransientLEDMode.h"  // for AccessTransientLEDMode
 #include "kaleidoscope/plugin/LEDMode.h"                 // for LEDMode
 #include "kaleidoscope/plugin/LEDModeInterface.h"        // for LEDModeInterface
+#include "kaleidoscope/plugin/focusserial/Commands.h"    // for Command, CommandTable
 
 namespace kaleidoscope {
 namespace plugin {
@@ -37,9 +38,9 @@ class ColormapEffect : public Plugin,
 
   void max_layers(uint8_t max_);
 
+  EventHandlerResult onSetup();
   EventHandlerResult onLayerChange();
   EventHandlerResult onNameQuery();
-  EventHandlerResult onFocusEvent(const char *input);
 
   static bool isUninitialized();
   static void updateColorIndexAtPosition(uint8_t layer, uint16_t position, uint8_t palette_index);
@@ -69,6 +70,13 @@ class ColormapEffect : public Plugin,
   static uint8_t top_layer_;
   static uint8_t max_layers_;
   static uint16_t map_base_;
+
+  static const focusserial::Command focus_commands_[];
+  static focusserial::CommandTable focus_command_table_;
+  static void focusMap();
+  static void focusMapBinary();
+  static void focusMapSet();
+  static void focusMapRange();
 };
 
 }  // namespace plugin
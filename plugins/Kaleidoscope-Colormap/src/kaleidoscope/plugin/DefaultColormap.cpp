@@ -18,7 +18,7 @@
 #include "kaleidoscope/plugin/Colormap.h"  // for Colormap
 #include "kaleidoscope/plugin/DefaultColormap.h"
 
-#include <Arduino.h>                   // for PSTR
+#include <Arduino.h>                   // for PROGMEM
 #include <Kaleidoscope-FocusSerial.h>  // for Focus
 #include <Kaleidoscope-LEDControl.h>   // for LEDControl
 #include <stdint.h>                    // for uint8_t
@@ -59,20 +59,17 @@ void DefaultColormap::install() {
   ::LEDControl.refreshAll();
 }
 
-EventHandlerResult DefaultColormap::onFocusEvent(const char *input) {
-  if (!Runtime.has_leds)
-    return EventHandlerResult::OK;
+static constexpr char cmd_install[] PROGMEM = "colormap.install";
 
-  const char *cmd = PSTR("colormap.install");
+const focusserial::Command DefaultColormap::focus_commands_[] PROGMEM = {
+  FOCUS_COMMAND(cmd_install, install),
+};
+focusserial::CommandTable DefaultColormap::focus_command_table_(DefaultColormap::focus_commands_);
 
-  if (::Focus.inputMatchesHelp(input))
-    return ::Focus.printHelp(cmd);
-
-  if (!::Focus.inputMatchesCommand(input, cmd))
-    return EventHandlerResult::OK;
-
-  install();
-  return EventHandlerResult::EVENT_CONSUMED;
+EventHandlerResult DefaultColormap::onSetup() {
+  if (Runtime.has_leds)
+    ::Focus.registerCommands(focus_command_table_);
+  return EventHandlerResult::OK;
 }
 
 }  // namespace plugin
@@ -20,9 +20,10 @@
 #include <Arduino.h>  // for PROGMEM
 #include <stdint.h>   // for uint8_t
 
-#include "kaleidoscope_internal/device.h"       // for device
-#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
-#include "kaleidoscope/plugin.h"                // for Plugin
+#include "kaleidoscope_internal/device.h"              // for device
+#include "kaleidoscope/event_handler_result.h"         // for EventHandlerResult
+#include "kaleidoscope/plugin.h"                       // for Plugin
+#include "kaleidoscope/plugin/focusserial/Commands.h"  // for Command, CommandTable
 
 namespace kaleidoscope {
 namespace plugin {
@@ -70,7 +71,11 @@ class DefaultColormap : public Plugin {
   static void setup();
   static void install();
 
-  EventHandlerResult onFocusEvent(const char *input);
+  EventHandlerResult onSetup();
+
+ private:
+  static const focusserial::Command focus_commands_[];
+  static focusserial::CommandTable focus_command_table_;
 };
 
 }  // namespace plugin
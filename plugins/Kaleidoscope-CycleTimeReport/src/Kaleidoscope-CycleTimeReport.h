@@ -18,3 +18,4 @@
 #pragma once
 
 #include "kaleidoscope/plugin/CycleTimeReport.h"  // IWYU pragma: export
+#include "kaleidoscope/plugin/LatencyReport.h"    // IWYU pragma: export
@@ -0,0 +1,205 @@
+/* -*- mode: c++ -*-
+ * Kaleidoscope-CycleTimeReport -- Scan cycle time reporting
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope/plugin/LatencyReport.h"
+
+#include <Arduino.h>                   // for micros, PSTR
+#include <HID-Settings.h>              // for HID_REPORTID_CONSUMERCONTROL, HID_REPORTID_KEYBOARD
+#include <HIDReportObserver.h>         // for HIDReportObserver
+#include <Kaleidoscope-FocusSerial.h>  // for Focus, FocusSerial
+#include <stdint.h>                    // for uint8_t, uint16_t, uint32_t
+
+#include "kaleidoscope/KeyEvent.h"                       // for KeyEvent
+#include "kaleidoscope/Runtime.h"                        // for Runtime, Runtime_
+#include "kaleidoscope/event_handler_result.h"           // for EventHandlerResult, EventHandlerResult::OK
+#include "kaleidoscope/key_defs.h"                       // for Key, SYNTHETIC, Key_NoKey
+#include "kaleidoscope/keyswitch_state.h"                // for keyToggledOn
+#include "kaleidoscope/plugin/mousekeys/MouseKeyDefs.h"  // for IS_MOUSE_KEY
+
+namespace kaleidoscope {
+namespace plugin {
+
+// =============================================================================
+// LatencyHistogram
+
+uint8_t LatencyHistogram::bucketIndex(uint32_t latency) {
+  uint8_t index = 0;
+  while (latency != 0 && index < bucket_count - 1) {
+    latency >>= 1;
+    ++index;
+  }
+  return index;
+}
+
+void LatencyHistogram::record(uint32_t latency) {
+  uint16_t &bucket = buckets_[bucketIndex(latency)];
+  if (bucket < UINT16_MAX)
+    ++bucket;
+  ++count_;
+  if (latency < min_)
+    min_ = latency;
+  if (latency > max_)
+    max_ = latency;
+}
+
+void LatencyHistogram::reset() {
+  for (uint16_t &bucket : buckets_)
+    bucket = 0;
+  count_ = 0;
+  min_   = UINT32_MAX;
+  max_   = 0;
+}
+
+uint32_t LatencyHistogram::percentile(uint8_t percent) const {
+  // The number of samples that need to be at or below the result, rounded up.
+  uint32_t threshold = count_ / 100 * percent + ((count_ % 100) * percent + 99) / 100;
+  uint32_t seen      = 0;
+  for (uint8_t i = 0; i < bucket_count - 1; ++i) {
+    seen += buckets_[i];
+    if (seen >= threshold) {
+      uint32_t upper_limit = (uint32_t(1) << i) - 1;
+      return upper_limit < max_ ? upper_limit : max_;
+    }
+  }
+  return max_;
+}
+
+// =============================================================================
+// LatencyReport
+
+namespace {
+// The hook that was installed before ours, so we can pass reports on to it.
+HIDReportObserver::SendReportHook next_report_hook = nullptr;
+}  // namespace
+
+EventHandlerResult LatencyReport::onKeyswitchEvent(KeyEvent &event) {
+  // Install the report observer lazily, rather than from `onSetup()`, so that
+  // we get it back if something else replaces it later on (the testing
+  // framework does that at the start of every test case).
+  if (HIDReportObserver::currentHook() != &observeReport)
+    next_report_hook = HIDReportObserver::resetHook(&observeReport);
+
+  // Only keys that are known to result in a report of a particular type are
+  // tracked; anything else (layer keys, plugin keys, etc.) would otherwise get
+  // matched with an unrelated report later on.
+  ReportType type;
+  if (event.key.isKeyboardKey() && event.key != Key_NoKey) {
+    type = KEYBOARD;
+  } else if (event.key.isConsumerControlKey()) {
+    type = CONSUMER_CONTROL;
+  } else if (event.key.getFlags() == (SYNTHETIC | IS_MOUSE_KEY) &&
+             keyToggledOn(event.state)) {
+    // Releasing a mouse movement key doesn't necessarily change the mouse
+    // report, so only presses are tracked.
+    type = MOUSE;
+  } else {
+    return EventHandlerResult::OK;
+  }
+
+  uint8_t type_bit = 1 << type;
+  if (!(pending_types_ & type_bit)) {
+    pending_types_ |= type_bit;
+    pending_since_[type] = timestamp();
+  }
+
+  return EventHandlerResult::OK;
+}
+
+void LatencyReport::onReportSent(ReportType type) {
+  uint8_t type_bit = 1 << type;
+  if (pending_types_ & type_bit) {
+    pending_types_ &= ~type_bit;
+    histograms_[type].record(timestamp() - pending_since_[type]);
+  }
+}
+
+void LatencyReport::observeReport(uint8_t id, const void *data, int len, int result) {
+  switch (id) {
+  case HID_REPORTID_KEYBOARD:
+  case HID_REPORTID_NKRO_KEYBOARD:
+    ::LatencyReport.onReportSent(KEYBOARD);
+    break;
+  case HID_REPORTID_CONSUMERCONTROL:
+    ::LatencyReport.onReportSent(CONSUMER_CONTROL);
+    break;
+  case HID_REPORTID_MOUSE:
+    ::LatencyReport.onReportSent(MOUSE);
+    break;
+  }
+  if (next_report_hook)
+    (*next_report_hook)(id, data, len, result);
+}
+
+uint32_t LatencyReport::timestamp() {
+#ifdef KALEIDOSCOPE_VIRTUAL_BUILD
+  // The simulator only advances time between cycles, so latencies are measured
+  // in whole cycles there, which makes them deterministic enough for tests to
+  // check them.
+  return Runtime.millisAtCycleStart() * 1000;
+#else
+  return micros();
+#endif
+}
+
+void LatencyReport::reset() {
+  for (LatencyHistogram &histogram : histograms_)
+    histogram.reset();
+  pending_types_ = 0;
+}
+
+// Each histogram is sent as a single line: the number of samples, the minimum,
+// maximum, and 99th percentile latency (in microseconds), followed by the
+// counts of all the buckets.
+void LatencyReport::sendHistogram(ReportType type) {
+  const LatencyHistogram &histogram = histograms_[type];
+  ::Focus.send(histogram.count(),
+               histogram.min(),
+               histogram.max(),
+               histogram.percentile(99));
+  for (uint8_t i = 0; i < LatencyHistogram::bucket_count; ++i)
+    ::Focus.send(histogram.bucket(i));
+  ::Focus.send(::Focus.NEWLINE);
+}
+
+EventHandlerResult LatencyReport::onFocusEvent(const char *input) {
+  const char *cmd_keyboard = PSTR("latency.keyboard");
+  const char *cmd_consumer = PSTR("latency.consumer");
+  const char *cmd_mouse    = PSTR("latency.mouse");
+  const char *cmd_reset    = PSTR("latency.reset");
+
+  if (::Focus.inputMatchesHelp(input))
+    return ::Focus.printHelp(cmd_keyboard, cmd_consumer, cmd_mouse, cmd_reset);
+
+  if (::Focus.inputMatchesCommand(input, cmd_keyboard)) {
+    sendHistogram(KEYBOARD);
+  } else if (::Focus.inputMatchesCommand(input, cmd_consumer)) {
+    sendHistogram(CONSUMER_CONTROL);
+  } else if (::Focus.inputMatchesCommand(input, cmd_mouse)) {
+    sendHistogram(MOUSE);
+  } else if (::Focus.inputMatchesCommand(input, cmd_reset)) {
+    reset();
+  } else {
+    return EventHandlerResult::OK;
+  }
+
+  return EventHandlerResult::EVENT_CONSUMED;
+}
+
+}  // namespace plugin
+}  // namespace kaleidoscope
+
+kaleidoscope::plugin::LatencyReport LatencyReport;
@@ -0,0 +1,111 @@
+/* -*- mode: c++ -*-
+ * Kaleidoscope-CycleTimeReport -- Scan cycle time reporting
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t, uint16_t, uint32_t
+
+#include "kaleidoscope/KeyEvent.h"              // for KeyEvent
+#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
+#include "kaleidoscope/plugin.h"                // for Plugin
+
+namespace kaleidoscope {
+namespace plugin {
+
+/// A histogram of latencies (in microseconds), with logarithmic buckets
+///
+/// Bucket 0 counts latencies of zero, bucket `n` counts latencies in the range
+/// [2^(n-1), 2^n), and the last bucket also counts everything longer than
+/// that. The bucket counts saturate instead of overflowing.
+class LatencyHistogram {
+ public:
+  static constexpr uint8_t bucket_count = 20;
+
+  void record(uint32_t latency);
+  void reset();
+
+  uint32_t count() const {
+    return count_;
+  }
+  uint32_t min() const {
+    return count_ == 0 ? 0 : min_;
+  }
+  uint32_t max() const {
+    return max_;
+  }
+  uint16_t bucket(uint8_t index) const {
+    return buckets_[index];
+  }
+
+  /// Returns an upper bound for the given percentile of the recorded latencies
+  ///
+  /// This is the upper limit of the bucket the percentile falls into, or the
+  /// maximum recorded latency, whichever is lower.
+  uint32_t percentile(uint8_t percent) const;
+
+  static uint8_t bucketIndex(uint32_t latency);
+
+ private:
+  uint16_t buckets_[bucket_count] = {};
+  uint32_t count_                 = 0;
+  uint32_t min_                   = UINT32_MAX;
+  uint32_t max_                   = 0;
+};
+
+/// Scan-to-report latency measurement
+///
+/// Records the time between a keyswitch toggling on or off, and the HID report
+/// that results from it being sent, separately for keyboard, consumer control,
+/// and mouse reports.
+class LatencyReport : public kaleidoscope::Plugin {
+ public:
+  enum ReportType : uint8_t {
+    KEYBOARD,
+    CONSUMER_CONTROL,
+    MOUSE,
+    REPORT_TYPE_COUNT,
+  };
+
+  EventHandlerResult onKeyswitchEvent(KeyEvent &event);
+  EventHandlerResult onFocusEvent(const char *input);
+
+  const LatencyHistogram &histogram(ReportType type) const {
+    return histograms_[type];
+  }
+
+  /// Clear all the latencies recorded so far
+  void reset();
+
+ private:
+  LatencyHistogram histograms_[REPORT_TYPE_COUNT];
+
+  // Detection timestamps of the earliest toggle of each type that hasn't yet
+  // resulted in a report.
+  uint32_t pending_since_[REPORT_TYPE_COUNT] = {};
+  uint8_t pending_types_                     = 0;
+
+  void onReportSent(ReportType type);
+  void sendHistogram(ReportType type);
+
+  static uint32_t timestamp();
+  static void observeReport(uint8_t id, const void *data, int len, int result);
+};
+
+}  // namespace plugin
+}  // namespace kaleidoscope
+
+extern kaleidoscope::plugin::LatencyReport LatencyReport;
@@ -17,7 +17,7 @@
 
 #include "kaleidoscope/plugin/EEPROM-Keymap.h"
 
-#include <Arduino.h>                       // for PSTR, F, __FlashStringHelper
+#include <Arduino.h>                       // for PROGMEM, F, __FlashStringHelper
 #include <Kaleidoscope-EEPROM-Settings.h>  // for EEPROMSettings
 #include <Kaleidoscope-FocusSerial.h>      // for Focus, FocusSerial
 #include <stdint.h>                        // for uint8_t, uint16_t
@@ -26,7 +26,7 @@
 #include "kaleidoscope/Runtime.h"               // for Runtime, Runtime_
 #include "kaleidoscope/device/device.h"         // for VirtualProps::Storage, Device, Base<>::St...
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
-#include "kaleidoscope/key_defs.h"              // for Key, Key_NoKey
+#include "kaleidoscope/key_defs.h"              // for Key, Key_NoKey, Key_Transparent
 #include "kaleidoscope/layers.h"                // for Layer_, Layer, layer_count
 
 namespace kaleidoscope {
@@ -34,9 +34,23 @@ namespace plugin {
 uint16_t EEPROMKeymap::keymap_base_;
 uint8_t EEPROMKeymap::max_layers_;
 uint8_t EEPROMKeymap::progmem_layers_;
+uint8_t EEPROMKeymap::opaque_keys_[MAX_EEPROM_KEYMAP_BITMAP_LAYERS][opaque_key_blocks_];
+uint16_t EEPROMKeymap::patch_position_;
+uint16_t EEPROMKeymap::patch_count_;
+bool EEPROMKeymap::uploading_;
+uint16_t EEPROMKeymap::upload_packed_;
+uint16_t EEPROMKeymap::upload_tail_;
+uint16_t EEPROMKeymap::upload_tail_end_;
+bool EEPROMKeymap::compressed_;
+uint16_t EEPROMKeymap::max_keys_;
+#if EEPROM_KEYMAP_KEY_CACHE
+uint8_t EEPROMKeymap::cached_layers_[kaleidoscope_internal::device.numKeys()];
+Key EEPROMKeymap::cached_keys_[kaleidoscope_internal::device.numKeys()];
+#endif
 
 EventHandlerResult EEPROMKeymap::onSetup() {
   ::EEPROMSettings.onSetup();
+  ::Focus.registerCommands(focus_command_table_);
   progmem_layers_ = layer_count;
   return EventHandlerResult::OK;
 }
@@ -45,32 +59,97 @@ EventHandlerResult EEPROMKeymap::onNameQuery() {
   return ::Focus.sendName(F("EEPROMKeymap"));
 }
 
+EventHandlerResult EEPROMKeymap::onStorageChange() {
+  reloadKeymap();
+  return EventHandlerResult::OK;
+}
+
 void EEPROMKeymap::setup(uint8_t max) {
-  layer_count = max;
-  if (::EEPROMSettings.ignoreHardcodedLayers()) {
-    Layer.getKey = getKey;
-  } else {
-    layer_count += progmem_layers_;
-    Layer.getKey = getKeyExtended;
-  }
   max_layers(max);
+  useKeymapSource(::EEPROMSettings.ignoreHardcodedLayers());
+}
+
+void EEPROMKeymap::setupCompressed(uint8_t max, uint16_t max_keys) {
+  compressed_ = true;
+  max_keys_   = max_keys;
+  setup(max);
 }
 
 void EEPROMKeymap::max_layers(uint8_t max) {
-  max_layers_  = max;
-  keymap_base_ = ::EEPROMSettings.requestSlice(max_layers_ * Runtime.device().numKeys() * 2);
+  max_layers_ = max;
+  if (compressed_) {
+    keymap_base_ = ::EEPROMSettings.requestSlice(packedSize(max_layers_) + max_keys_ * 2);
+    // Anything that doesn't add up, like a keymap stored in the uncompressed
+    // layout, or freshly cleared storage on devices where that reads as zeros,
+    // is replaced by an empty keymap.
+    if (!isCompressedKeymapValid())
+      clearCompressedKeymap();
+  } else {
+    keymap_base_ = ::EEPROMSettings.requestSlice(max_layers_ * Runtime.device().numKeys() * 2);
+  }
+  clearKeyCache();
+  updateOpaqueKeys();
+}
+
+void EEPROMKeymap::useKeymapSource(bool only_custom) {
+  layer_count = max_layers_;
+  if (only_custom) {
+    Layer.setKeymapSource(getKey, getOpaqueKeys);
+  } else {
+    layer_count += progmem_layers_;
+    Layer.setKeymapSource(getKeyExtended, getOpaqueKeysExtended);
+  }
 }
 
 Key EEPROMKeymap::getKey(uint8_t layer, KeyAddr key_addr) {
   if (layer >= max_layers_)
     return Key_NoKey;
 
-  uint16_t pos = ((layer * Runtime.device().numKeys()) + key_addr.toInt()) * 2;
+#if EEPROM_KEYMAP_KEY_CACHE
+  // Lookups mostly hit the active layer of each key, so caching the last one
+  // per key address catches nearly all of them.
+  uint8_t index = key_addr.toInt();
+  if (cached_layers_[index] != layer) {
+    cached_keys_[index]   = readKey(layer, index);
+    cached_layers_[index] = layer;
+  }
+  return cached_keys_[index];
+#else
+  return readKey(layer, key_addr.toInt());
+#endif
+}
+
+Key EEPROMKeymap::readKey(uint8_t layer, uint8_t index) {
+  if (compressed_) {
+    // Until an upload is over, the bitmaps and counts don't match the keys
+    // stored so far, so the custom layers are left out of lookups.
+    if (uploading_)
+      return Key_Transparent;
+    if (!(opaqueKeys(layer, index / 8) & (1 << (index % 8))))
+      return Key_Transparent;
+    return readPackedKey(packedPosition(layer, index));
+  }
+
+  uint16_t pos = ((layer * Runtime.device().numKeys()) + index) * 2;
 
   return Key(Runtime.storage().read(keymap_base_ + pos + 1),  // key_code
              Runtime.storage().read(keymap_base_ + pos));     // flags
 }
 
+// Drops whatever is kept of the keymap in RAM, after it changed in storage.
+void EEPROMKeymap::reloadKeymap() {
+  clearKeyCache();
+  updateOpaqueKeys();
+  Layer.updateActiveLayers();
+}
+
+void EEPROMKeymap::clearKeyCache() {
+#if EEPROM_KEYMAP_KEY_CACHE
+  for (uint8_t &layer : cached_layers_)
+    layer = no_cached_layer_;
+#endif
+}
+
 Key EEPROMKeymap::getKeyExtended(uint8_t layer, KeyAddr key_addr) {
 
   // If the layer is within PROGMEM bounds, look it up from there
@@ -82,13 +161,272 @@ Key EEPROMKeymap::getKeyExtended(uint8_t layer, KeyAddr key_addr) {
   return getKey(layer - progmem_layers_, key_addr);
 }
 
+uint8_t EEPROMKeymap::getOpaqueKeys(uint8_t layer, uint8_t block) {
+  if (layer >= MAX_EEPROM_KEYMAP_BITMAP_LAYERS || layer >= max_layers_)
+    return Layer.getOpaqueKeysFromGetKey(getKey, layer, block);
+
+  return opaque_keys_[layer][block];
+}
+
+uint8_t EEPROMKeymap::getOpaqueKeysExtended(uint8_t layer, uint8_t block) {
+  if (layer < progmem_layers_) {
+    return Layer.getOpaqueKeysFromPROGMEM(layer, block);
+  }
+
+  return getOpaqueKeys(layer - progmem_layers_, block);
+}
+
+void EEPROMKeymap::updateOpaqueKeys() {
+  for (uint8_t layer = 0; layer < max_layers_ && layer < MAX_EEPROM_KEYMAP_BITMAP_LAYERS; layer++) {
+    for (uint8_t block = 0; block < opaque_key_blocks_; block++) {
+      if (compressed_) {
+        opaque_keys_[layer][block] = uploading_ ? 0 : readOpaqueKeys(layer, block);
+      } else {
+        opaque_keys_[layer][block] = Layer.getOpaqueKeysFromGetKey(getKey, layer, block);
+      }
+    }
+  }
+}
+
+void EEPROMKeymap::updateOpaqueKey(uint16_t base_pos, Key key) {
+  uint8_t layer = base_pos / Runtime.device().numKeys();
+  uint8_t index = base_pos % Runtime.device().numKeys();
+
+  if (layer >= MAX_EEPROM_KEYMAP_BITMAP_LAYERS)
+    return;
+
+  uint8_t &keys = opaque_keys_[layer][index / 8];
+  if (key == Key_Transparent) {
+    keys &= ~(1 << (index % 8));
+  } else {
+    keys |= (1 << (index % 8));
+  }
+}
+
 uint16_t EEPROMKeymap::keymap_base() {
   return keymap_base_;
 }
 
 void EEPROMKeymap::updateKey(uint16_t base_pos, Key key) {
-  Runtime.storage().update(keymap_base_ + base_pos * 2, key.getFlags());
-  Runtime.storage().update(keymap_base_ + base_pos * 2 + 1, key.getKeyCode());
+  if (compressed_) {
+    if (!updateCompressedKey(base_pos / Runtime.device().numKeys(),
+                             base_pos % Runtime.device().numKeys(),
+                             key))
+      return;
+  } else {
+    Runtime.storage().update(keymap_base_ + base_pos * 2, key.getFlags());
+    Runtime.storage().update(keymap_base_ + base_pos * 2 + 1, key.getKeyCode());
+  }
+  updateOpaqueKey(base_pos, key);
+
+#if EEPROM_KEYMAP_KEY_CACHE
+  uint8_t layer = base_pos / Runtime.device().numKeys();
+  uint8_t index = base_pos % Runtime.device().numKeys();
+  if (cached_layers_[index] == layer)
+    cached_keys_[index] = key;
+#endif
+}
+
+// The bitmaps and counts come first, followed by the packed keys.
+uint16_t EEPROMKeymap::packedSize(uint8_t layers) {
+  return layers * (opaque_key_blocks_ + 2);
+}
+
+// Stored inverted, so that the bits of freshly erased storage mark every key
+// as transparent.
+uint8_t EEPROMKeymap::readOpaqueKeys(uint8_t layer, uint8_t block) {
+  return ~Runtime.storage().read(keymap_base_ + layer * opaque_key_blocks_ + block);
+}
+
+uint8_t EEPROMKeymap::opaqueKeys(uint8_t layer, uint8_t block) {
+  if (layer < MAX_EEPROM_KEYMAP_BITMAP_LAYERS)
+    return opaque_keys_[layer][block];
+  return readOpaqueKeys(layer, block);
+}
+
+// Also stored inverted, so that erased storage adds up to an empty keymap. The
+// count before the first layer is always zero, and isn't stored; the one
+// before `max_layers_` is the number of keys stored in total.
+uint16_t EEPROMKeymap::packedKeysBefore(uint8_t layer) {
+  if (layer == 0)
+    return 0;
+  uint16_t pos = keymap_base_ + max_layers_ * opaque_key_blocks_ + (layer - 1) * 2;
+  return ~(Runtime.storage().read(pos) | (Runtime.storage().read(pos + 1) << 8));
+}
+
+void EEPROMKeymap::updatePackedKeysBefore(uint8_t layer, uint16_t count) {
+  uint16_t pos    = keymap_base_ + max_layers_ * opaque_key_blocks_ + (layer - 1) * 2;
+  uint16_t stored = ~count;
+  Runtime.storage().update(pos, stored & 0xff);
+  Runtime.storage().update(pos + 1, stored >> 8);
+}
+
+// The position of a key among the packed ones is the number of keys stored
+// before its layer, plus the number of non-transparent keys before it on its
+// own layer.
+uint16_t EEPROMKeymap::packedPosition(uint8_t layer, uint8_t index) {
+  uint16_t pos = packedKeysBefore(layer);
+  for (uint8_t block = 0; block < index / 8; block++)
+    pos += __builtin_popcount(opaqueKeys(layer, block));
+  return pos + __builtin_popcount(opaqueKeys(layer, index / 8) & ((1 << (index % 8)) - 1));
+}
+
+Key EEPROMKeymap::readPackedKey(uint16_t pos) {
+  if (pos >= max_keys_)
+    return Key_NoKey;
+  uint16_t address = keymap_base_ + packedSize(max_layers_) + pos * 2;
+  return Key(Runtime.storage().read(address + 1),  // key_code
+             Runtime.storage().read(address));     // flags
+}
+
+void EEPROMKeymap::updatePackedKey(uint16_t pos, Key key) {
+  uint16_t address = keymap_base_ + packedSize(max_layers_) + pos * 2;
+  Runtime.storage().update(address, key.getFlags());
+  Runtime.storage().update(address + 1, key.getKeyCode());
+}
+
+// Turning a transparent key into something else inserts it among the packed
+// keys, and turning one transparent removes it, moving the keys after it. If
+// there is no room left, non-transparent keys are ignored, and false is
+// returned.
+//
+// Moving the keys rewrites up to two bytes for each key stored after this one,
+// and two for each later layer's count. On AVR, where an EEPROM byte takes
+// about 3.3ms to write, that is over a second with a couple hundred keys
+// stored, during which nothing else runs, and those cells wear each time.
+// Uploads with `keymap.custom` don't pay this for every key: they pack all of
+// them in one pass (see `receiveCompressedKey()`).
+bool EEPROMKeymap::updateCompressedKey(uint8_t layer, uint8_t index, Key key) {
+  if (layer >= max_layers_)
+    return false;
+
+  uint8_t mask    = 1 << (index % 8);
+  uint8_t opaque  = readOpaqueKeys(layer, index / 8);
+  bool was_opaque = opaque & mask;
+  bool is_opaque  = key != Key_Transparent;
+  uint16_t pos    = packedPosition(layer, index);
+  uint16_t total  = packedKeysBefore(max_layers_);
+  int8_t count_change;
+
+  if (was_opaque && is_opaque) {
+    updatePackedKey(pos, key);
+    return true;
+  } else if (is_opaque) {
+    if (total >= max_keys_)
+      return false;
+    for (uint16_t p = total; p > pos; p--)
+      updatePackedKey(p, readPackedKey(p - 1));
+    updatePackedKey(pos, key);
+    opaque |= mask;
+    count_change = 1;
+  } else if (was_opaque) {
+    for (uint16_t p = pos; p + 1 < total; p++)
+      updatePackedKey(p, readPackedKey(p + 1));
+    opaque &= ~mask;
+    count_change = -1;
+  } else {
+    return true;
+  }
+
+  Runtime.storage().update(keymap_base_ + layer * opaque_key_blocks_ + index / 8, ~opaque);
+  for (uint8_t l = layer + 1; l <= max_layers_; l++)
+    updatePackedKeysBefore(l, packedKeysBefore(l) + count_change);
+  return true;
+}
+
+// Copies `count` packed keys, in whichever direction keeps overlapping ranges
+// intact.
+void EEPROMKeymap::moveKeys(uint16_t from, uint16_t to, uint16_t count) {
+  if (from == to)
+    return;
+  if (to < from) {
+    for (uint16_t i = 0; i < count; i++)
+      updatePackedKey(to + i, readPackedKey(from + i));
+  } else {
+    for (uint16_t i = count; i > 0; i--)
+      updatePackedKey(to + i - 1, readPackedKey(from + i - 1));
+  }
+}
+
+// A streamed upload sends the keys in order, so each non-transparent one can be
+// written right after the previous one, instead of being inserted with
+// `updateCompressedKey()`, which would move every key after it. The stored keys
+// not replaced yet (the tail) are only in the way if the upload has more
+// non-transparent keys than what it replaced; in that case, the tail is moved
+// to the end of the packed area once, and moved back in `endCompressedUpload()`,
+// along with rewriting the counts.
+void EEPROMKeymap::receiveCompressedKey(uint16_t base_pos, Key key) {
+  uint8_t layer  = base_pos / Runtime.device().numKeys();
+  uint8_t index  = base_pos % Runtime.device().numKeys();
+  uint16_t block = layer * opaque_key_blocks_ + index / 8;
+  uint8_t mask   = 1 << (index % 8);
+  uint8_t opaque = readOpaqueKeys(layer, index / 8);
+
+  if (base_pos == 0) {
+    upload_packed_   = 0;
+    upload_tail_     = 0;
+    upload_tail_end_ = packedKeysBefore(max_layers_);
+    // The upload runs over many cycles, and keys are looked up meanwhile.
+    uploading_ = true;
+    reloadKeymap();
+  }
+
+  // The key being replaced is no longer part of the tail.
+  if (opaque & mask)
+    upload_tail_++;
+
+  if (key != Key_Transparent) {
+    if (upload_tail_ < upload_tail_end_ && upload_packed_ >= upload_tail_) {
+      uint16_t count = upload_tail_end_ - upload_tail_;
+      moveKeys(upload_tail_, max_keys_ - count, count);
+      upload_tail_     = max_keys_ - count;
+      upload_tail_end_ = max_keys_;
+    }
+    // If there is no room left, the key is ignored.
+    if (upload_packed_ >= max_keys_ ||
+        (upload_tail_ < upload_tail_end_ && upload_packed_ >= upload_tail_))
+      key = Key_Transparent;
+  }
+
+  if (key != Key_Transparent) {
+    updatePackedKey(upload_packed_++, key);
+    opaque |= mask;
+  } else {
+    opaque &= ~mask;
+  }
+  Runtime.storage().update(keymap_base_ + block, ~opaque);
+}
+
+void EEPROMKeymap::endCompressedUpload() {
+  uploading_ = false;
+  moveKeys(upload_tail_, upload_packed_, upload_tail_end_ - upload_tail_);
+
+  uint16_t count = 0;
+  for (uint8_t layer = 0; layer < max_layers_; layer++) {
+    for (uint8_t block = 0; block < opaque_key_blocks_; block++)
+      count += __builtin_popcount(readOpaqueKeys(layer, block));
+    updatePackedKeysBefore(layer + 1, count);
+  }
+}
+
+bool EEPROMKeymap::isCompressedKeymapValid() {
+  uint16_t count = 0;
+  for (uint8_t layer = 0; layer < max_layers_; layer++) {
+    for (uint8_t block = 0; block < opaque_key_blocks_; block++)
+      count += __builtin_popcount(readOpaqueKeys(layer, block));
+    if (packedKeysBefore(layer + 1) != count)
+      return false;
+  }
+  return count <= max_keys_;
+}
+
+void EEPROMKeymap::clearCompressedKeymap() {
+  for (uint8_t layer = 0; layer < max_layers_; layer++) {
+    for (uint8_t block = 0; block < opaque_key_blocks_; block++)
+      Runtime.storage().update(keymap_base_ + layer * opaque_key_blocks_ + block, 0xff);
+    updatePackedKeysBefore(layer + 1, 0);
+  }
+  Runtime.storage().commit();
 }
 
 void EEPROMKeymap::dumpKeymap(uint8_t layers, Key (*getkey)(uint8_t, KeyAddr)) {
@@ -101,67 +439,165 @@ void EEPROMKeymap::dumpKeymap(uint8_t layers, Key (*getkey)(uint8_t, KeyAddr)) {
   }
 }
 
-EventHandlerResult EEPROMKeymap::onFocusEvent(const char *input) {
-  const char *cmd_custom     = PSTR("keymap.custom");
-  const char *cmd_default    = PSTR("keymap.default");
-  const char *cmd_onlyCustom = PSTR("keymap.onlyCustom");
+static constexpr char cmd_custom[] PROGMEM        = "keymap.custom";
+static constexpr char cmd_custom_binary[] PROGMEM = "keymap.custom.binary";
+static constexpr char cmd_custom_set[] PROGMEM    = "keymap.custom.set";
+static constexpr char cmd_custom_range[] PROGMEM  = "keymap.custom.range";
+static constexpr char cmd_default[] PROGMEM       = "keymap.default";
+static constexpr char cmd_onlyCustom[] PROGMEM    = "keymap.onlyCustom";
 
-  if (::Focus.inputMatchesHelp(input))
-    return ::Focus.printHelp(cmd_custom, cmd_default, cmd_onlyCustom);
+const focusserial::Command EEPROMKeymap::focus_commands_[] PROGMEM = {
+  FOCUS_COMMAND(cmd_custom, focusCustom),
+  FOCUS_COMMAND(cmd_custom_binary, focusCustomBinary),
+  FOCUS_COMMAND(cmd_custom_set, focusCustomSet),
+  FOCUS_COMMAND(cmd_custom_range, focusCustomRange),
+  FOCUS_COMMAND(cmd_default, focusDefault),
+  FOCUS_COMMAND(cmd_onlyCustom, focusOnlyCustom),
+};
+focusserial::CommandTable EEPROMKeymap::focus_command_table_(EEPROMKeymap::focus_commands_);
 
-  if (::Focus.inputMatchesCommand(input, cmd_onlyCustom)) {
-    if (::Focus.isEOL()) {
-      ::Focus.send((uint8_t)::EEPROMSettings.ignoreHardcodedLayers());
-    } else {
-      bool v;
+void EEPROMKeymap::focusOnlyCustom() {
+  if (::Focus.isEOL()) {
+    ::Focus.send((uint8_t)::EEPROMSettings.ignoreHardcodedLayers());
+  } else {
+    bool v;
 
-      ::Focus.read((uint8_t &)v);
-      ::EEPROMSettings.ignoreHardcodedLayers(v);
+    ::Focus.read((uint8_t &)v);
+    ::EEPROMSettings.ignoreHardcodedLayers(v);
 
-      layer_count = max_layers_;
-      if (v) {
-        Layer.getKey = getKey;
-      } else {
-        layer_count += progmem_layers_;
-        Layer.getKey = getKeyExtended;
-      }
-    }
-    return EventHandlerResult::EVENT_CONSUMED;
+    useKeymapSource(v);
   }
+}
 
-  if (::Focus.inputMatchesCommand(input, cmd_default)) {
-    // By using a cast to the appropriate function type,
-    // tell the compiler which overload of getKeyFromPROGMEM
-    // we actully want.
-    //
-    dumpKeymap(progmem_layers_,
-               static_cast<Key (*)(uint8_t, KeyAddr)>(Layer_::getKeyFromPROGMEM));
-    return EventHandlerResult::EVENT_CONSUMED;
-  }
+void EEPROMKeymap::focusDefault() {
+  // By using a cast to the appropriate function type,
+  // tell the compiler which overload of getKeyFromPROGMEM
+  // we actully want.
+  //
+  dumpKeymap(progmem_layers_,
+             static_cast<Key (*)(uint8_t, KeyAddr)>(Layer_::getKeyFromPROGMEM));
+}
 
-  if (!::Focus.inputMatchesCommand(input, cmd_custom))
-    return EventHandlerResult::OK;
+void EEPROMKeymap::focusCustomBinary() {
+  // The compressed layout is of no use to tools expecting two bytes per key,
+  // so the transfer is refused, either way.
+  if (compressed_) {
+    ::Focus.serialPort().write(FocusSerial::NAK);
+    return;
+  }
 
+  // Keys are sent as they are stored: flags first, then the key code.
+  uint16_t size = max_layers_ * Runtime.device().numKeys() * 2;
   if (::Focus.isEOL()) {
+    ::Focus.sendStorage(keymap_base_, size);
+  } else {
+    ::Focus.receiveStorage(keymap_base_, size, endCustomBinary);
+  }
+}
+
+void EEPROMKeymap::endCustomBinary(bool success) {
+  if (!success)
+    return;
+  Runtime.storage().commit();
+  reloadKeymap();
+}
+
+void EEPROMKeymap::focusCustom() {
+  // The keys are read as they arrive, over as many cycles as that takes.
+  ::Focus.streamArguments(receiveCustomKey, endCustomKeymap);
+}
+
+// `keymap.custom.set <layer> <index> <key>...` writes the keys from the given
+// position on, and `keymap.custom.range <layer> <index> <count>` sends `count`
+// keys from there. Positions past the end of a layer continue on the next one.
+void EEPROMKeymap::focusCustomSet() {
+  ::Focus.streamArguments(receiveKeyPatch, endKeyPatch);
+}
+
+void EEPROMKeymap::focusCustomRange() {
+  patch_count_ = 0;
+  ::Focus.streamArguments(receiveKeyRangeArgument, endKeyRange);
+}
+
+void EEPROMKeymap::receivePatchPosition(uint16_t index, uint16_t value) {
+  uint16_t key_count = Runtime.device().numKeys() * max_layers_;
+  if (index == 0) {
+    patch_position_ = value < max_layers_ ? value * Runtime.device().numKeys() : key_count;
+  } else if (value < Runtime.device().numKeys() && patch_position_ < key_count) {
+    patch_position_ += value;
+  } else {
+    patch_position_ = key_count;
+  }
+}
+
+void EEPROMKeymap::receiveKeyPatch(uint16_t index, uint16_t raw_key) {
+  if (index < 2) {
+    receivePatchPosition(index, raw_key);
+    return;
+  }
+  if (patch_position_ < Runtime.device().numKeys() * max_layers_)
+    updateKey(patch_position_++, Key(raw_key));
+}
+
+void EEPROMKeymap::endKeyPatch(uint16_t argument_count) {
+  if (argument_count < 3)
+    return;
+
+  // However many keys were sent, they are committed together.
+  Runtime.storage().commit();
+  Layer.updateActiveLayers();
+}
+
+void EEPROMKeymap::receiveKeyRangeArgument(uint16_t index, uint16_t value) {
+  if (index < 2) {
+    receivePatchPosition(index, value);
+  } else if (index == 2) {
+    patch_count_ = value;
+  }
+}
+
+void EEPROMKeymap::endKeyRange(uint16_t argument_count) {
+  uint16_t key_count = Runtime.device().numKeys() * max_layers_;
+  for (; patch_count_ > 0 && patch_position_ < key_count; patch_count_--, patch_position_++) {
+    ::Focus.send(readKey(patch_position_ / Runtime.device().numKeys(),
+                         patch_position_ % Runtime.device().numKeys()));
+  }
+}
+
+void EEPROMKeymap::receiveCustomKey(uint16_t index, uint16_t raw_key) {
+  if (index >= (uint16_t)Runtime.device().numKeys() * max_layers_)
+    return;
+
+  if (compressed_) {
+    receiveCompressedKey(index, Key(raw_key));
+  } else {
+    updateKey(index, Key(raw_key));
+  }
+}
+
+void EEPROMKeymap::endCustomKeymap(uint16_t key_count) {
+  if (key_count == 0) {
     // By using a cast to the appropriate function type,
     // tell the compiler which overload of getKey
     // we actually want.
     //
     dumpKeymap(max_layers_, static_cast<Key (*)(uint8_t, KeyAddr)>(getKey));
-  } else {
-    uint16_t i = 0;
-
-    while (!::Focus.isEOL() && (i < (uint16_t)Runtime.device().numKeys() * max_layers_)) {
-      Key k;
+    return;
+  }
 
-      ::Focus.read(k);
-      updateKey(i, k);
-      i++;
-    }
+  if (compressed_) {
+    // Until now, only the keys were written; the rest of the keymap in RAM
+    // is rebuilt from storage.
+    endCompressedUpload();
     Runtime.storage().commit();
+    reloadKeymap();
+    return;
   }
 
-  return EventHandlerResult::EVENT_CONSUMED;
+  Runtime.storage().commit();
+  // Keys that changed to or from transparent may change which layer other
+  // keys are looked up from.
+  Layer.updateActiveLayers();
 }
 
 }  // namespace plugin
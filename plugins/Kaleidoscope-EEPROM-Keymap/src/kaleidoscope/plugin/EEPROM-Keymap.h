@@ -19,10 +19,30 @@
 
 #include <stdint.h>  // for uint8_t, uint16_t
 
-#include "kaleidoscope/KeyAddr.h"               // for KeyAddr
-#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
-#include "kaleidoscope/key_defs.h"              // for Key
-#include "kaleidoscope/plugin.h"                // for Plugin
+#include "kaleidoscope/KeyAddr.h"                      // for KeyAddr
+#include "kaleidoscope/event_handler_result.h"         // for EventHandlerResult
+#include "kaleidoscope/key_defs.h"                     // for Key
+#include "kaleidoscope/plugin.h"                       // for Plugin
+#include "kaleidoscope/plugin/focusserial/Commands.h"  // for Command, CommandTable
+#include "kaleidoscope_internal/device.h"              // for device
+
+// The number of EEPROM layers for which a bitmap of non-transparent keys is
+// kept in RAM, to speed up layer changes. Each one costs one bit per key. Any
+// layers beyond this still work, but layer changes involving them are slower.
+#ifndef MAX_EEPROM_KEYMAP_BITMAP_LAYERS
+#define MAX_EEPROM_KEYMAP_BITMAP_LAYERS 10
+#endif
+
+// Whether the last key looked up from storage is kept in RAM for each key
+// address, so that looking it up again on the same layer needn't read storage.
+// This costs three bytes per key, so it is off by default on AVR.
+#ifndef EEPROM_KEYMAP_KEY_CACHE
+#ifdef __AVR__
+#define EEPROM_KEYMAP_KEY_CACHE 0
+#else
+#define EEPROM_KEYMAP_KEY_CACHE 1
+#endif
+#endif
 
 namespace kaleidoscope {
 namespace plugin {
@@ -35,9 +55,10 @@ class EEPROMKeymap : public kaleidoscope::Plugin {
 
   EventHandlerResult onSetup();
   EventHandlerResult onNameQuery();
-  EventHandlerResult onFocusEvent(const char *input);
+  EventHandlerResult onStorageChange();
 
   static void setup(uint8_t max);
+  static void setupCompressed(uint8_t max, uint16_t max_keys);
 
   static void max_layers(uint8_t max);
 
@@ -46,6 +67,9 @@ class EEPROMKeymap : public kaleidoscope::Plugin {
   static Key getKey(uint8_t layer, KeyAddr key_addr);
   static Key getKeyExtended(uint8_t layer, KeyAddr key_addr);
 
+  static uint8_t getOpaqueKeys(uint8_t layer, uint8_t block);
+  static uint8_t getOpaqueKeysExtended(uint8_t layer, uint8_t block);
+
   static void updateKey(uint16_t base_pos, Key key);
 
  private:
@@ -53,9 +77,75 @@ class EEPROMKeymap : public kaleidoscope::Plugin {
   static uint8_t max_layers_;
   static uint8_t progmem_layers_;
 
+  static constexpr uint8_t opaque_key_blocks_ = (kaleidoscope_internal::device.numKeys() + 7) / 8;
+  static uint8_t opaque_keys_[MAX_EEPROM_KEYMAP_BITMAP_LAYERS][opaque_key_blocks_];
+
+  static void useKeymapSource(bool only_custom);
+  static void updateOpaqueKeys();
+  static void updateOpaqueKey(uint16_t base_pos, Key key);
+
+#if EEPROM_KEYMAP_KEY_CACHE
+  // The layer each cached key was looked up on, or `no_cached_layer_`.
+  static constexpr uint8_t no_cached_layer_ = 0xff;
+  static uint8_t cached_layers_[kaleidoscope_internal::device.numKeys()];
+  static Key cached_keys_[kaleidoscope_internal::device.numKeys()];
+#endif
+  static void clearKeyCache();
+  static void reloadKeymap();
+  static Key readKey(uint8_t layer, uint8_t index);
+
+  // The compressed layout (see `setupCompressed()`): a bitmap of transparent
+  // keys for each layer, the number of keys stored before each layer but the
+  // first, and the non-transparent keys of all layers, packed in order.
+  static bool compressed_;
+  static uint16_t max_keys_;
+  static uint16_t packedSize(uint8_t layers);
+  static uint8_t readOpaqueKeys(uint8_t layer, uint8_t block);
+  static uint8_t opaqueKeys(uint8_t layer, uint8_t block);
+  static uint16_t packedKeysBefore(uint8_t layer);
+  static void updatePackedKeysBefore(uint8_t layer, uint16_t count);
+  static uint16_t packedPosition(uint8_t layer, uint8_t index);
+  static Key readPackedKey(uint16_t pos);
+  static void updatePackedKey(uint16_t pos, Key key);
+  static bool updateCompressedKey(uint8_t layer, uint8_t index, Key key);
+  static void moveKeys(uint16_t from, uint16_t to, uint16_t count);
+  static bool isCompressedKeymapValid();
+  static void clearCompressedKeymap();
+
   static Key parseKey();
   static void printKey(Key key);
   static void dumpKeymap(uint8_t layers, Key (*getkey)(uint8_t, KeyAddr));
+  static const focusserial::Command focus_commands_[];
+  static focusserial::CommandTable focus_command_table_;
+  static void focusCustom();
+  static void focusCustomBinary();
+  static void endCustomBinary(bool success);
+  static void focusCustomSet();
+  static void focusCustomRange();
+  static void focusDefault();
+  static void focusOnlyCustom();
+  static void receiveCustomKey(uint16_t index, uint16_t raw_key);
+  static void endCustomKeymap(uint16_t key_count);
+
+  // The state of a streamed `keymap.custom` upload to a compressed keymap:
+  // whether one is under way, the number of keys packed so far, and where the
+  // stored keys not yet replaced are.
+  static bool uploading_;
+  static uint16_t upload_packed_;
+  static uint16_t upload_tail_;
+  static uint16_t upload_tail_end_;
+  static void receiveCompressedKey(uint16_t base_pos, Key key);
+  static void endCompressedUpload();
+
+  // The state of streamed `keymap.custom.set` and `keymap.custom.range`
+  // requests.
+  static uint16_t patch_position_;
+  static uint16_t patch_count_;
+  static void receivePatchPosition(uint16_t index, uint16_t value);
+  static void receiveKeyPatch(uint16_t index, uint16_t raw_key);
+  static void endKeyPatch(uint16_t argument_count);
+  static void receiveKeyRangeArgument(uint16_t index, uint16_t value);
+  static void endKeyRange(uint16_t argument_count);
 };
 
 }  // namespace plugin
@@ -17,7 +17,7 @@
 
 #include "kaleidoscope/plugin/EEPROM-Settings.h"
 
-#include <Arduino.h>                   // for PSTR, F, __FlashStringHelper
+#include <Arduino.h>                   // for PROGMEM, F, __FlashStringHelper
 #include <Kaleidoscope-FocusSerial.h>  // for Focus, FocusSerial
 #include <stdint.h>                    // for uint16_t, uint8_t
 #include <stddef.h>                    // for size_t
@@ -176,71 +176,113 @@ bool EEPROMSettings::isSliceValid(uint16_t start, size_t size) {
 }
 
 /** Focus **/
-EventHandlerResult FocusSettingsCommand::onFocusEvent(const char *input) {
-  const char *cmd_defaultLayer = PSTR("settings.defaultLayer");
-  const char *cmd_isValid      = PSTR("settings.valid?");
-  const char *cmd_version      = PSTR("settings.version");
-  const char *cmd_crc          = PSTR("settings.crc");
-
-  if (::Focus.inputMatchesHelp(input))
-    return ::Focus.printHelp(cmd_defaultLayer, cmd_isValid, cmd_version, cmd_crc);
-
-  if (::Focus.inputMatchesCommand(input, cmd_defaultLayer)) {
-    if (::Focus.isEOL()) {
-      ::Focus.send(::EEPROMSettings.default_layer());
-    } else {
-      uint8_t layer;
-      ::Focus.read(layer);
-      ::EEPROMSettings.default_layer(layer);
-    }
-  } else if (::Focus.inputMatchesCommand(input, cmd_isValid)) {
-    ::Focus.send(::EEPROMSettings.isValid());
-  } else if (::Focus.inputMatchesCommand(input, cmd_version)) {
-    ::Focus.send(::EEPROMSettings.version());
-  } else if (::Focus.inputMatchesCommand(input, cmd_crc)) {
-    ::Focus.sendRaw(::CRCCalculator.crc, F("/"), ::EEPROMSettings.crc());
+static constexpr char cmd_defaultLayer[] PROGMEM = "settings.defaultLayer";
+static constexpr char cmd_isValid[] PROGMEM      = "settings.valid?";
+static constexpr char cmd_version[] PROGMEM      = "settings.version";
+static constexpr char cmd_crc[] PROGMEM          = "settings.crc";
+
+const focusserial::Command FocusSettingsCommand::commands_[] PROGMEM = {
+  FOCUS_COMMAND(cmd_defaultLayer, defaultLayer),
+  FOCUS_COMMAND(cmd_isValid, isValid),
+  FOCUS_COMMAND(cmd_version, version),
+  FOCUS_COMMAND(cmd_crc, crc),
+};
+focusserial::CommandTable FocusSettingsCommand::command_table_(FocusSettingsCommand::commands_);
+
+EventHandlerResult FocusSettingsCommand::onSetup() {
+  ::Focus.registerCommands(command_table_);
+  return EventHandlerResult::OK;
+}
+
+void FocusSettingsCommand::defaultLayer() {
+  if (::Focus.isEOL()) {
+    ::Focus.send(::EEPROMSettings.default_layer());
   } else {
-    return EventHandlerResult::OK;
+    uint8_t layer;
+    ::Focus.read(layer);
+    ::EEPROMSettings.default_layer(layer);
   }
+}
 
-  return EventHandlerResult::EVENT_CONSUMED;
-}
-
-EventHandlerResult FocusEEPROMCommand::onFocusEvent(const char *input) {
-  const char *cmd_contents = PSTR("eeprom.contents");
-  const char *cmd_free     = PSTR("eeprom.free");
-  const char *cmd_erase    = PSTR("eeprom.erase");
-
-  if (::Focus.inputMatchesHelp(input))
-    return ::Focus.printHelp(cmd_contents, cmd_free, cmd_erase);
-
-  if (::Focus.inputMatchesCommand(input, cmd_contents)) {
-    if (::Focus.isEOL()) {
-      for (uint16_t i = 0; i < Runtime.storage().length(); i++) {
-        uint8_t d = Runtime.storage().read(i);
-        ::Focus.send(d);
-      }
-    } else {
-      for (uint16_t i = 0; i < Runtime.storage().length() && !::Focus.isEOL(); i++) {
-        uint8_t d;
-        ::Focus.read(d);
-        Runtime.storage().update(i, d);
-      }
-      Runtime.storage().commit();
-    }
-  } else if (::Focus.inputMatchesCommand(input, cmd_free)) {
-    ::Focus.send(Runtime.storage().length() - ::EEPROMSettings.used());
-  } else if (::Focus.inputMatchesCommand(input, cmd_erase)) {
-    for (uint16_t i = 0; i < Runtime.storage().length(); i++) {
-      Runtime.storage().update(i, EEPROMSettings::EEPROM_UNINITIALIZED_BYTE);
-    }
-    Runtime.storage().commit();
-    Runtime.device().rebootBootloader();
+void FocusSettingsCommand::isValid() {
+  ::Focus.send(::EEPROMSettings.isValid());
+}
+
+void FocusSettingsCommand::version() {
+  ::Focus.send(::EEPROMSettings.version());
+}
+
+void FocusSettingsCommand::crc() {
+  ::Focus.sendRaw(::CRCCalculator.crc, F("/"), ::EEPROMSettings.crc());
+}
+
+static constexpr char cmd_contents[] PROGMEM        = "eeprom.contents";
+static constexpr char cmd_contents_binary[] PROGMEM = "eeprom.contents.binary";
+static constexpr char cmd_free[] PROGMEM            = "eeprom.free";
+static constexpr char cmd_erase[] PROGMEM           = "eeprom.erase";
+
+const focusserial::Command FocusEEPROMCommand::commands_[] PROGMEM = {
+  FOCUS_COMMAND(cmd_contents, contents),
+  FOCUS_COMMAND(cmd_contents_binary, contentsBinary),
+  FOCUS_COMMAND(cmd_free, freeSpace),
+  FOCUS_COMMAND(cmd_erase, erase),
+};
+focusserial::CommandTable FocusEEPROMCommand::command_table_(FocusEEPROMCommand::commands_);
+
+EventHandlerResult FocusEEPROMCommand::onSetup() {
+  ::Focus.registerCommands(command_table_);
+  return EventHandlerResult::OK;
+}
+
+void FocusEEPROMCommand::contents() {
+  // The contents are read as they arrive, over as many cycles as that takes.
+  ::Focus.streamArguments(receiveContents, endContents);
+}
+
+void FocusEEPROMCommand::contentsBinary() {
+  if (::Focus.isEOL()) {
+    ::Focus.sendStorage(0, Runtime.storage().length());
   } else {
-    return EventHandlerResult::OK;
+    ::Focus.receiveStorage(0, Runtime.storage().length(), endContentsBinary);
   }
+}
+
+void FocusEEPROMCommand::endContentsBinary(bool success) {
+  if (!success)
+    return;
+  Runtime.storage().commit();
+  Runtime.onStorageChange();
+}
+
+void FocusEEPROMCommand::freeSpace() {
+  ::Focus.send(Runtime.storage().length() - ::EEPROMSettings.used());
+}
+
+void FocusEEPROMCommand::erase() {
+  for (uint16_t i = 0; i < Runtime.storage().length(); i++) {
+    Runtime.storage().update(i, EEPROMSettings::EEPROM_UNINITIALIZED_BYTE);
+  }
+  Runtime.storage().commit();
+  Runtime.rebootBootloader();
+}
 
-  return EventHandlerResult::EVENT_CONSUMED;
+void FocusEEPROMCommand::receiveContents(uint16_t index, uint16_t value) {
+  if (index < Runtime.storage().length())
+    Runtime.storage().update(index, value);
+}
+
+void FocusEEPROMCommand::endContents(uint16_t count) {
+  if (count != 0) {
+    Runtime.storage().commit();
+    // Plugins keeping parts of storage in RAM need to pick up the changes.
+    Runtime.onStorageChange();
+    return;
+  }
+
+  for (uint16_t i = 0; i < Runtime.storage().length(); i++) {
+    uint8_t d = Runtime.storage().read(i);
+    ::Focus.send(d);
+  }
 }
 
 }  // namespace plugin
@@ -17,11 +17,12 @@
 
 #pragma once
 
-#include <stdint.h>                             // for uint8_t, uint16_t
-#include <stddef.h>                             // for size_t
-#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
-#include "kaleidoscope/plugin.h"                // for Plugin
-#include "kaleidoscope/Runtime.h"               // for Runtime
+#include <stdint.h>                                    // for uint8_t, uint16_t
+#include <stddef.h>                                    // for size_t
+#include "kaleidoscope/event_handler_result.h"         // for EventHandlerResult
+#include "kaleidoscope/plugin.h"                       // for Plugin
+#include "kaleidoscope/plugin/focusserial/Commands.h"  // for Command, CommandTable
+#include "kaleidoscope/Runtime.h"                      // for Runtime
 
 namespace kaleidoscope {
 namespace plugin {
@@ -110,12 +111,31 @@ class EEPROMSettings : public kaleidoscope::Plugin {
 
 class FocusSettingsCommand : public kaleidoscope::Plugin {
  public:
-  EventHandlerResult onFocusEvent(const char *input);
+  EventHandlerResult onSetup();
+
+ private:
+  static const focusserial::Command commands_[];
+  static focusserial::CommandTable command_table_;
+  static void defaultLayer();
+  static void isValid();
+  static void version();
+  static void crc();
 };
 
 class FocusEEPROMCommand : public kaleidoscope::Plugin {
  public:
-  EventHandlerResult onFocusEvent(const char *input);
+  EventHandlerResult onSetup();
+
+ private:
+  static const focusserial::Command commands_[];
+  static focusserial::CommandTable command_table_;
+  static void contents();
+  static void contentsBinary();
+  static void endContentsBinary(bool success);
+  static void freeSpace();
+  static void erase();
+  static void receiveContents(uint16_t index, uint16_t value);
+  static void endContents(uint16_t count);
 };
 
 }  // namespace plugin
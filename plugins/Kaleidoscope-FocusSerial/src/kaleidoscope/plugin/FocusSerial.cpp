@@ -17,13 +17,14 @@
 
 #include "kaleidoscope/plugin/FocusSerial.h"
 
-#include <Arduino.h>         // for PSTR, F, strcmp_P
+#include <Arduino.h>         // for PSTR, PROGMEM, F, millis, strcmp_P, strlen_P, strncmp_P
 #include <HardwareSerial.h>  // for HardwareSerial
-#include <string.h>          // for memset
 
-#include "kaleidoscope/Runtime.h"               // for Runtime, Runtime_
-#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
-#include "kaleidoscope/hooks.h"                 // for Hooks
+#include "kaleidoscope/Runtime.h"                   // for Runtime, Runtime_
+#include "kaleidoscope/event_handler_result.h"      // for EventHandlerResult, EventHandlerResult::OK
+#include "kaleidoscope/hooks.h"                     // for Hooks
+#include "kaleidoscope/plugin/focusserial/Frame.h"  // for Frame
+#include "kaleidoscope/progmem_helpers.h"           // for cloneFromProgmem
 
 #ifdef __AVR__
 #include <avr/pgmspace.h>
@@ -33,81 +34,101 @@ namespace kaleidoscope {
 namespace plugin {
 
 EventHandlerResult FocusSerial::afterEachCycle() {
-  int c;
   // GD32 doesn't currently autoflush the very last packet. So manually flush here
-  Runtime.serialPort().flush();
-  // If the serial buffer is empty, we don't have any work to do
-  if (Runtime.serialPort().available() == 0) {
-    return EventHandlerResult::OK;
-  }
+  serialPort().flush();
+  reader_.process(serialPort(), cycle_budget_us_);
+  return EventHandlerResult::OK;
+}
 
-  do {
-    // If there's a newline pending, don't read it
-    if (peek() == NEWLINE) {
-      break;
-    }
-    c = Runtime.serialPort().read();
-    // Don't store the separator; just stash it
-    if (c == SEPARATOR) {
-      break;
-    }
-    input_[buf_cursor_++] = c;
-  } while (buf_cursor_ < (sizeof(input_) - 1) && Runtime.serialPort().available());
+EventHandlerResult FocusSerial::beforeSleeping() {
+  // Stay awake while a request is in progress.
+  if (reader_.busy())
+    return EventHandlerResult::ABORT;
+  return EventHandlerResult::OK;
+}
+
+void FocusSerial::dispatch(const char *command) {
+  if (!::Focus.runCommand(command))
+    Runtime.onFocusEvent(command);
+}
 
-  if ((c != SEPARATOR) && (Runtime.serialPort().peek() != NEWLINE) && buf_cursor_ < (sizeof(input_) - 1)) {
-    // We don't have enough command to work with yet.
-    // Let's leave the buffer around for another cycle
-    return EventHandlerResult::OK;
+void sendLedModeCallback_(const char *name) {
+  ::Focus.serialPort().println(name);
+}
+
+static constexpr char cmd_help[] PROGMEM      = "help";
+static constexpr char cmd_reset[] PROGMEM     = "device.reset";
+static constexpr char cmd_led_modes[] PROGMEM = "led.modes";
+static constexpr char cmd_plugins[] PROGMEM   = "plugins";
+static constexpr char cmd_binary[] PROGMEM    = "focus.binary";
+
+const focusserial::Command FocusSerial::commands_[] PROGMEM = {
+  FOCUS_COMMAND(cmd_help, help),
+  FOCUS_COMMAND(cmd_reset, deviceReset),
+  FOCUS_COMMAND(cmd_led_modes, ledModes),
+  FOCUS_COMMAND(cmd_plugins, plugins),
+  FOCUS_COMMAND(cmd_binary, binaryInfo),
+};
+focusserial::CommandTable FocusSerial::command_table_(FocusSerial::commands_);
+
+EventHandlerResult FocusSerial::onSetup() {
+  registerCommands(command_table_);
+  return EventHandlerResult::OK;
+}
+
+void FocusSerial::registerCommands(focusserial::CommandTable &table) {
+  focusserial::CommandTable **link = &command_tables_;
+  for (; *link != nullptr; link = &(*link)->next_) {
+    if (*link == &table)
+      return;
   }
+  *link = &table;
+}
 
-  // Then process the command
-  Runtime.onFocusEvent(input_);
-  while (Runtime.serialPort().available()) {
-    c = Runtime.serialPort().read();
-    if (c == NEWLINE) {
-      // newline serves as an end-of-command marker
-      // don't drain the buffer past there
-      break;
+bool FocusSerial::runCommand(const char *input) {
+  // The hashes only narrow the search down; the name is still compared, so two
+  // commands whose hashes collide work all the same.
+  uint16_t hash = focusserial::hashCommand(input);
+  for (auto table = command_tables_; table != nullptr; table = table->next_) {
+    for (uint8_t i = 0; i < table->count_; i++) {
+      auto command = cloneFromProgmem(table->commands_[i]);
+      if (command.hash == hash && inputMatchesCommand(input, command.name)) {
+        (*command.handler)();
+        return true;
+      }
     }
   }
-  // End of command processing is signalled with a CRLF followed by a single period
-  Runtime.serialPort().println(F("\r\n."));
-  buf_cursor_ = 0;
-  memset(input_, 0, sizeof(input_));
-  return EventHandlerResult::OK;
+  return false;
 }
 
-void sendLedModeCallback_(const char *name) {
-  Runtime.serialPort().println(name);
+void FocusSerial::help() {
+  for (auto table = ::Focus.command_tables_; table != nullptr; table = table->next_) {
+    for (uint8_t i = 0; i < table->count_; i++)
+      ::Focus.printHelp(cloneFromProgmem(table->commands_[i]).name);
+  }
+  // Plugins that handle their commands in `onFocusEvent()` list them there.
+  Runtime.onFocusEvent(::Focus.reader_.command());
 }
 
-EventHandlerResult FocusSerial::onFocusEvent(const char *input) {
-  const char *cmd_help      = PSTR("help");
-  const char *cmd_reset     = PSTR("device.reset");
-  const char *cmd_led_modes = PSTR("led.modes");
-  const char *cmd_plugins   = PSTR("plugins");
+void FocusSerial::deviceReset() {
+  Runtime.rebootBootloader();
+}
 
-  if (inputMatchesHelp(input))
-    return printHelp(cmd_help, cmd_reset, cmd_led_modes, cmd_plugins);
+void FocusSerial::ledModes() {
+  kaleidoscope::Hooks::onLedEffectQuery(sendLedModeCallback_);
+}
 
-  if (inputMatchesCommand(input, cmd_reset)) {
-    Runtime.device().rebootBootloader();
-    return EventHandlerResult::EVENT_CONSUMED;
-  }
-  if (inputMatchesCommand(input, cmd_led_modes)) {
-    kaleidoscope::Hooks::onLedEffectQuery(sendLedModeCallback_);
-    return EventHandlerResult::EVENT_CONSUMED;
-  }
-  if (inputMatchesCommand(input, cmd_plugins)) {
-    kaleidoscope::Hooks::onNameQuery();
-    return EventHandlerResult::EVENT_CONSUMED;
-  }
+void FocusSerial::plugins() {
+  kaleidoscope::Hooks::onNameQuery();
+}
 
-  return EventHandlerResult::OK;
+void FocusSerial::binaryInfo() {
+  // The protocol version, the largest frame payload, and the window size.
+  ::Focus.send((uint8_t)2, focusserial::Frame::max_payload, focusserial::Transfer::window);
 }
 
 void FocusSerial::printBool(bool b) {
-  Runtime.serialPort().print((b) ? F("true") : F("false"));
+  serialPort().print((b) ? F("true") : F("false"));
 }
 
 bool FocusSerial::inputMatchesHelp(const char *input) {
@@ -118,23 +139,43 @@ bool FocusSerial::inputMatchesCommand(const char *input, const char *expected) {
   return strcmp_P(input, expected) == 0;
 }
 
+bool FocusSerial::inputMatchesCommandVariant(const char *input, const char *expected, const char *variant) {
+  size_t length = strlen_P(expected);
+  return strncmp_P(input, expected, length) == 0 &&
+         strcmp_P(input + length, variant) == 0;
+}
+
+bool FocusSerial::inputMatchesBinaryCommand(const char *input, const char *expected) {
+  return inputMatchesCommandVariant(input, expected, PSTR(".binary"));
+}
+
 
 bool FocusSerial::isEOL() {
-  int c        = -1;
-  auto timeout = Runtime.serialPort().getTimeout();
-  auto start   = millis();
-
-
-  // Duplicate some of Stream::timedPeek because it's protected
-  do {
-    c = peek();
-    if (c == NEWLINE) {
-      return true;
-    } else if (c >= 0) {
-      return false;
-    }
-  } while ((millis() - start) < timeout);
-  return true;
+  int c = reader_.peek(serialPort());
+  return c < 0 || c == NEWLINE;
+}
+
+void FocusSerial::sendStorage(uint16_t offset, uint16_t size, TransferEndHandler on_end) {
+  // The host's replies follow the request line.
+  reader_.skipLine(serialPort());
+  reader_.sendStorage(offset, size, on_end);
+}
+
+void FocusSerial::receiveStorage(uint16_t offset, uint16_t size, TransferEndHandler on_end) {
+  uint16_t start, length;
+  read(start);
+  read(length);
+  // The frames follow the request line.
+  reader_.skipLine(serialPort());
+
+  if (start > size || length > size - start) {
+    serialPort().write(NAK);
+    if (on_end)
+      (*on_end)(false);
+    return;
+  }
+  serialPort().write(ACK);
+  reader_.receiveStorage(offset + start, length, on_end);
 }
 
 }  // namespace plugin
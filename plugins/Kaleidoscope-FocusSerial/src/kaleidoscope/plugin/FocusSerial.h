@@ -21,11 +21,14 @@
 #include <HardwareSerial.h>  // for HardwareSerial
 #include <stdint.h>          // for uint8_t, uint16_t
 
-#include "kaleidoscope/Runtime.h"               // for Runtime, Runtime_
-#include "kaleidoscope/device/device.h"         // for cRGB
-#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
-#include "kaleidoscope/key_defs.h"              // for Key
-#include "kaleidoscope/plugin.h"                // for Plugin
+#include "kaleidoscope/Runtime.h"                      // for Runtime, Runtime_
+#include "kaleidoscope/device/device.h"                // for cRGB
+#include "kaleidoscope/event_handler_result.h"         // for EventHandlerResult, EventHandlerResult::OK
+#include "kaleidoscope/key_defs.h"                     // for Key
+#include "kaleidoscope/plugin.h"                       // for Plugin
+#include "kaleidoscope/plugin/focusserial/Commands.h"       // for Command, CommandTable
+#include "kaleidoscope/plugin/focusserial/RequestReader.h"  // for RequestReader
+#include "kaleidoscope/plugin/focusserial/Transfer.h"       // for Transfer
 
 // IWYU pragma: no_include "WString.h"
 
@@ -37,23 +40,58 @@ class FocusSerial : public kaleidoscope::Plugin {
   static constexpr char SEPARATOR = ' ';
   static constexpr char NEWLINE   = '\n';
 
+  // Sent by binary transfers to accept (or reject) a frame or a request.
+  static constexpr uint8_t ACK = focusserial::Transfer::ACK;
+  static constexpr uint8_t NAK = focusserial::Transfer::NAK;
+
   bool inputMatchesHelp(const char *input);
   bool inputMatchesCommand(const char *input, const char *expected);
+  bool inputMatchesCommandVariant(const char *input, const char *expected, const char *variant);
+  bool inputMatchesBinaryCommand(const char *input, const char *expected);
+
+  // Registers a table of commands, which are then looked up by a hash of their
+  // name, and run without going through `onFocusEvent()`. `help` lists them
+  // too. Registering the same table again has no effect. See the README.
+  void registerCommands(focusserial::CommandTable &table);
+
+  // Makes Focus read requests from, and send responses to, `port` instead of
+  // the device's serial port.
+  void setSerialPort(Stream &port) {
+    serial_port_ = &port;
+  }
+  Stream &serialPort() {
+    if (serial_port_ != nullptr)
+      return *serial_port_;
+    return Runtime.serialPort();
+  }
 
   EventHandlerResult printHelp() {
     return EventHandlerResult::OK;
   }
   template<typename... Vars>
   EventHandlerResult printHelp(const char *h1, Vars... vars) {
-    Runtime.serialPort().println((const __FlashStringHelper *)h1);
+    serialPort().println((const __FlashStringHelper *)h1);
     delayAfterPrint();
     return printHelp(vars...);
   }
+  // Lists the variants of `command` (all in PROGMEM): the command name followed
+  // by each of the suffixes, such as `.set`.
+  EventHandlerResult printHelpVariants(const char *command) {
+    return EventHandlerResult::OK;
+  }
+  template<typename... Vars>
+  EventHandlerResult printHelpVariants(const char *command, const char *variant, Vars... vars) {
+    serialPort().print((const __FlashStringHelper *)command);
+    delayAfterPrint();
+    serialPort().println((const __FlashStringHelper *)variant);
+    delayAfterPrint();
+    return printHelpVariants(command, vars...);
+  }
 
   EventHandlerResult sendName(const __FlashStringHelper *name) {
-    Runtime.serialPort().print(name);
+    serialPort().print(name);
     delayAfterPrint();
-    Runtime.serialPort().println();
+    serialPort().println();
     delayAfterPrint();
     return EventHandlerResult::OK;
   }
@@ -68,14 +106,14 @@ class FocusSerial : public kaleidoscope::Plugin {
   void send(const bool b) {
     printBool(b);
     delayAfterPrint();
-    Runtime.serialPort().print(SEPARATOR);
+    serialPort().print(SEPARATOR);
     delayAfterPrint();
   }
   template<typename V>
   void send(V v) {
-    Runtime.serialPort().print(v);
+    serialPort().print(v);
     delayAfterPrint();
-    Runtime.serialPort().print(SEPARATOR);
+    serialPort().print(SEPARATOR);
     delayAfterPrint();
   }
   template<typename Var, typename... Vars>
@@ -87,44 +125,83 @@ class FocusSerial : public kaleidoscope::Plugin {
   void sendRaw() {}
   template<typename Var, typename... Vars>
   void sendRaw(Var v, Vars... vars) {
-    Runtime.serialPort().print(v);
+    serialPort().print(v);
     delayAfterPrint();
     sendRaw(vars...);
   }
 
   const char peek() {
-    return Runtime.serialPort().peek();
+    return serialPort().peek();
   }
 
   void read(Key &key) {
-    key.setRaw(Runtime.serialPort().parseInt());
+    key.setRaw(reader_.parseInt(serialPort()));
   }
   void read(cRGB &color) {
-    color.r = Runtime.serialPort().parseInt();
-    color.g = Runtime.serialPort().parseInt();
-    color.b = Runtime.serialPort().parseInt();
+    color.r = reader_.parseInt(serialPort());
+    color.g = reader_.parseInt(serialPort());
+    color.b = reader_.parseInt(serialPort());
   }
   void read(char &c) {
-    Runtime.serialPort().readBytes(&c, 1);
+    int b = reader_.readByte(serialPort());
+    if (b >= 0)
+      c = b;
   }
   void read(uint8_t &u8) {
-    u8 = Runtime.serialPort().parseInt();
+    u8 = reader_.parseInt(serialPort());
   }
   void read(uint16_t &u16) {
-    u16 = Runtime.serialPort().parseInt();
+    u16 = reader_.parseInt(serialPort());
   }
 
   bool isEOL();
 
+  // Binary transfers of `size` bytes of storage, starting at `offset`. See the
+  // README for the wire protocol. Called from `onFocusEvent()`, they start the
+  // transfer, which then runs over as many cycles as it takes, and ends the
+  // request once it's over. `on_end` (if any) is called with whether it
+  // succeeded before that, so that it can commit (or drop) what was received.
+  typedef focusserial::RequestReader::TransferEndHandler TransferEndHandler;
+  void sendStorage(uint16_t offset, uint16_t size, TransferEndHandler on_end = nullptr);
+  void receiveStorage(uint16_t offset, uint16_t size, TransferEndHandler on_end = nullptr);
+
+  // Streamed requests: instead of reading its arguments right away, which
+  // blocks until they all arrive, a handler can call `streamArguments()` from
+  // `onFocusEvent()`. The numeric arguments of the request are then passed to
+  // `on_argument` as they arrive, over as many cycles as it takes, and
+  // `on_end` is called with the number of arguments once the request line is
+  // over. Any response is sent from there.
+  typedef focusserial::RequestReader::ArgumentHandler ArgumentHandler;
+  typedef focusserial::RequestReader::EndOfRequestHandler EndOfRequestHandler;
+  void streamArguments(ArgumentHandler on_argument, EndOfRequestHandler on_end) {
+    reader_.streamArguments(on_argument, on_end);
+  }
+
   /* Hooks */
+  EventHandlerResult onSetup();
   EventHandlerResult afterEachCycle();
-  EventHandlerResult onFocusEvent(const char *input);
+  EventHandlerResult beforeSleeping();
 
  private:
-  char input_[32];
-  uint8_t buf_cursor_ = 0;
+  Stream *serial_port_ = nullptr;
+  focusserial::RequestReader reader_{dispatch};
+  static void dispatch(const char *command);
   void printBool(bool b);
 
+  // The most time spent reading requests per cycle.
+  static constexpr uint16_t cycle_budget_us_ = 1000;
+
+  focusserial::CommandTable *command_tables_ = nullptr;
+  bool runCommand(const char *input);
+
+  static const focusserial::Command commands_[];
+  static focusserial::CommandTable command_table_;
+  static void help();
+  static void deviceReset();
+  static void ledModes();
+  static void plugins();
+  static void binaryInfo();
+
   // This is a hacky workaround for the host seemingly dropping characters
   // when a client spams its serial port too quickly
   // Verified on GD32 and macOS 12.3 2022-03-29
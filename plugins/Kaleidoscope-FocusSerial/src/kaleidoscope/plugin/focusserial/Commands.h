@@ -0,0 +1,86 @@
+/* -*- mode: c++ -*-
+ * Kaleidoscope-FocusSerial -- Bidirectional communication plugin
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <Arduino.h>  // for PROGMEM
+#include <stdint.h>   // for uint8_t, uint16_t
+
+namespace kaleidoscope {
+namespace plugin {
+class FocusSerial;
+
+namespace focusserial {
+
+/// The hash commands are looked up by (djb2, truncated to 16 bits)
+///
+/// It is `constexpr`, so that the hashes in a command table are computed at
+/// compile time, and it is also used at run time, on the incoming command.
+constexpr uint16_t hashCommand(const char *name, uint16_t hash = 5381) {
+  return *name == '\0'
+           ? hash
+           : hashCommand(name + 1, uint16_t(uint16_t(hash * 33) ^ uint8_t(*name)));
+}
+
+// Forces a hash to be computed at compile time.
+template<uint16_t _hash>
+struct CommandHash {
+  static constexpr uint16_t value = _hash;
+};
+
+typedef void (*CommandHandler)();
+
+/// An entry in a command table, kept in PROGMEM
+///
+/// `name` must point to a string in PROGMEM too. Use `FOCUS_COMMAND()` to
+/// create one, so the hash is filled in.
+struct Command {
+  uint16_t hash;
+  const char *name;
+  CommandHandler handler;
+};
+
+/// A plugin's Focus commands, registered with `Focus.registerCommands()`
+///
+/// Holds on to a PROGMEM array of `Command`s, and links the registered tables
+/// together, so it must outlive the registration (make it a static).
+class CommandTable {
+ public:
+  template<uint8_t _count>
+  explicit constexpr CommandTable(const Command (&commands)[_count])
+    : commands_(commands), count_(_count) {}
+
+ private:
+  friend class kaleidoscope::plugin::FocusSerial;
+
+  const Command *commands_;
+  uint8_t count_;
+  CommandTable *next_ = nullptr;
+};
+
+}  // namespace focusserial
+}  // namespace plugin
+}  // namespace kaleidoscope
+
+// Creates a `Command` in a PROGMEM table. `name` must be a `constexpr char[]`
+// in PROGMEM, so that its hash can be computed at compile time.
+#define FOCUS_COMMAND(name, handler)                                \
+  {                                                                 \
+    kaleidoscope::plugin::focusserial::CommandHash<                 \
+      kaleidoscope::plugin::focusserial::hashCommand(name)>::value, \
+      name, handler                                                 \
+  }
@@ -0,0 +1,99 @@
+/* -*- mode: c++ -*-
+ * Kaleidoscope-FocusSerial -- Bidirectional communication plugin
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t, uint16_t
+
+#include "kaleidoscope/util/crc16.h"  // for _crc_ccitt_update
+
+namespace kaleidoscope {
+namespace plugin {
+namespace focusserial {
+
+/// A chunk of binary data, as sent over the wire by binary Focus transfers
+///
+/// On the wire, a frame is a length byte, a sequence number, that many bytes of
+/// payload, and a CRC-16 (CCITT, little endian) of all of those. The sequence
+/// number counts the frames of a transfer (wrapping around), so that a frame
+/// sent again because its acknowledgement got lost can be told apart from the
+/// next one. A frame with an empty payload marks the end of a transfer.
+struct Frame {
+  static constexpr uint8_t max_payload = 64;
+
+  uint8_t length;
+  uint8_t sequence;
+  uint8_t payload[max_payload];
+
+  uint16_t crc() const {
+    uint16_t crc = _crc_ccitt_update(0xffff, length);
+    crc          = _crc_ccitt_update(crc, sequence);
+    for (uint8_t i = 0; i < length; i++)
+      crc = _crc_ccitt_update(crc, payload[i]);
+    return crc;
+  }
+};
+
+/// Reassembles a `Frame` from the bytes that arrive, one at a time
+class FrameReader {
+ public:
+  enum class Status : uint8_t {
+    INCOMPLETE,
+    COMPLETE,
+    CORRUPT,
+  };
+
+  /// Feeds the next byte to the reader. Once it returns `COMPLETE`, `frame()`
+  /// holds a frame that passed its CRC check. Once it returns anything but
+  /// `INCOMPLETE`, the next byte starts a new frame.
+  Status consume(uint8_t byte) {
+    if (position_ == 0) {
+      frame_.length = byte;
+      if (byte > Frame::max_payload)
+        return Status::CORRUPT;
+    } else if (position_ == 1) {
+      frame_.sequence = byte;
+    } else if (position_ <= frame_.length + 1) {
+      frame_.payload[position_ - 2] = byte;
+    } else if (position_ == frame_.length + 2) {
+      crc_ = byte;
+    } else {
+      crc_ |= uint16_t(byte) << 8;
+      position_ = 0;
+      return crc_ == frame_.crc() ? Status::COMPLETE : Status::CORRUPT;
+    }
+    position_++;
+    return Status::INCOMPLETE;
+  }
+
+  void reset() {
+    position_ = 0;
+  }
+
+  const Frame &frame() const {
+    return frame_;
+  }
+
+ private:
+  Frame frame_;
+  uint16_t crc_     = 0;
+  uint8_t position_ = 0;
+};
+
+}  // namespace focusserial
+}  // namespace plugin
+}  // namespace kaleidoscope
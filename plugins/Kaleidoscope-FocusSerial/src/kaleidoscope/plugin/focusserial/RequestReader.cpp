@@ -0,0 +1,195 @@
+/* -*- mode: c++ -*-
+ * Kaleidoscope-FocusSerial -- Bidirectional communication plugin
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope/plugin/focusserial/RequestReader.h"
+
+#include <Arduino.h>  // for F, micros, millis, Stream
+#include <string.h>   // for memset
+
+#include "kaleidoscope/Runtime.h"  // for Runtime, Runtime_
+
+namespace kaleidoscope {
+namespace plugin {
+namespace focusserial {
+
+void RequestReader::process(Stream &stream, uint16_t budget_us) {
+  if (state_ == State::TRANSFER) {
+    processTransfer(stream, budget_us);
+    return;
+  }
+
+  // If there is no input, we don't have any work to do, unless a streamed
+  // request has been waiting for the rest of its line for too long.
+  if (stream.available() == 0) {
+    if (state_ == State::ARGUMENTS &&
+        Runtime.hasTimeExpired(last_input_time_, stream.getTimeout()))
+      endRequest(stream);
+    return;
+  }
+
+  // Only read as much as we can in a limited time, so that a host sending a
+  // large request can't hold up key scanning. Whatever is left gets read by
+  // the next calls.
+  last_input_time_ = Runtime.millisAtCycleStart();
+  auto start       = micros();
+  do {
+    if (state_ == State::COMMAND) {
+      readCommand(stream);
+    } else {
+      readArgument(stream);
+    }
+  } while (state_ != State::TRANSFER && stream.available() &&
+           (micros() - start) < budget_us);
+}
+
+void RequestReader::processTransfer(Stream &stream, uint16_t budget_us) {
+  auto status = transfer_.process(stream, budget_us);
+  if (status == Transfer::Status::RUNNING)
+    return;
+
+  TransferEndHandler on_end = on_transfer_end_;
+  on_transfer_end_          = nullptr;
+  if (on_end)
+    (*on_end)(status == Transfer::Status::DONE);
+  endRequest(stream);
+}
+
+void RequestReader::readCommand(Stream &stream) {
+  // If there's a newline pending, don't read it; handlers use it to tell
+  // whether there are any arguments.
+  int c = stream.peek();
+  if (c != NEWLINE && cursor_ < (sizeof(command_) - 1)) {
+    stream.read();
+    // Don't store the separator; it ends the command.
+    if (c != SEPARATOR) {
+      command_[cursor_++] = c;
+      return;
+    }
+  }
+
+  // Then process the command
+  line_consumed_ = false;
+  (*on_command_)(command_);
+  cursor_ = 0;
+  memset(command_, 0, sizeof(command_));
+
+  // The handler read its arguments already, and the transfer it started ends
+  // the request once it's over.
+  if (state_ == State::TRANSFER)
+    return;
+
+  if (on_end_) {
+    state_          = State::ARGUMENTS;
+    argument_count_ = 0;
+    argument_value_ = 0;
+    in_argument_    = false;
+    return;
+  }
+
+  // Whatever the handler didn't read of the line is ignored, as far as it has
+  // arrived. If the handler read past the end of the line (`parseInt()` skips
+  // over it), the line is over, and anything after it is the next request.
+  if (!line_consumed_) {
+    while (stream.available()) {
+      if (stream.read() == NEWLINE)
+        break;
+    }
+  }
+  endRequest(stream);
+}
+
+void RequestReader::readArgument(Stream &stream) {
+  int c = stream.read();
+  if (c >= '0' && c <= '9') {
+    argument_value_ = argument_value_ * 10 + (c - '0');
+    in_argument_    = true;
+    return;
+  }
+  endArgument();
+  if (c == NEWLINE)
+    endRequest(stream);
+}
+
+void RequestReader::endArgument() {
+  if (!in_argument_)
+    return;
+  if (on_argument_)
+    (*on_argument_)(argument_count_, argument_value_);
+  argument_count_++;
+  argument_value_ = 0;
+  in_argument_    = false;
+}
+
+void RequestReader::endRequest(Stream &stream) {
+  if (on_end_) {
+    endArgument();
+    EndOfRequestHandler on_end = on_end_;
+    on_argument_               = nullptr;
+    on_end_                    = nullptr;
+    (*on_end)(argument_count_);
+  }
+  // End of command processing is signalled with a CRLF followed by a single period
+  stream.println(F("\r\n."));
+  state_ = State::COMMAND;
+}
+
+int RequestReader::peek(Stream &stream) {
+  auto timeout = stream.getTimeout();
+  auto start   = millis();
+
+  // Duplicate some of Stream::timedPeek because it's protected
+  do {
+    int c = stream.peek();
+    if (c >= 0)
+      return c;
+  } while ((millis() - start) < timeout);
+  return -1;
+}
+
+int RequestReader::readByte(Stream &stream) {
+  int c = peek(stream);
+  if (c >= 0) {
+    stream.read();
+    if (c == NEWLINE)
+      line_consumed_ = true;
+  }
+  return c;
+}
+
+long RequestReader::parseInt(Stream &stream) {
+  // Skip what `Stream::parseInt()` would, minding the end of the line.
+  int c;
+  while ((c = peek(stream)) >= 0 && c != '-' && (c < '0' || c > '9')) {
+    stream.read();
+    if (c == NEWLINE)
+      line_consumed_ = true;
+  }
+  return c < 0 ? 0 : stream.parseInt();
+}
+
+void RequestReader::skipLine(Stream &stream) {
+  int c;
+  do {
+    c = readByte(stream);
+  } while (c >= 0 && c != NEWLINE);
+  // Even if the rest of the line never arrived, there is nothing left to skip.
+  line_consumed_ = true;
+}
+
+}  // namespace focusserial
+}  // namespace plugin
+}  // namespace kaleidoscope
@@ -0,0 +1,138 @@
+/* -*- mode: c++ -*-
+ * Kaleidoscope-FocusSerial -- Bidirectional communication plugin
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <Arduino.h>  // for Stream
+#include <stdint.h>   // for uint8_t, uint16_t, uint32_t
+
+#include "kaleidoscope/plugin/focusserial/Transfer.h"  // for Transfer
+
+namespace kaleidoscope {
+namespace plugin {
+namespace focusserial {
+
+/// Splits the Focus requests arriving on a stream into commands and arguments
+///
+/// A request is a single line: a command, optionally followed by arguments,
+/// separated by spaces. Once the command has been read, it is passed to the
+/// command handler, with the rest of the line still on the stream. The handler
+/// either reads its arguments from there itself (through `parseInt()`,
+/// `readByte()` and `skipLine()`, which note whether it read the end of the
+/// line), or calls `streamArguments()`, after which they are read over as many
+/// calls to `process()` as it takes, and passed to it one at a time. A handler
+/// can also start a binary transfer (see `Transfer`), which `process()` then
+/// carries on with until it's over. Either way, the end of the response (a CRLF and a period on a line of its own) is
+/// sent once the request is over.
+class RequestReader {
+ public:
+  static constexpr char SEPARATOR = ' ';
+  static constexpr char NEWLINE   = '\n';
+
+  typedef void (*CommandHandler)(const char *command);
+  typedef void (*ArgumentHandler)(uint16_t index, uint16_t value);
+  typedef void (*EndOfRequestHandler)(uint16_t argument_count);
+  typedef void (*TransferEndHandler)(bool success);
+
+  explicit RequestReader(CommandHandler on_command)
+    : on_command_(on_command) {}
+
+  /// Reads the input available on `stream`, for at most `budget_us`
+  /// microseconds. Without any input, it ends a streamed request once nothing
+  /// arrived for the stream's timeout.
+  void process(Stream &stream, uint16_t budget_us);
+
+  /// Called by the command handler to have the request's numeric arguments
+  /// passed to `on_argument` as they arrive, and `on_end` called with their
+  /// number once the line is over.
+  void streamArguments(ArgumentHandler on_argument, EndOfRequestHandler on_end) {
+    on_argument_ = on_argument;
+    on_end_      = on_end;
+  }
+
+  /// Called by the command handler, once it read the request line, to start
+  /// sending `size` bytes of storage from `offset`, or receiving them. When the
+  /// transfer is over, `on_end` (if any) is called with whether it succeeded.
+  void sendStorage(uint16_t offset, uint16_t size, TransferEndHandler on_end) {
+    transfer_.startSending(offset, size);
+    startTransfer(on_end);
+  }
+  void receiveStorage(uint16_t offset, uint16_t size, TransferEndHandler on_end) {
+    transfer_.startReceiving(offset, size);
+    startTransfer(on_end);
+  }
+
+  /// The next byte on `stream`, without reading it, waiting for up to the
+  /// stream's timeout for it to arrive. Returns -1 if nothing did.
+  int peek(Stream &stream);
+  /// Reads the next byte, like `peek()` does. Returns -1 if nothing arrived.
+  int readByte(Stream &stream);
+  /// Reads a number, like `Stream::parseInt()`, which skips anything before it,
+  /// including the end of the line.
+  long parseInt(Stream &stream);
+  /// Reads the rest of the request line, including its end.
+  void skipLine(Stream &stream);
+
+  /// The command being handled, while the command handler runs.
+  const char *command() const {
+    return command_;
+  }
+
+  /// Whether a request is being read.
+  bool busy() const {
+    return state_ != State::COMMAND || cursor_ != 0;
+  }
+
+ private:
+  enum class State : uint8_t {
+    COMMAND,    // reading the command
+    ARGUMENTS,  // streaming arguments to a handler
+    TRANSFER,   // carrying on with a binary transfer
+  };
+  State state_ = State::COMMAND;
+
+  CommandHandler on_command_;
+  char command_[32]  = {};
+  uint8_t cursor_    = 0;
+  // Set when the command handler read the request line up to and including
+  // its end, so that there is nothing left of it to skip.
+  bool line_consumed_ = false;
+
+  ArgumentHandler on_argument_ = nullptr;
+  EndOfRequestHandler on_end_  = nullptr;
+  uint16_t argument_count_     = 0;
+  uint16_t argument_value_     = 0;
+  bool in_argument_            = false;
+  uint32_t last_input_time_    = 0;
+
+  Transfer transfer_;
+  TransferEndHandler on_transfer_end_ = nullptr;
+
+  void startTransfer(TransferEndHandler on_end) {
+    on_transfer_end_ = on_end;
+    state_           = State::TRANSFER;
+  }
+  void processTransfer(Stream &stream, uint16_t budget_us);
+  void readCommand(Stream &stream);
+  void readArgument(Stream &stream);
+  void endArgument();
+  void endRequest(Stream &stream);
+};
+
+}  // namespace focusserial
+}  // namespace plugin
+}  // namespace kaleidoscope
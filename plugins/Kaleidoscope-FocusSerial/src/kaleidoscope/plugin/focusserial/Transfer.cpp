@@ -0,0 +1,217 @@
+/* -*- mode: c++ -*-
+ * Kaleidoscope-FocusSerial -- Bidirectional communication plugin
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope/plugin/focusserial/Transfer.h"
+
+#include <Arduino.h>  // for delayMicroseconds, micros, Stream
+
+#include "kaleidoscope/Runtime.h"        // for Runtime, Runtime_
+#include "kaleidoscope/device/device.h"  // for Base<>::Storage
+
+namespace kaleidoscope {
+namespace plugin {
+namespace focusserial {
+
+void Transfer::startSending(uint16_t offset, uint16_t size) {
+  state_           = State::SENDING;
+  status_          = Status::RUNNING;
+  offset_          = offset;
+  size_            = size;
+  pos_             = 0;
+  sequence_        = 0;
+  window_pos_      = 0;
+  window_sequence_ = 0;
+  window_frames_   = 0;
+  last_frame_sent_ = false;
+  retries_         = 0;
+}
+
+void Transfer::startReceiving(uint16_t offset, uint16_t size) {
+  state_           = State::RECEIVING;
+  status_          = Status::RUNNING;
+  offset_          = offset;
+  size_            = size;
+  pos_             = 0;
+  sequence_        = 0;
+  retries_         = 0;
+  last_input_time_ = Runtime.millisAtCycleStart();
+  reader_.reset();
+}
+
+Transfer::Status Transfer::process(Stream &stream, uint16_t budget_us) {
+  auto start = micros();
+  while (status_ == Status::RUNNING && step(stream) &&
+         (micros() - start) < budget_us) {
+  }
+  return status_;
+}
+
+// Does the next bit of work, if there is any to do yet. Returns false if there
+// isn't, because we're waiting for the host.
+bool Transfer::step(Stream &stream) {
+  switch (state_) {
+  case State::SENDING:
+    sendFrame(stream);
+    return true;
+  case State::WRITING:
+    writePayload(stream);
+    return true;
+  case State::DISCARDING:
+    return discardInput(stream);
+  default:
+    break;
+  }
+
+  if (state_ == State::RECEIVING && pos_ == size_) {
+    status_ = Status::DONE;
+    return false;
+  }
+  if (!stream.available()) {
+    if (timedOut(stream, last_input_time_))
+      status_ = Status::FAILED;
+    return false;
+  }
+  last_input_time_ = Runtime.millisAtCycleStart();
+  if (state_ == State::AWAITING) {
+    readReply(stream);
+  } else {
+    readFrame(stream);
+  }
+  return true;
+}
+
+void Transfer::sendFrame(Stream &stream) {
+  Frame frame;
+  uint16_t left   = size_ - pos_;
+  frame.length    = left < Frame::max_payload ? left : Frame::max_payload;
+  frame.sequence  = sequence_;
+  for (uint8_t i = 0; i < frame.length; i++)
+    frame.payload[i] = Runtime.storage().read(offset_ + pos_ + i);
+
+  uint16_t crc = frame.crc();
+  stream.write(frame.length);
+  stream.write(frame.sequence);
+  stream.write(frame.payload, frame.length);
+  stream.write((uint8_t)(crc & 0xff));
+  stream.write((uint8_t)(crc >> 8));
+  // Like the rest of Focus, leave the host a moment to keep up (see
+  // `FocusSerial::delayAfterPrint()`).
+  delayMicroseconds(100);
+
+  pos_ += frame.length;
+  sequence_++;
+  last_frame_sent_ = frame.length == 0;
+
+  // The host acknowledges each window of frames, or asks for it again.
+  if (++window_frames_ == window || last_frame_sent_) {
+    state_           = State::AWAITING;
+    last_input_time_ = Runtime.millisAtCycleStart();
+  }
+}
+
+void Transfer::readReply(Stream &stream) {
+  int reply = stream.read();
+  if (reply == ACK) {
+    if (last_frame_sent_) {
+      status_ = Status::DONE;
+      return;
+    }
+    window_pos_      = pos_;
+    window_sequence_ = sequence_;
+    retries_         = 0;
+  } else if (reply != NAK || ++retries_ > max_retries_) {
+    status_ = Status::FAILED;
+    return;
+  } else {
+    pos_      = window_pos_;
+    sequence_ = window_sequence_;
+  }
+  window_frames_ = 0;
+  state_         = State::SENDING;
+}
+
+void Transfer::readFrame(Stream &stream) {
+  auto status = reader_.consume(stream.read());
+  if (status == FrameReader::Status::INCOMPLETE)
+    return;
+
+  const Frame &frame = reader_.frame();
+  // An empty frame ends a transfer, which this one isn't yet: it can't be
+  // acknowledged without moving on to the next sequence number.
+  if (status == FrameReader::Status::COMPLETE &&
+      frame.sequence == sequence_ &&
+      frame.length != 0 && frame.length <= size_ - pos_) {
+    written_ = 0;
+    state_   = State::WRITING;
+  } else if (status == FrameReader::Status::COMPLETE &&
+             pos_ != 0 && frame.sequence == uint8_t(sequence_ - 1)) {
+    // The host sent the previous frame again, because our ACK got lost: it
+    // has been written already, so only acknowledge it again.
+    stream.write(ACK);
+  } else if (++retries_ > max_retries_) {
+    status_ = Status::FAILED;
+  } else {
+    // Whatever is left of the corrupt frame has to go, so that the one sent
+    // again can be told apart from it.
+    discard_start_time_ = Runtime.millisAtCycleStart();
+    state_              = State::DISCARDING;
+  }
+}
+
+// Writing to storage can be slow (a few milliseconds per byte, on AVR), so the
+// payload is written one byte per step.
+void Transfer::writePayload(Stream &stream) {
+  const Frame &frame = reader_.frame();
+  Runtime.storage().update(offset_ + pos_ + written_, frame.payload[written_]);
+  if (++written_ < frame.length)
+    return;
+
+  pos_ += frame.length;
+  sequence_++;
+  retries_ = 0;
+  stream.write(ACK);
+  last_input_time_ = Runtime.millisAtCycleStart();
+  state_           = State::RECEIVING;
+}
+
+bool Transfer::discardInput(Stream &stream) {
+  // Once the line has been quiet for a while, the host is waiting for our NAK.
+  // A host that never stops sending can't keep us here for longer than the
+  // stream's timeout either.
+  if (timedOut(stream, discard_start_time_) ||
+      (!stream.available() &&
+       Runtime.hasTimeExpired(last_input_time_, quiet_time_ms_))) {
+    reader_.reset();
+    stream.write(NAK);
+    last_input_time_ = Runtime.millisAtCycleStart();
+    state_           = State::RECEIVING;
+    return true;
+  }
+  if (!stream.available())
+    return false;
+  stream.read();
+  last_input_time_ = Runtime.millisAtCycleStart();
+  return true;
+}
+
+bool Transfer::timedOut(Stream &stream, uint32_t since) {
+  return Runtime.hasTimeExpired(since, stream.getTimeout());
+}
+
+}  // namespace focusserial
+}  // namespace plugin
+}  // namespace kaleidoscope
@@ -0,0 +1,109 @@
+/* -*- mode: c++ -*-
+ * Kaleidoscope-FocusSerial -- Bidirectional communication plugin
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <Arduino.h>  // for Stream
+#include <stdint.h>   // for uint8_t, uint16_t, uint32_t
+
+#include "kaleidoscope/plugin/focusserial/Frame.h"  // for Frame, FrameReader
+
+namespace kaleidoscope {
+namespace plugin {
+namespace focusserial {
+
+/// A binary transfer of a range of storage, in frames (see `Frame`)
+///
+/// Once started, `process()` carries the transfer on for a limited time, and
+/// returns, so that it can run over as many cycles as it takes instead of
+/// holding up everything else until it's over. It sends frames, reads the
+/// bytes that arrived, and writes what they carry to storage, one step at a
+/// time, and waits for the host without blocking.
+class Transfer {
+ public:
+  /// Sent to accept (or reject) a frame, a window of frames, or a request.
+  static constexpr uint8_t ACK = 0x06;
+  static constexpr uint8_t NAK = 0x15;
+
+  /// The number of frames sent before waiting for the host to acknowledge them.
+  static constexpr uint8_t window = 4;
+
+  enum class Status : uint8_t {
+    RUNNING,
+    DONE,
+    FAILED,
+  };
+
+  /// Sends the `size` bytes of storage starting at `offset`.
+  void startSending(uint16_t offset, uint16_t size);
+  /// Writes the `size` bytes the host sends to storage, starting at `offset`,
+  /// without committing them.
+  void startReceiving(uint16_t offset, uint16_t size);
+
+  /// Carries the transfer on, for at most about `budget_us` microseconds.
+  Status process(Stream &stream, uint16_t budget_us);
+
+ private:
+  enum class State : uint8_t {
+    SENDING,     // sending the frames of a window
+    AWAITING,    // waiting for the host to acknowledge a window
+    RECEIVING,   // reading a frame
+    WRITING,     // writing a frame's payload to storage
+    DISCARDING,  // dropping the rest of a corrupt frame
+  };
+
+  // The number of times a window or a frame is sent again after a NAK before
+  // the transfer is given up on.
+  static constexpr uint8_t max_retries_ = 3;
+  // How long the line has to be quiet after a corrupt frame before the next
+  // one is expected (waiting for no longer than the stream's timeout).
+  static constexpr uint8_t quiet_time_ms_ = 10;
+
+  State state_;
+  Status status_;
+  uint16_t offset_;
+  uint16_t size_;
+  // How much of the range has been sent (or received) so far, and the
+  // sequence number of the next frame.
+  uint16_t pos_;
+  uint8_t sequence_;
+  // Where the window being sent starts, and how many frames of it went out.
+  uint16_t window_pos_;
+  uint8_t window_sequence_;
+  uint8_t window_frames_;
+  // Set once the empty frame that ends the data went out.
+  bool last_frame_sent_;
+  // How much of the payload of the frame being written is in storage.
+  uint8_t written_;
+  uint8_t retries_;
+  // When the host was last heard from, and when we started discarding.
+  uint32_t last_input_time_;
+  uint32_t discard_start_time_;
+  FrameReader reader_;
+
+  bool step(Stream &stream);
+  void sendFrame(Stream &stream);
+  void readReply(Stream &stream);
+  void readFrame(Stream &stream);
+  void writePayload(Stream &stream);
+  bool discardInput(Stream &stream);
+  bool timedOut(Stream &stream, uint32_t since);
+};
+
+}  // namespace focusserial
+}  // namespace plugin
+}  // namespace kaleidoscope
@@ -82,6 +82,12 @@ EventHandlerResult GhostInTheFirmware::afterEachCycle() {
   return EventHandlerResult::OK;
 }
 
+EventHandlerResult GhostInTheFirmware::beforeSleeping() {
+  if (is_active_)
+    return EventHandlerResult::ABORT;
+  return EventHandlerResult::OK;
+}
+
 }  // namespace plugin
 }  // namespace kaleidoscope
 
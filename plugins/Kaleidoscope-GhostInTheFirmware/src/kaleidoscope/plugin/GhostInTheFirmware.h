@@ -37,6 +37,7 @@ class GhostInTheFirmware : public kaleidoscope::Plugin {
   void activate();
 
   EventHandlerResult afterEachCycle();
+  EventHandlerResult beforeSleeping();
 
  private:
   bool is_active_       = false;
@@ -26,6 +26,7 @@
 #include "kaleidoscope/Runtime.h"
 #include "kaleidoscope/driver/color/GammaCorrection.h"
 #include "kaleidoscope/driver/keyscanner/Base_Impl.h"
+#include "kaleidoscope/keyswitch_state.h"
 #include "kaleidoscope/util/crc16.h"
 
 #define I2C_CLOCK_KHZ       100
@@ -137,8 +138,8 @@ void RaiseHands::initializeSides() {
 /********* LED Driver *********/
 
 bool RaiseLEDDriver::isLEDChangedNeuron;
-uint8_t RaiseLEDDriver::isLEDChangedLeft[LED_BANKS];
-uint8_t RaiseLEDDriver::isLEDChangedRight[LED_BANKS];
+driver::led::DirtyBanks<LED_BANKS> RaiseLEDDriver::changedBanksLeft;
+driver::led::DirtyBanks<LED_BANKS> RaiseLEDDriver::changedBanksRight;
 cRGB RaiseLEDDriver::neuronLED;
 constexpr uint8_t RaiseLEDDriver::led_map[][RaiseLEDDriverProps::led_count + 1];
 
@@ -147,10 +148,8 @@ constexpr uint8_t RaiseLEDDriverProps::key_led_map[];
 void RaiseLEDDriver::setBrightness(uint8_t brightness) {
   RaiseHands::leftHand.setBrightness(brightness);
   RaiseHands::rightHand.setBrightness(brightness);
-  for (uint8_t i = 0; i < LED_BANKS; i++) {
-    isLEDChangedLeft[i]  = true;
-    isLEDChangedRight[i] = true;
-  }
+  changedBanksLeft.markAll();
+  changedBanksRight.markAll();
 }
 
 uint8_t RaiseLEDDriver::getBrightness() {
@@ -161,13 +160,13 @@ void RaiseLEDDriver::syncLeds() {
   // left and right sides
   for (uint8_t i = 0; i < LED_BANKS; i++) {
     // only send the banks that have changed - try to improve jitter performance
-    if (isLEDChangedLeft[i]) {
+    if (changedBanksLeft.isDirty(i)) {
       RaiseHands::leftHand.sendLEDBank(i);
-      isLEDChangedLeft[i] = false;
+      changedBanksLeft.clear(i);
     }
-    if (isLEDChangedRight[i]) {
+    if (changedBanksRight.isDirty(i)) {
       RaiseHands::rightHand.sendLEDBank(i);
-      isLEDChangedRight[i] = false;
+      changedBanksRight.clear(i);
     }
   }
 
@@ -209,16 +208,11 @@ void RaiseLEDDriver::setCrgbAt(uint8_t i, cRGB crgb) {
   if (sled_num < LEDS_PER_HAND) {
     cRGB oldColor                                = RaiseHands::leftHand.led_data.leds[sled_num];
     RaiseHands::leftHand.led_data.leds[sled_num] = crgb;
-    isLEDChangedLeft[uint8_t(sled_num / 8)] |= !(oldColor.r == crgb.r &&
-                                                 oldColor.g == crgb.g &&
-                                                 oldColor.b == crgb.b);
+    changedBanksLeft.update(sled_num / LEDS_PER_BANK, oldColor, crgb);
   } else if (sled_num < 2 * LEDS_PER_HAND) {
     cRGB oldColor                                                 = RaiseHands::rightHand.led_data.leds[sled_num - LEDS_PER_HAND];
     RaiseHands::rightHand.led_data.leds[sled_num - LEDS_PER_HAND] = crgb;
-    isLEDChangedRight[uint8_t((sled_num - LEDS_PER_HAND) / 8)] |=
-      !(oldColor.r == crgb.r &&
-        oldColor.g == crgb.g &&
-        oldColor.b == crgb.b);
+    changedBanksRight.update((sled_num - LEDS_PER_HAND) / LEDS_PER_BANK, oldColor, crgb);
   } else {
     // TODO(anyone):
     // how do we want to handle debugging assertions about crazy user
@@ -262,6 +256,8 @@ raise::keydata_t RaiseKeyScanner::leftHandState;
 raise::keydata_t RaiseKeyScanner::rightHandState;
 raise::keydata_t RaiseKeyScanner::previousLeftHandState;
 raise::keydata_t RaiseKeyScanner::previousRightHandState;
+RaiseKeyScannerProps::DebouncePolicy<uint64_t> RaiseKeyScanner::leftHandDebouncer;
+RaiseKeyScannerProps::DebouncePolicy<uint64_t> RaiseKeyScanner::rightHandDebouncer;
 bool RaiseKeyScanner::lastLeftOnline;
 bool RaiseKeyScanner::lastRightOnline;
 
@@ -270,7 +266,8 @@ void RaiseKeyScanner::readMatrix() {
   previousRightHandState = rightHandState;
 
   if (RaiseHands::leftHand.readKeys()) {
-    leftHandState = RaiseHands::leftHand.getKeyData();
+    leftHandDebouncer.debounce(RaiseHands::leftHand.getKeyData().all);
+    leftHandState.all = leftHandDebouncer.state();
     // if ANSI, then swap r3c0 and r3c1 to match the PCB
     if (RaiseHands::layout == LAYOUT_ANSI) {
       // only swap if bits are different
@@ -282,7 +279,8 @@ void RaiseKeyScanner::readMatrix() {
   }
 
   if (RaiseHands::rightHand.readKeys()) {
-    rightHandState = RaiseHands::rightHand.getKeyData();
+    rightHandDebouncer.debounce(RaiseHands::rightHand.getKeyData().all);
+    rightHandState.all = rightHandDebouncer.state();
     // if ANSI, then swap r1c0 and r2c0 to match the PCB
     if (RaiseHands::layout == LAYOUT_ANSI) {
       if ((rightHandState.rows[1] & (1 << 0)) ^ rightHandState.rows[2] & (1 << 0)) {
@@ -298,11 +296,15 @@ void RaiseKeyScanner::readMatrix() {
     RaiseHands::initializeSides();
 
   // if a side has just been unplugged, wipe its state
-  if (!RaiseHands::leftHand.online && lastLeftOnline)
+  if (!RaiseHands::leftHand.online && lastLeftOnline) {
     leftHandState.all = 0;
+    leftHandDebouncer = Props_::DebouncePolicy<uint64_t>();
+  }
 
-  if (!RaiseHands::rightHand.online && lastRightOnline)
+  if (!RaiseHands::rightHand.online && lastRightOnline) {
     rightHandState.all = 0;
+    rightHandDebouncer = Props_::DebouncePolicy<uint64_t>();
+  }
 
   // store previous state of whether the sides are plugged in
   lastLeftOnline  = RaiseHands::leftHand.online;
@@ -310,22 +312,21 @@ void RaiseKeyScanner::readMatrix() {
 }
 
 void RaiseKeyScanner::actOnMatrixScan() {
+  // Each side packs a row into a byte (`left_columns` is 8), and only
+  // keyswitches that toggled on or off produce events.
   for (uint8_t row = 0; row < Props_::matrix_rows; row++) {
-    for (uint8_t col = 0; col < Props_::left_columns; col++) {
-      uint8_t keynum = (row * Props_::left_columns) + col;
-      uint8_t keyState;
-
-      // left
-      keyState = (bitRead(previousLeftHandState.all, keynum) << 0) |
-                 (bitRead(leftHandState.all, keynum) << 1);
-      if (keyState)
-        ThisType::handleKeyswitchEvent(Key_NoKey, KeyAddr(row, col), keyState);
-
-      // right
-      keyState = (bitRead(previousRightHandState.all, keynum) << 0) |
-                 (bitRead(rightHandState.all, keynum) << 1);
-      if (keyState)
-        ThisType::handleKeyswitchEvent(Key_NoKey, KeyAddr(row, (Props_::matrix_columns - 1) - col), keyState);
+    // left
+    for (uint8_t col : driver::keyscanner::ChangedBits<uint8_t>(previousLeftHandState.rows[row],
+                                                                leftHandState.rows[row])) {
+      uint8_t keyState = bitRead(leftHandState.rows[row], col) ? IS_PRESSED : WAS_PRESSED;
+      ThisType::handleKeyswitchEvent(Key_NoKey, KeyAddr(row, col), keyState);
+    }
+
+    // right
+    for (uint8_t col : driver::keyscanner::ChangedBits<uint8_t>(previousRightHandState.rows[row],
+                                                                rightHandState.rows[row])) {
+      uint8_t keyState = bitRead(rightHandState.rows[row], col) ? IS_PRESSED : WAS_PRESSED;
+      ThisType::handleKeyswitchEvent(Key_NoKey, KeyAddr(row, (Props_::matrix_columns - 1) - col), keyState);
     }
   }
 }
@@ -33,6 +33,7 @@
 #include "kaleidoscope/driver/hid/Keyboardio.h"
 #include "kaleidoscope/driver/keyscanner/Base.h"
 #include "kaleidoscope/driver/led/Base.h"
+#include "kaleidoscope/driver/led/DirtyBanks.h"
 #include "kaleidoscope/driver/storage/Flash.h"
 #include "kaleidoscope/util/flasher/KeyboardioI2CBootloader.h"
 
@@ -73,8 +74,8 @@ class RaiseLEDDriver : public kaleidoscope::driver::led::Base<RaiseLEDDriverProp
 
  private:
   static bool isLEDChangedNeuron;
-  static uint8_t isLEDChangedLeft[LED_BANKS];
-  static uint8_t isLEDChangedRight[LED_BANKS];
+  static driver::led::DirtyBanks<LED_BANKS> changedBanksLeft;
+  static driver::led::DirtyBanks<LED_BANKS> changedBanksRight;
   static cRGB neuronLED;
 
   static constexpr uint8_t lph = LEDS_PER_HAND;
@@ -124,6 +125,12 @@ struct RaiseKeyScannerProps : public kaleidoscope::driver::keyscanner::BaseProps
 
   static constexpr uint8_t left_columns  = 8;
   static constexpr uint8_t right_columns = matrix_columns - left_columns;
+
+  // The controllers in the halves of the keyboard debounce the keyswitches
+  // themselves, so by default, their reports are used as-is. The state of each
+  // half is debounced as a single 64-bit row.
+  template<typename _RowState>
+  using DebouncePolicy = kaleidoscope::driver::keyscanner::debounce::None<_RowState>;
 };
 
 class RaiseKeyScanner : public kaleidoscope::driver::keyscanner::Base<RaiseKeyScannerProps> {
@@ -152,6 +159,8 @@ class RaiseKeyScanner : public kaleidoscope::driver::keyscanner::Base<RaiseKeySc
   static raise::keydata_t rightHandState;
   static raise::keydata_t previousLeftHandState;
   static raise::keydata_t previousRightHandState;
+  static Props_::DebouncePolicy<uint64_t> leftHandDebouncer;
+  static Props_::DebouncePolicy<uint64_t> rightHandDebouncer;
 
   static bool lastLeftOnline;
   static bool lastRightOnline;
@@ -32,6 +32,7 @@
 #include "kaleidoscope/KeyEvent.h"
 #include "kaleidoscope/Runtime.h"
 #include "kaleidoscope/device/ez/ErgoDox/ErgoDoxScanner.h"
+#include "kaleidoscope/driver/keyscanner/Base.h"
 #include "kaleidoscope/keyswitch_state.h"
 
 namespace kaleidoscope {
@@ -107,13 +108,11 @@ void __attribute__((optimize(3))) ErgoDox::readMatrix() {
 
 void __attribute__((optimize(3))) ErgoDox::actOnMatrixScan() {
   for (uint8_t row = 0; row < matrix_rows; row++) {
-    for (uint8_t col = 0; col < matrix_columns; col++) {
-      uint8_t key_state = (bitRead(previousKeyState_[row], col) << 0) |
-                          (bitRead(keyState_[row], col) << 1);
-      if (keyToggledOn(key_state) || keyToggledOff(key_state)) {
-        auto event = KeyEvent::next(KeyAddr(row, col), key_state);
-        kaleidoscope::Runtime.handleKeyswitchEvent(event);
-      }
+    // Only keyswitches that toggled on or off produce events.
+    for (uint8_t col : driver::keyscanner::ChangedBits<uint8_t>(previousKeyState_[row], keyState_[row])) {
+      uint8_t key_state = bitRead(keyState_[row], col) ? IS_PRESSED : WAS_PRESSED;
+      auto event        = KeyEvent::next(KeyAddr(row, col), key_state);
+      kaleidoscope::Runtime.handleKeyswitchEvent(event);
     }
     previousKeyState_[row] = keyState_[row];
   }
@@ -38,6 +38,7 @@ struct AtreusProps : kaleidoscope::device::ATmega32U4KeyboardProps {
     static constexpr uint8_t matrix_rows    = 4;
     static constexpr uint8_t matrix_columns = 12;
     typedef MatrixAddr<matrix_rows, matrix_columns> KeyAddr;
+    static const bool keyscan_wakeup = true;
 #ifndef KALEIDOSCOPE_VIRTUAL_BUILD
     static constexpr uint8_t matrix_row_pins[matrix_rows]    = {PIN_F6, PIN_F5, PIN_F4, PIN_F1};
     static constexpr uint8_t matrix_col_pins[matrix_columns] = {PIN_F7, PIN_E2, PIN_C7, PIN_C6, PIN_B6, PIN_B5, PIN_D7, PIN_D6, PIN_D4, PIN_D5, PIN_D3, PIN_D2};
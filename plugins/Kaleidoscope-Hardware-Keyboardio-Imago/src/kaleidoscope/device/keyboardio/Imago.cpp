@@ -59,6 +59,9 @@ static constexpr uint8_t LED_REGISTER_DATA1_SIZE = 0xAB;
 
 static constexpr uint8_t LED_REGISTER_DATA_LARGEST = LED_REGISTER_DATA0_SIZE;
 
+// The number of LEDs whose data goes in the first LED data register page.
+static constexpr uint8_t LED_REGISTER_DATA0_LEDS = LED_REGISTER_DATA0_SIZE / 3;
+
 // `KeyScannerProps` here refers to the alias set up above. We do not need to
 // prefix the `matrix_rows` and `matrix_columns` names within the array
 // declaration, because those are resolved within the context of the class, so
@@ -86,7 +89,7 @@ ISR(TIMER1_OVF_vect) {
   Runtime.device().keyScanner().do_scan_ = true;
 }
 
-bool ImagoLEDDriver::isLEDChanged = true;
+driver::led::DirtyBanks<2> ImagoLEDDriver::changedBanks;
 cRGB ImagoLEDDriver::led_data[];
 uint8_t ImagoLEDDriver::brightness_adjustment_;
 
@@ -117,8 +120,7 @@ void ImagoLEDDriver::setCrgbAt(uint8_t i, cRGB crgb) {
   if (!Runtime.device().LEDs().isValid(i))
     return;
 
-  cRGB oldColor = getCrgbAt(i);
-  isLEDChanged |= !(oldColor.r == crgb.r && oldColor.g == crgb.g && oldColor.b == crgb.b);
+  changedBanks.update(i < LED_REGISTER_DATA0_LEDS ? 0 : 1, getCrgbAt(i), crgb);
 
   led_data[i] = crgb;
 }
@@ -140,46 +142,47 @@ uint8_t ImagoLEDDriver::adjustBrightness(uint8_t value) {
 }
 
 void ImagoLEDDriver::syncLeds() {
-  //  if (!isLEDChanged)
-  //   return;
-
   uint8_t data[LED_REGISTER_DATA_LARGEST + 1];
-  data[0]          = 0;  // the address of the first byte to copy in
-  uint8_t last_led = 0;
-
-  // Write the first LED bank
-  selectRegister(LED_REGISTER_DATA0);
-
-  for (auto i = 1; i < LED_REGISTER_DATA0_SIZE; i += 3) {
-    data[i]     = adjustBrightness(led_data[last_led].b);
-    data[i + 1] = adjustBrightness(led_data[last_led].g);
-    data[i + 2] = adjustBrightness(led_data[last_led].r);
-    last_led++;
+  data[0] = 0;  // the address of the first byte to copy in
+
+  // Write the first LED bank, if any of its LEDs changed
+  if (changedBanks.isDirty(0)) {
+    selectRegister(LED_REGISTER_DATA0);
+
+    uint8_t last_led = 0;
+    for (auto i = 1; i < LED_REGISTER_DATA0_SIZE; i += 3) {
+      data[i]     = adjustBrightness(led_data[last_led].b);
+      data[i + 1] = adjustBrightness(led_data[last_led].g);
+      data[i + 2] = adjustBrightness(led_data[last_led].r);
+      last_led++;
+    }
+
+    twi_writeTo(LED_DRIVER_ADDR, data, LED_REGISTER_DATA0_SIZE + 1, 1, 0);
+    changedBanks.clear(0);
   }
 
-  twi_writeTo(LED_DRIVER_ADDR, data, LED_REGISTER_DATA0_SIZE + 1, 1, 0);
-
-  // Don't reset "Last LED", because this is just us picking up from the last bank
   // TODO(anyone) - we don't use all 117 LEDs on the Imago, so we can probably stop writing earlier
-  // Write the second LED bank
+  // Write the second LED bank, if any of its LEDs changed
 
   // For space efficiency, we reuse the LED sending buffer
   // The twi library should never send more than the number of elements
   // we say to send it.
   // The page 2 version has 180 elements. The page 3 version has only 171.
-
-  selectRegister(LED_REGISTER_DATA1);
-
-  for (auto i = 1; i < LED_REGISTER_DATA1_SIZE; i += 3) {
-    data[i]     = adjustBrightness(led_data[last_led].b);
-    data[i + 1] = adjustBrightness(led_data[last_led].g);
-    data[i + 2] = adjustBrightness(led_data[last_led].r);
-    last_led++;
+  if (changedBanks.isDirty(1)) {
+    selectRegister(LED_REGISTER_DATA1);
+
+    // This bank picks up where the first one left off
+    uint8_t last_led = LED_REGISTER_DATA0_LEDS;
+    for (auto i = 1; i < LED_REGISTER_DATA1_SIZE; i += 3) {
+      data[i]     = adjustBrightness(led_data[last_led].b);
+      data[i + 1] = adjustBrightness(led_data[last_led].g);
+      data[i + 2] = adjustBrightness(led_data[last_led].r);
+      last_led++;
+    }
+
+    twi_writeTo(LED_DRIVER_ADDR, data, LED_REGISTER_DATA1_SIZE + 1, 1, 0);
+    changedBanks.clear(1);
   }
-
-  twi_writeTo(LED_DRIVER_ADDR, data, LED_REGISTER_DATA1_SIZE + 1, 1, 0);
-
-  isLEDChanged = false;
 }
 
 
@@ -36,6 +36,7 @@ struct cRGB {
 #include "kaleidoscope/driver/bootloader/avr/Caterina.h"
 #include "kaleidoscope/driver/keyscanner/ATmega.h"
 #include "kaleidoscope/driver/led/Base.h"
+#include "kaleidoscope/driver/led/DirtyBanks.h"
 
 namespace kaleidoscope {
 namespace device {
@@ -65,7 +66,7 @@ class ImagoLEDDriver : public kaleidoscope::driver::led::Base<ImagoLEDDriverProp
   static cRGB getCrgbAt(uint8_t i);
   static void setBrightness(uint8_t brightness) {
     brightness_adjustment_ = 255 - brightness;
-    isLEDChanged           = true;
+    changedBanks.markAll();
   }
   static uint8_t getBrightness() {
     return 255 - brightness_adjustment_;
@@ -76,7 +77,9 @@ class ImagoLEDDriver : public kaleidoscope::driver::led::Base<ImagoLEDDriverProp
 
  private:
   static uint8_t brightness_adjustment_;
-  static bool isLEDChanged;
+  // The LED data is written in two banks, one per register page of the LED
+  // driver chip; these are the ones that need to be written on the next sync.
+  static driver::led::DirtyBanks<2> changedBanks;
 
   static uint8_t adjustBrightness(uint8_t value);
   static void selectRegister(uint8_t);
@@ -49,12 +49,19 @@ constexpr uint8_t Model01LEDDriverProps::key_led_map[] PROGMEM;
 struct Model01Hands {
   static driver::keyboardio::Model01Side leftHand;
   static driver::keyboardio::Model01Side rightHand;
+  static driver::keyboardio::I2CQueue i2c;
+
+  // The number of LED banks sent per cycle, one for each half. Since the TWI
+  // driver sends them in the background, a bank that is still being sent
+  // when the next one is due will push that one to the next cycle.
+  static constexpr uint8_t led_banks_per_cycle = 2;
 
   static void setup();
 };
 
 driver::keyboardio::Model01Side Model01Hands::leftHand(0);
 driver::keyboardio::Model01Side Model01Hands::rightHand(3);
+driver::keyboardio::I2CQueue Model01Hands::i2c;
 
 void Model01Hands::setup() {
   // This lets the keyboard pull up to 1.6 amps from the host.
@@ -68,12 +75,14 @@ void Model01Hands::setup() {
 }
 
 /********* LED Driver *********/
-bool Model01LEDDriver::isLEDChanged = true;
+driver::led::DirtyBanks<LED_BANKS> Model01LEDDriver::changedBanksLeft;
+driver::led::DirtyBanks<LED_BANKS> Model01LEDDriver::changedBanksRight;
 
 void Model01LEDDriver::setBrightness(uint8_t brightness) {
   Model01Hands::leftHand.setBrightness(brightness);
   Model01Hands::rightHand.setBrightness(brightness);
-  isLEDChanged = true;
+  changedBanksLeft.markAll();
+  changedBanksRight.markAll();
 }
 
 uint8_t Model01LEDDriver::getBrightness() {
@@ -81,14 +90,14 @@ uint8_t Model01LEDDriver::getBrightness() {
 }
 
 void Model01LEDDriver::setCrgbAt(uint8_t i, cRGB crgb) {
+  static constexpr uint8_t leds_per_bank = LEDS_PER_HAND / LED_BANKS;
+
   if (i < 32) {
-    cRGB oldColor = getCrgbAt(i);
-    isLEDChanged |= !(oldColor.r == crgb.r && oldColor.g == crgb.g && oldColor.b == crgb.b);
+    changedBanksLeft.update(i / leds_per_bank, getCrgbAt(i), crgb);
 
     Model01Hands::leftHand.ledData.leds[i] = crgb;
   } else if (i < 64) {
-    cRGB oldColor = getCrgbAt(i);
-    isLEDChanged |= !(oldColor.r == crgb.r && oldColor.g == crgb.g && oldColor.b == crgb.b);
+    changedBanksRight.update((i - 32) / leds_per_bank, getCrgbAt(i), crgb);
 
     Model01Hands::rightHand.ledData.leds[i - 32] = crgb;
   } else {
@@ -110,28 +119,22 @@ cRGB Model01LEDDriver::getCrgbAt(uint8_t i) {
 }
 
 void Model01LEDDriver::syncLeds() {
-  if (!isLEDChanged)
-    return;
-
-  // LED Data is stored in four "banks" for each side
-  // We send it all at once to make it look nicer.
-  // We alternate left and right hands because otherwise
-  // we run into a race condition with updating the next bank
-  // on an ATTiny before it's done writing the previous one to memory
-
-  Model01Hands::leftHand.sendLEDData();
-  Model01Hands::rightHand.sendLEDData();
-
-  Model01Hands::leftHand.sendLEDData();
-  Model01Hands::rightHand.sendLEDData();
-
-  Model01Hands::leftHand.sendLEDData();
-  Model01Hands::rightHand.sendLEDData();
-
-  Model01Hands::leftHand.sendLEDData();
-  Model01Hands::rightHand.sendLEDData();
+  // LED Data is stored in four "banks" for each side, and only the banks that
+  // changed are sent. They are queued up here, and sent a couple at a time,
+  // interleaved with keyscans, so an update doesn't hold up a scan cycle. We
+  // alternate left and right hands because otherwise we run into a race
+  // condition with updating the next bank on an ATTiny before it's done
+  // writing the previous one to memory.
+  for (uint8_t bank = 0; bank < LED_BANKS; bank++) {
+    if (changedBanksLeft.isDirty(bank) &&
+        Model01Hands::leftHand.requestLEDBank(Model01Hands::i2c, bank))
+      changedBanksLeft.clear(bank);
+    if (changedBanksRight.isDirty(bank) &&
+        Model01Hands::rightHand.requestLEDBank(Model01Hands::i2c, bank))
+      changedBanksRight.clear(bank);
+  }
 
-  isLEDChanged = false;
+  Model01Hands::i2c.run(Model01Hands::led_banks_per_cycle);
 }
 
 bool Model01LEDDriver::ledPowerFault() {
@@ -166,28 +169,26 @@ void Model01KeyScanner::readMatrix() {
   previousLeftHandState  = leftHandState;
   previousRightHandState = rightHandState;
 
-  if (Model01Hands::leftHand.readKeys()) {
+  // The keyscan reads go first, then any LED banks still waiting to be sent.
+  Model01Hands::leftHand.requestKeys(Model01Hands::i2c);
+  Model01Hands::rightHand.requestKeys(Model01Hands::i2c);
+  Model01Hands::i2c.run(Model01Hands::led_banks_per_cycle);
+
+  if (Model01Hands::leftHand.keyDataUpdated()) {
     leftHandState = Model01Hands::leftHand.getKeyData();
   }
 
-  if (Model01Hands::rightHand.readKeys()) {
+  if (Model01Hands::rightHand.keyDataUpdated()) {
     rightHandState = Model01Hands::rightHand.getKeyData();
   }
 }
 
 void Model01KeyScanner::actOnHalfRow(uint8_t row, uint8_t colState, uint8_t colPrevState, uint8_t startPos) {
-  if ((colState != colPrevState) || (colState != 0)) {
-    for (uint8_t col = 0; col < 8; col++) {
-      // Build up the key state for row, col
-      uint8_t keyState = ((bitRead(colPrevState, 0) << 0) |
-                          (bitRead(colState, 0) << 1));
-      if (keyState)
-        ThisType::handleKeyswitchEvent(Key_NoKey, KeyAddr(row, startPos - col), keyState);
-
-      // Throw away the data we've just used, so we can read the next column
-      colState     = colState >> 1;
-      colPrevState = colPrevState >> 1;
-    }
+  // Only keyswitches that toggled on or off produce events; held keys don't
+  // cost anything here.
+  for (uint8_t col : driver::keyscanner::ChangedBits<uint8_t>(colPrevState, colState)) {
+    uint8_t keyState = bitRead(colState, col) ? IS_PRESSED : WAS_PRESSED;
+    ThisType::handleKeyswitchEvent(Key_NoKey, KeyAddr(row, startPos - col), keyState);
   }
 }
 
@@ -49,6 +49,7 @@ struct cRGB {
 #include "kaleidoscope/driver/keyboardio/Model01Side.h"  // for keydata_t
 #include "kaleidoscope/driver/keyscanner/Base.h"         // for BaseProps
 #include "kaleidoscope/driver/led/Base.h"                // for BaseProps
+#include "kaleidoscope/driver/led/DirtyBanks.h"          // for DirtyBanks
 
 namespace kaleidoscope {
 namespace device {
@@ -79,7 +80,9 @@ class Model01LEDDriver : public kaleidoscope::driver::led::Base<Model01LEDDriver
   static bool ledPowerFault();
 
  private:
-  static bool isLEDChanged;
+  // The banks of each half that need to be sent on the next sync.
+  static driver::led::DirtyBanks<LED_BANKS> changedBanksLeft;
+  static driver::led::DirtyBanks<LED_BANKS> changedBanksRight;
 };
 #else   // ifndef KALEIDOSCOPE_VIRTUAL_BUILD
 class Model01LEDDriver;
@@ -397,6 +397,16 @@ void twi_releaseBus(void) {
   twi_state = TWI_READY;
 }
 
+/*
+ * Function twi_busy
+ * Desc     tells whether a transfer started earlier is still in progress
+ * Input    none
+ * Output   1 .. busy, 0 .. ready
+ */
+uint8_t twi_busy(void) {
+  return TWI_READY != twi_state;
+}
+
 ISR(TWI_vect) {
   switch (TW_STATUS) {
   // All Master
@@ -52,6 +52,7 @@ void twi_attachSlaveTxEvent(void (*)(void));
 void twi_reply(uint8_t);
 void twi_stop(void);
 void twi_releaseBus(void);
+uint8_t twi_busy(void);
 
 #endif  // ifndef KALEIDOSCOPE_VIRTUAL_BUILD
 #endif
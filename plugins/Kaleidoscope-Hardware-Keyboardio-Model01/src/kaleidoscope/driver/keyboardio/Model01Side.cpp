@@ -44,6 +44,18 @@ namespace keyboardio {
 
 uint8_t twi_uninitialized = 1;
 
+bool TwiBackend::busy() {
+  return twi_busy();
+}
+
+uint8_t TwiBackend::write(uint8_t address, const uint8_t *data, uint8_t length) {
+  return twi_writeTo(address, const_cast<uint8_t *>(data), length, 0, 1);
+}
+
+uint8_t TwiBackend::read(uint8_t address, uint8_t *data, uint8_t length) {
+  return twi_readFrom(address, data, length, true);
+}
+
 Model01Side::Model01Side(uint8_t setAd01) {
   ad01 = setAd01;
   addr = SCANNER_I2C_ADDR_BASE | ad01;
@@ -136,54 +148,63 @@ int Model01Side::readRegister(uint8_t cmd) {
 }
 
 
-// gives information on the key that was just pressed or released.
-bool Model01Side::readKeys() {
+// Queues a read of the state of the keys; `keyDataUpdated()` tells when it
+// arrived.
+void Model01Side::requestKeys(I2CQueue &queue) {
+  queue.submit(i2c::Request{
+    (uint8_t)addr, 5, i2c::Request::READ | i2c::Request::HIGH_PRIORITY, 0,
+    this, nullptr, &onKeysRead});
+}
 
-  uint8_t rxBuffer[5];
+void Model01Side::onKeysRead(const i2c::Request &request, uint8_t status,
+                             const uint8_t *data, uint8_t length) {
+  Model01Side *side = static_cast<Model01Side *>(request.context);
+  if (status != 0 || data[0] != TWI_REPLY_KEYDATA)
+    return;
 
-  // perform blocking read into buffer
-  uint8_t read = twi_readFrom(addr, rxBuffer, ELEMENTS(rxBuffer), true);
-  if (rxBuffer[0] == TWI_REPLY_KEYDATA) {
-    keyData.rows[0] = rxBuffer[1];
-    keyData.rows[1] = rxBuffer[2];
-    keyData.rows[2] = rxBuffer[3];
-    keyData.rows[3] = rxBuffer[4];
-    return true;
-  } else {
-    return false;
-  }
+  for (uint8_t row = 0; row < 4; row++)
+    side->keyData.rows[row] = data[row + 1];
+  side->key_data_updated_ = true;
+}
+
+bool Model01Side::keyDataUpdated() {
+  bool updated      = key_data_updated_;
+  key_data_updated_ = false;
+  return updated;
 }
 
 keydata_t Model01Side::getKeyData() {
   return keyData;
 }
 
-void Model01Side::sendLEDData() {
-  sendLEDBank(nextLEDBank++);
-  if (nextLEDBank == LED_BANKS) {
-    nextLEDBank = 0;
-  }
+// Queues an update of one bank of LEDs. The colors are read when the update is
+// sent, not when it is queued. Returns false if the queue is full.
+bool Model01Side::requestLEDBank(I2CQueue &queue, uint8_t bank) {
+  return queue.submit(i2c::Request{
+    (uint8_t)addr, LED_BYTES_PER_BANK + 1, i2c::Request::WRITE, bank,
+    this, &prepareLEDBank, nullptr});
 }
 
 auto constexpr gamma8 = kaleidoscope::driver::color::gamma_correction;
 
-void Model01Side::sendLEDBank(uint8_t bank) {
-  uint8_t data[LED_BYTES_PER_BANK + 1];
+void Model01Side::prepareLEDBank(const i2c::Request &request, uint8_t *data) {
+  Model01Side *side = static_cast<Model01Side *>(request.context);
+  uint8_t bank      = request.tag;
+
   data[0] = TWI_CMD_LED_BASE + bank;
   for (uint8_t i = 0; i < LED_BYTES_PER_BANK; i++) {
     /* While the ATTiny controller does have a global brightness command, it is
      * limited to 32 levels, and those aren't nicely spread out either. For this
      * reason, we're doing our own brightness adjustment on this side, because
      * that results in a considerably smoother curve. */
-    uint8_t c = ledData.bytes[bank][i];
-    if (c > brightness_adjustment_)
-      c -= brightness_adjustment_;
+    uint8_t c = side->ledData.bytes[bank][i];
+    if (c > side->brightness_adjustment_)
+      c -= side->brightness_adjustment_;
     else
       c = 0;
 
     data[i + 1] = pgm_read_byte(&gamma8[c]);
   }
-  uint8_t result = twi_writeTo(addr, data, ELEMENTS(data), 1, 0);
 }
 
 void Model01Side::setAllLEDsTo(cRGB color) {
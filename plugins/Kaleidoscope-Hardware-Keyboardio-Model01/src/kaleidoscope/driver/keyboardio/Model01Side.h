@@ -26,6 +26,9 @@
 // System headers
 #include <stdint.h>  // for uint8_t, uint32_t
 
+// Kaleidoscope headers
+#include "kaleidoscope/driver/i2c/RequestQueue.h"  // for Request, RequestQueue
+
 // We allow cRGB/CRGB to be defined already when this is included.
 //
 #ifndef CRGB
@@ -62,6 +65,21 @@ typedef union {
 // config options
 
 #ifndef KALEIDOSCOPE_VIRTUAL_BUILD
+// A RequestQueue backend for the interrupt-driven TWI driver. Writes return as
+// soon as the data has been copied to the TWI buffer, and are sent while the
+// firmware gets on with other things.
+class TwiBackend {
+ public:
+  bool busy();
+  uint8_t write(uint8_t address, const uint8_t *data, uint8_t length);
+  uint8_t read(uint8_t address, uint8_t *data, uint8_t length);
+};
+
+// Keyscan reads and LED updates of both halves go through a shared queue, so
+// that LED updates never hold up a keyscan: two reads and all the LED banks
+// of both halves fit.
+typedef i2c::RequestQueue<TwiBackend, 2 + 2 * LED_BANKS, LED_BYTES_PER_BANK + 1> I2CQueue;
+
 // used to configure interrupts, configuration for a particular controller
 class Model01Side {
  public:
@@ -76,11 +94,13 @@ class Model01Side {
   uint8_t setLEDSPIFrequency(uint8_t frequency);
   int readLEDSPIFrequency();
 
-  void sendLEDData();
+  bool requestLEDBank(I2CQueue &queue, uint8_t bank);
   void setOneLEDTo(uint8_t led, cRGB color);
   void setAllLEDsTo(cRGB color);
   keydata_t getKeyData();
-  bool readKeys();
+  void requestKeys(I2CQueue &queue);
+  // Returns true (once) if new key data arrived since the last call.
+  bool keyDataUpdated();
   LEDData_t ledData;
   uint8_t controllerAddress();
 
@@ -96,9 +116,12 @@ class Model01Side {
   int addr;
   int ad01;
   keydata_t keyData;
-  uint8_t nextLEDBank = 0;
-  void sendLEDBank(uint8_t bank);
+  bool key_data_updated_ = false;
   int readRegister(uint8_t cmd);
+
+  static void prepareLEDBank(const i2c::Request &request, uint8_t *data);
+  static void onKeysRead(const i2c::Request &request, uint8_t status,
+                         const uint8_t *data, uint8_t length);
 };
 #endif  // ifndef KALEIDOSCOPE_VIRTUAL_BUILD
 
@@ -37,12 +37,17 @@ constexpr uint8_t Model100LEDDriverProps::key_led_map[] PROGMEM;
 struct Model100Hands {
   static driver::keyboardio::Model100Side leftHand;
   static driver::keyboardio::Model100Side rightHand;
+  static driver::keyboardio::I2CQueue i2c;
+
+  // The number of LED banks sent per cycle, one for each half.
+  static constexpr uint8_t led_banks_per_cycle = 2;
 
   static void setup();
 };
 
 driver::keyboardio::Model100Side Model100Hands::leftHand(0);
 driver::keyboardio::Model100Side Model100Hands::rightHand(3);
+driver::keyboardio::I2CQueue Model100Hands::i2c;
 
 void Model100Hands::setup() {
   Model100KeyScanner::enableScannerPower();
@@ -52,12 +57,14 @@ void Model100Hands::setup() {
 }
 
 /********* LED Driver *********/
-bool Model100LEDDriver::isLEDChanged = true;
+driver::led::DirtyBanks<LED_BANKS> Model100LEDDriver::changedBanksLeft;
+driver::led::DirtyBanks<LED_BANKS> Model100LEDDriver::changedBanksRight;
 
 void Model100LEDDriver::setBrightness(uint8_t brightness) {
   Model100Hands::leftHand.setBrightness(brightness);
   Model100Hands::rightHand.setBrightness(brightness);
-  isLEDChanged = true;
+  changedBanksLeft.markAll();
+  changedBanksRight.markAll();
 }
 
 uint8_t Model100LEDDriver::getBrightness() {
@@ -65,14 +72,14 @@ uint8_t Model100LEDDriver::getBrightness() {
 }
 
 void Model100LEDDriver::setCrgbAt(uint8_t i, cRGB crgb) {
+  static constexpr uint8_t leds_per_bank = LEDS_PER_HAND / LED_BANKS;
+
   if (i < 32) {
-    cRGB oldColor = getCrgbAt(i);
-    isLEDChanged |= !(oldColor.r == crgb.r && oldColor.g == crgb.g && oldColor.b == crgb.b);
+    changedBanksLeft.update(i / leds_per_bank, getCrgbAt(i), crgb);
 
     Model100Hands::leftHand.ledData.leds[i] = crgb;
   } else if (i < 64) {
-    cRGB oldColor = getCrgbAt(i);
-    isLEDChanged |= !(oldColor.r == crgb.r && oldColor.g == crgb.g && oldColor.b == crgb.b);
+    changedBanksRight.update((i - 32) / leds_per_bank, getCrgbAt(i), crgb);
 
     Model100Hands::rightHand.ledData.leds[i - 32] = crgb;
   } else {
@@ -94,27 +101,22 @@ cRGB Model100LEDDriver::getCrgbAt(uint8_t i) {
 }
 
 void Model100LEDDriver::syncLeds() {
-  if (!isLEDChanged)
-    return;
-  // LED Data is stored in four "banks" for each side
-  // We send it all at once to make it look nicer.
-  // We alternate left and right hands because otherwise
-  // we run into a race condition with updating the next bank
-  // on an ATTiny before it's done writing the previous one to memory
-
-  Model100Hands::leftHand.sendLEDData();
-  Model100Hands::rightHand.sendLEDData();
-
-  Model100Hands::leftHand.sendLEDData();
-  Model100Hands::rightHand.sendLEDData();
-
-  Model100Hands::leftHand.sendLEDData();
-  Model100Hands::rightHand.sendLEDData();
-
-  Model100Hands::leftHand.sendLEDData();
-  Model100Hands::rightHand.sendLEDData();
+  // LED Data is stored in four "banks" for each side, and only the banks that
+  // changed are sent. They are queued up here, and sent a couple at a time,
+  // interleaved with keyscans, so an update doesn't hold up a scan cycle. We
+  // alternate left and right hands because otherwise we run into a race
+  // condition with updating the next bank on an ATTiny before it's done
+  // writing the previous one to memory.
+  for (uint8_t bank = 0; bank < LED_BANKS; bank++) {
+    if (changedBanksLeft.isDirty(bank) &&
+        Model100Hands::leftHand.requestLEDBank(Model100Hands::i2c, bank))
+      changedBanksLeft.clear(bank);
+    if (changedBanksRight.isDirty(bank) &&
+        Model100Hands::rightHand.requestLEDBank(Model100Hands::i2c, bank))
+      changedBanksRight.clear(bank);
+  }
 
-  isLEDChanged = false;
+  Model100Hands::i2c.run(Model100Hands::led_banks_per_cycle);
 }
 
 /********* Key scanner *********/
@@ -123,6 +125,8 @@ driver::keyboardio::keydata_t Model100KeyScanner::leftHandState;
 driver::keyboardio::keydata_t Model100KeyScanner::rightHandState;
 driver::keyboardio::keydata_t Model100KeyScanner::previousLeftHandState;
 driver::keyboardio::keydata_t Model100KeyScanner::previousRightHandState;
+Model100KeyScannerProps::DebouncePolicy<uint32_t> Model100KeyScanner::leftHandDebouncer;
+Model100KeyScannerProps::DebouncePolicy<uint32_t> Model100KeyScanner::rightHandDebouncer;
 
 void Model100KeyScanner::enableScannerPower() {
   // Turn on the switched 5V network.
@@ -155,28 +159,28 @@ void Model100KeyScanner::readMatrix() {
   previousLeftHandState  = leftHandState;
   previousRightHandState = rightHandState;
 
-  if (Model100Hands::leftHand.readKeys()) {
-    leftHandState = Model100Hands::leftHand.getKeyData();
+  // The keyscan reads go first, then any LED banks still waiting to be sent.
+  Model100Hands::leftHand.requestKeys(Model100Hands::i2c);
+  Model100Hands::rightHand.requestKeys(Model100Hands::i2c);
+  Model100Hands::i2c.run(Model100Hands::led_banks_per_cycle);
+
+  if (Model100Hands::leftHand.keyDataUpdated()) {
+    leftHandDebouncer.debounce(Model100Hands::leftHand.getKeyData().all);
+    leftHandState.all = leftHandDebouncer.state();
   }
 
-  if (Model100Hands::rightHand.readKeys()) {
-    rightHandState = Model100Hands::rightHand.getKeyData();
+  if (Model100Hands::rightHand.keyDataUpdated()) {
+    rightHandDebouncer.debounce(Model100Hands::rightHand.getKeyData().all);
+    rightHandState.all = rightHandDebouncer.state();
   }
 }
 
 void Model100KeyScanner::actOnHalfRow(uint8_t row, uint8_t colState, uint8_t colPrevState, uint8_t startPos) {
-  if ((colState != colPrevState) || (colState != 0)) {
-    for (uint8_t col = 0; col < 8; col++) {
-      // Build up the key state for row, col
-      uint8_t keyState = ((bitRead(colPrevState, 0) << 0) |
-                          (bitRead(colState, 0) << 1));
-      if (keyState)
-        ThisType::handleKeyswitchEvent(Key_NoKey, KeyAddr(row, startPos - col), keyState);
-
-      // Throw away the data we've just used, so we can read the next column
-      colState     = colState >> 1;
-      colPrevState = colPrevState >> 1;
-    }
+  // Only keyswitches that toggled on or off produce events; held keys don't
+  // cost anything here.
+  for (uint8_t col : driver::keyscanner::ChangedBits<uint8_t>(colPrevState, colState)) {
+    uint8_t keyState = bitRead(colState, col) ? IS_PRESSED : WAS_PRESSED;
+    ThisType::handleKeyswitchEvent(Key_NoKey, KeyAddr(row, startPos - col), keyState);
   }
 }
 
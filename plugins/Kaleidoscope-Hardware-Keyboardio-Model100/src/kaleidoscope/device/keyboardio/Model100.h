@@ -40,6 +40,7 @@ struct cRGB {
 #include "kaleidoscope/driver/keyboardio/Model100Side.h"
 #include "kaleidoscope/driver/keyscanner/Base.h"
 #include "kaleidoscope/driver/led/Base.h"
+#include "kaleidoscope/driver/led/DirtyBanks.h"
 #include "kaleidoscope/driver/mcu/GD32.h"
 #include "kaleidoscope/driver/storage/GD32Flash.h"
 
@@ -77,7 +78,9 @@ class Model100LEDDriver : public kaleidoscope::driver::led::Base<Model100LEDDriv
   static void enableHighPowerLeds();
 
  private:
-  static bool isLEDChanged;
+  // The banks of each half that need to be sent on the next sync.
+  static driver::led::DirtyBanks<LED_BANKS> changedBanksLeft;
+  static driver::led::DirtyBanks<LED_BANKS> changedBanksRight;
 };
 #else   // ifndef KALEIDOSCOPE_VIRTUAL_BUILD
 class Model100LEDDriver;
@@ -87,6 +90,12 @@ struct Model100KeyScannerProps : public kaleidoscope::driver::keyscanner::BasePr
   static constexpr uint8_t matrix_rows    = 4;
   static constexpr uint8_t matrix_columns = 16;
   typedef MatrixAddr<matrix_rows, matrix_columns> KeyAddr;
+
+  // The controllers in the halves of the keyboard debounce the keyswitches
+  // themselves, so by default, their reports are used as-is. The state of each
+  // half is debounced as a single 32-bit row.
+  template<typename _RowState>
+  using DebouncePolicy = kaleidoscope::driver::keyscanner::debounce::None<_RowState>;
 };
 
 #ifndef KALEIDOSCOPE_VIRTUAL_BUILD
@@ -115,6 +124,8 @@ class Model100KeyScanner : public kaleidoscope::driver::keyscanner::Base<Model10
   static driver::keyboardio::keydata_t rightHandState;
   static driver::keyboardio::keydata_t previousLeftHandState;
   static driver::keyboardio::keydata_t previousRightHandState;
+  static Model100KeyScannerProps::DebouncePolicy<uint32_t> leftHandDebouncer;
+  static Model100KeyScannerProps::DebouncePolicy<uint32_t> rightHandDebouncer;
 
   static void actOnHalfRow(uint8_t row, uint8_t colState, uint8_t colPrevState, uint8_t startPos);
 };
@@ -177,62 +177,77 @@ int Model100Side::readRegister(uint8_t cmd) {
 }
 
 
-// gives information on the key that was just pressed or released.
-bool Model100Side::readKeys() {
+// Queues a read of the state of the keys; `keyDataUpdated()` tells when it
+// arrived.
+void Model100Side::requestKeys(I2CQueue &queue) {
   if (isDeviceAvailable() == false) {
-    return false;
+    return;
   }
 
-  uint8_t row_counter = 0;
-  // perform blocking read into buffer
-  uint8_t read           = 0;
-  uint8_t bytes_returned = 0;
-  bytes_returned         = Wire.requestFrom(addr, 5);  // request 5 bytes from the keyscanner
-  if (bytes_returned < 5) {
-    return false;
-  }
-  if (Wire.available()) {
-    read = Wire.read();
-    if (TWI_REPLY_KEYDATA == read) {
-      while (Wire.available()) {
-        keyData.rows[row_counter++] = Wire.read();
-      }
-      return true;
-    }
-  }
-  return false;
+  queue.submit(i2c::Request{
+    (uint8_t)addr, 5, i2c::Request::READ | i2c::Request::HIGH_PRIORITY, 0,
+    this, nullptr, &onKeysRead});
+}
+
+void Model100Side::onKeysRead(const i2c::Request &request, uint8_t status,
+                              const uint8_t *data, uint8_t length) {
+  Model100Side *side = static_cast<Model100Side *>(request.context);
+  if (status != 0 || data[0] != TWI_REPLY_KEYDATA)
+    return;
+
+  for (uint8_t row = 0; row < 4; row++)
+    side->keyData.rows[row] = data[row + 1];
+  side->key_data_updated_ = true;
+}
+
+bool Model100Side::keyDataUpdated() {
+  bool updated      = key_data_updated_;
+  key_data_updated_ = false;
+  return updated;
 }
 
 keydata_t Model100Side::getKeyData() {
   return keyData;
 }
 
-void Model100Side::sendLEDData() {
-  sendLEDBank(nextLEDBank++);
-  if (nextLEDBank == LED_BANKS) {
-    nextLEDBank = 0;
+// Queues an update of one bank of LEDs. The colors are read when the update is
+// sent, not when it is queued. Returns false if the queue is full.
+bool Model100Side::requestLEDBank(I2CQueue &queue, uint8_t bank) {
+  if (isDeviceAvailable() == false) {
+    return true;
   }
+
+  return queue.submit(i2c::Request{
+    (uint8_t)addr, LED_BYTES_PER_BANK + 1, i2c::Request::WRITE, bank,
+    this, &prepareLEDBank, &onLEDBankSent});
 }
 
 auto constexpr gamma8 = kaleidoscope::driver::color::gamma_correction;
 
-void Model100Side::sendLEDBank(uint8_t bank) {
-  uint8_t data[LED_BYTES_PER_BANK + 1];
+void Model100Side::prepareLEDBank(const i2c::Request &request, uint8_t *data) {
+  Model100Side *side = static_cast<Model100Side *>(request.context);
+  uint8_t bank       = request.tag;
+
   data[0] = TWI_CMD_LED_BASE + bank;
   for (uint8_t i = 0; i < LED_BYTES_PER_BANK; i++) {
     /* While the ATTiny controller does have a global brightness command, it is
      * limited to 32 levels, and those aren't nicely spread out either. For this
      * reason, we're doing our own brightness adjustment on this side, because
      * that results in a considerably smoother curve. */
-    uint8_t c = ledData.bytes[bank][i];
-    if (c > brightness_adjustment_)
-      c -= brightness_adjustment_;
+    uint8_t c = side->ledData.bytes[bank][i];
+    if (c > side->brightness_adjustment_)
+      c -= side->brightness_adjustment_;
     else
       c = 0;
 
     data[i + 1] = pgm_read_byte(&gamma8[c]);
   }
-  uint8_t result = writeData(data, ELEMENTS(data));
+}
+
+void Model100Side::onLEDBankSent(const i2c::Request &request, uint8_t status,
+                                 const uint8_t *data, uint8_t length) {
+  if (status)
+    static_cast<Model100Side *>(request.context)->markDeviceUnavailable();
 }
 
 void Model100Side::setAllLEDsTo(cRGB color) {
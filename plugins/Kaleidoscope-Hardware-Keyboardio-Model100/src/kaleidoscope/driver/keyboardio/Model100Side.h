@@ -26,6 +26,9 @@
 #include <Arduino.h>  // for byte
 #include <stdint.h>   // for uint8_t, uint32_t
 
+#include "kaleidoscope/driver/i2c/RequestQueue.h"  // for Request, RequestQueue
+#include "kaleidoscope/driver/i2c/WireBackend.h"   // for WireBackend
+
 // We allow cRGB/CRGB to be defined already when this is included.
 //
 #ifndef CRGB
@@ -62,6 +65,11 @@ typedef union {
 // config options
 
 #ifndef KALEIDOSCOPE_VIRTUAL_BUILD
+// Keyscan reads and LED updates of both halves go through a shared queue, so
+// that LED updates never hold up a keyscan: two reads and all the LED banks
+// of both halves fit.
+typedef i2c::RequestQueue<i2c::WireBackend, 2 + 2 * LED_BANKS, LED_BYTES_PER_BANK + 1> I2CQueue;
+
 // used to configure interrupts, configuration for a particular controller
 class Model100Side {
  public:
@@ -76,11 +84,13 @@ class Model100Side {
   byte setLEDSPIFrequency(byte frequency);
   int readLEDSPIFrequency();
 
-  void sendLEDData();
+  bool requestLEDBank(I2CQueue &queue, byte bank);
   void setOneLEDTo(byte led, cRGB color);
   void setAllLEDsTo(cRGB color);
   keydata_t getKeyData();
-  bool readKeys();
+  void requestKeys(I2CQueue &queue);
+  // Returns true (once) if new key data arrived since the last call.
+  bool keyDataUpdated();
 
   LEDData_t ledData;
 
@@ -99,14 +109,19 @@ class Model100Side {
   int addr;
   int ad01;
   keydata_t keyData;
+  bool key_data_updated_ = false;
   // a value of 0 is "device seen" - anything else is how many cycles before we should
   // check for the device
   uint16_t unavailable_device_check_countdown_           = 0;
   static const uint16_t UNAVAILABLE_DEVICE_COUNTDOWN_MAX = 0x00FFU;
-  byte nextLEDBank                                       = 0;
-  void sendLEDBank(byte bank);
   int readRegister(uint8_t cmd);
   uint8_t writeData(uint8_t *data, uint8_t length);
+
+  static void prepareLEDBank(const i2c::Request &request, uint8_t *data);
+  static void onLEDBankSent(const i2c::Request &request, uint8_t status,
+                            const uint8_t *data, uint8_t length);
+  static void onKeysRead(const i2c::Request &request, uint8_t status,
+                         const uint8_t *data, uint8_t length);
 };
 #endif  // ifndef KALEIDOSCOPE_VIRTUAL_BUILD
 
@@ -43,6 +43,7 @@ struct AtreusProps : kaleidoscope::device::ATmega32U4KeyboardProps {
     static constexpr uint8_t matrix_rows    = 4;
     static constexpr uint8_t matrix_columns = 12;
     typedef MatrixAddr<matrix_rows, matrix_columns> KeyAddr;
+    static const bool keyscan_wakeup = true;
 
 #ifndef KALEIDOSCOPE_VIRTUAL_BUILD
 
@@ -0,0 +1,111 @@
+/* -*- mode: c++ -*-
+ * Kaleidoscope-HookProfiler -- Per-plugin event handler profiling
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope/plugin/HookProfiler.h"
+
+#include <Arduino.h>                   // for F, PSTR, __FlashStringHelper, pgm_read_byte
+#include <Kaleidoscope-FocusSerial.h>  // for Focus, FocusSerial
+#include <stdint.h>                    // for uint8_t
+
+#include "kaleidoscope/event_handler_result.h"     // for EventHandlerResult, EventHandlerResult::OK
+#include "kaleidoscope_internal/hook_profiling.h"  // for HookProfile, hook_profiles, hook_profil...
+
+namespace kaleidoscope {
+namespace plugin {
+
+EventHandlerResult HookProfiler::onFocusEvent(const char *input) {
+  const char *cmd_hooks = PSTR("profile.hooks");
+  const char *cmd_reset = PSTR("profile.reset");
+
+  if (::Focus.inputMatchesHelp(input))
+    return ::Focus.printHelp(cmd_hooks, cmd_reset);
+
+  if (::Focus.inputMatchesCommand(input, cmd_hooks)) {
+    sendProfiles();
+  } else if (::Focus.inputMatchesCommand(input, cmd_reset)) {
+    reset();
+  } else {
+    return EventHandlerResult::OK;
+  }
+
+  return EventHandlerResult::EVENT_CONSUMED;
+}
+
+#ifdef KALEIDOSCOPE_PROFILE_HOOKS
+
+void HookProfiler::reset() {
+  for (auto *profile = kaleidoscope_internal::hook_profiles;
+       profile != nullptr;
+       profile = profile->next) {
+    profile->reset();
+  }
+}
+
+// Each line of the report lists the plugin, the event handler, the number of
+// times it was called, and the total and maximum time spent in it (in
+// microseconds).
+void HookProfiler::sendProfiles() {
+  for (auto *profile = kaleidoscope_internal::hook_profiles;
+       profile != nullptr;
+       profile = profile->next) {
+    sendPluginName(profile->plugin_index);
+    ::Focus.send((const __FlashStringHelper *)profile->hook_name,
+                 profile->count,
+                 profile->total_time,
+                 profile->max_time,
+                 ::Focus.NEWLINE);
+  }
+}
+
+// The plugin names are stored as a single string, exactly as they were passed
+// to `KALEIDOSCOPE_INIT_PLUGINS()`, so we need to skip over the preceding
+// names, and the separators between them.
+void HookProfiler::sendPluginName(uint8_t index) {
+  const char *names = kaleidoscope_internal::hook_profiling_plugin_names;
+  char c;
+
+  while (index > 0) {
+    c = pgm_read_byte(names++);
+    if (c == '\0')
+      return;
+    if (c == ',')
+      --index;
+  }
+  while ((c = pgm_read_byte(names)) == ' ')
+    ++names;
+  while ((c = pgm_read_byte(names++)) != '\0' && c != ',' && c != ' ')
+    ::Focus.sendRaw(c);
+  ::Focus.sendRaw(::Focus.SEPARATOR);
+}
+
+#else  // ifdef KALEIDOSCOPE_PROFILE_HOOKS
+
+// Without `KALEIDOSCOPE_PROFILE_HOOKS`, there is nothing to report.
+void HookProfiler::reset() {}
+
+void HookProfiler::sendProfiles() {
+  ::Focus.send(::Focus.COMMENT, F("hook profiling is disabled"), ::Focus.NEWLINE);
+}
+
+void HookProfiler::sendPluginName(uint8_t /*index*/) {}
+
+#endif  // ifdef KALEIDOSCOPE_PROFILE_HOOKS
+
+}  // namespace plugin
+}  // namespace kaleidoscope
+
+kaleidoscope::plugin::HookProfiler HookProfiler;
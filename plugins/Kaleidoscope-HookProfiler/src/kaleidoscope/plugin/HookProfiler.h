@@ -0,0 +1,43 @@
+/* -*- mode: c++ -*-
+ * Kaleidoscope-HookProfiler -- Per-plugin event handler profiling
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t
+
+#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
+#include "kaleidoscope/plugin.h"                // for Plugin
+
+namespace kaleidoscope {
+namespace plugin {
+
+class HookProfiler : public kaleidoscope::Plugin {
+ public:
+  EventHandlerResult onFocusEvent(const char *input);
+
+  /// Clear the statistics gathered so far
+  void reset();
+
+ private:
+  void sendProfiles();
+  void sendPluginName(uint8_t index);
+};
+
+}  // namespace plugin
+}  // namespace kaleidoscope
+
+extern kaleidoscope::plugin::HookProfiler HookProfiler;
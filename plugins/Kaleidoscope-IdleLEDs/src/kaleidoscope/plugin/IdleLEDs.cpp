@@ -25,6 +25,7 @@
 
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/Runtime.h"               // for Runtime, Runtime_
+#include "kaleidoscope/Timer.h"                 // for Timer
 #include "kaleidoscope/device/device.h"         // for VirtualProps::Storage, Base<>::Storage
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
 #include "kaleidoscope/plugin/LEDControl.h"     // for LEDControl
@@ -35,6 +36,7 @@ namespace plugin {
 uint32_t IdleLEDs::idle_time_limit = 600000;  // 10 minutes
 uint32_t IdleLEDs::start_time_     = 0;
 bool IdleLEDs::idle_;
+Timer IdleLEDs::timer_{IdleLEDs::onTimeout};
 
 uint32_t IdleLEDs::idleTimeoutSeconds() {
   return idle_time_limit / 1000;
@@ -42,17 +44,46 @@ uint32_t IdleLEDs::idleTimeoutSeconds() {
 
 void IdleLEDs::setIdleTimeoutSeconds(uint32_t new_limit) {
   idle_time_limit = new_limit * 1000;
+  startTimer();
 }
 
-EventHandlerResult IdleLEDs::beforeEachCycle() {
+void IdleLEDs::startTimer() {
+  if (idle_time_limit == 0) {
+    Runtime.stopTimer(timer_);
+    return;
+  }
+  Runtime.startTimer(timer_, start_time_, idle_time_limit);
+}
+
+void IdleLEDs::onTimeout() {
+  // `idle_time_limit` may have been changed directly since the timer was
+  // started, so check it again, and wait longer if it has been raised.
   if (idle_time_limit == 0)
-    return EventHandlerResult::OK;
+    return;
+
+  if (!Runtime.hasTimeExpired(start_time_, idle_time_limit)) {
+    startTimer();
+    return;
+  }
 
-  if (::LEDControl.isEnabled() &&
-      Runtime.hasTimeExpired(start_time_, idle_time_limit)) {
+  if (::LEDControl.isEnabled()) {
     ::LEDControl.disable();
     idle_ = true;
   }
+}
+
+EventHandlerResult IdleLEDs::onSetup() {
+  startTimer();
+
+  return EventHandlerResult::OK;
+}
+
+EventHandlerResult IdleLEDs::beforeSyncingLeds() {
+  // Nothing tells us when someone else turns the LEDs back on after the timer
+  // has expired, or when `idle_time_limit` is raised from zero directly, but
+  // either way the LEDs are on, and get synced, so this is where we notice.
+  if (!timer_.isPending() && idle_time_limit != 0)
+    startTimer();
 
   return EventHandlerResult::OK;
 }
@@ -64,6 +95,7 @@ EventHandlerResult IdleLEDs::onKeyEvent(KeyEvent &event) {
   }
 
   start_time_ = Runtime.millisAtCycleStart();
+  startTimer();
 
   return EventHandlerResult::OK;
 }
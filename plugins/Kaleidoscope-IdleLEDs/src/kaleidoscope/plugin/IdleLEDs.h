@@ -21,6 +21,7 @@
 #include <stdint.h>  // for uint32_t, uint16_t
 
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
+#include "kaleidoscope/Timer.h"                 // for Timer
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
 #include "kaleidoscope/plugin.h"                // for Plugin
 
@@ -34,12 +35,17 @@ class IdleLEDs : public kaleidoscope::Plugin {
   static uint32_t idleTimeoutSeconds();
   static void setIdleTimeoutSeconds(uint32_t new_limit);
 
-  EventHandlerResult beforeEachCycle();
+  EventHandlerResult onSetup();
   EventHandlerResult onKeyEvent(KeyEvent &event);
+  EventHandlerResult beforeSyncingLeds();
 
  private:
   static bool idle_;
   static uint32_t start_time_;
+  static Timer timer_;
+
+  static void startTimer();
+  static void onTimeout();
 };
 
 class PersistentIdleLEDs : public IdleLEDs {
@@ -20,13 +20,13 @@
 #include <Kaleidoscope-OneShot.h>          // for OneShot
 #include <Kaleidoscope-OneShotMetaKeys.h>  // for OneShot_ActiveStickyKey
 
-#include "kaleidoscope/KeyAddr.h"               // for KeyAddr, MatrixAddr, MatrixAddr<>::Range
+#include "kaleidoscope/KeyAddr.h"               // for KeyAddr
 #include "kaleidoscope/KeyAddrBitfield.h"       // for KeyAddrBitfield, KeyAddrBitfield::Iterator
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/LiveKeys.h"              // for LiveKeys, live_keys
 #include "kaleidoscope/device/device.h"         // for CRGB, cRGB
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
-#include "kaleidoscope/key_defs.h"              // for Key, Key_Inactive, Key_Masked
+#include "kaleidoscope/key_defs.h"              // for Key
 #include "kaleidoscope/keyswitch_state.h"       // for keyToggledOn
 #include "kaleidoscope/plugin/LEDControl.h"     // for LEDControl
 
@@ -58,14 +58,8 @@ EventHandlerResult ActiveModColorEffect::onKeyEvent(KeyEvent &event) {
       mod_key_bits_.set(event.addr);
     }
     if (event.key == OneShot_ActiveStickyKey) {
-      for (KeyAddr entry_addr : KeyAddr::all()) {
-        // Get the entry from the live keys array
-        Key entry_key = live_keys[entry_addr];
-        // Skip empty entries
-        if (entry_key == Key_Inactive || entry_key == Key_Masked) {
-          continue;
-        }
-        // Highlight everything else
+      // Highlight every active key.
+      for (KeyAddr entry_addr : live_keys.active()) {
         mod_key_bits_.set(entry_addr);
       }
     }
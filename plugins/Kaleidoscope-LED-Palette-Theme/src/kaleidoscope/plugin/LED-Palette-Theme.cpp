@@ -17,7 +17,7 @@
 
 #include "kaleidoscope/plugin/LED-Palette-Theme.h"
 
-#include <Arduino.h>                       // for PSTR
+#include <Arduino.h>                       // for PROGMEM, PSTR
 #include <Kaleidoscope-EEPROM-Settings.h>  // for EEPROMSettings
 #include <Kaleidoscope-FocusSerial.h>      // for Focus, FocusSerial
 #include <stdint.h>                        // for uint8_t, uint16_t
@@ -33,6 +33,12 @@ namespace plugin {
 
 uint16_t LEDPaletteTheme::palette_base_;
 uint8_t LEDPaletteTheme::palette_size_ = 24;
+cRGB LEDPaletteTheme::pending_color_;
+uint16_t LEDPaletteTheme::stream_theme_base_;
+uint16_t LEDPaletteTheme::stream_max_index_;
+uint8_t LEDPaletteTheme::pending_indexes_;
+uint16_t LEDPaletteTheme::patch_position_;
+uint16_t LEDPaletteTheme::patch_count_;
 
 uint16_t LEDPaletteTheme::reserveThemes(uint8_t max_themes) {
   if (!palette_base_)
@@ -127,41 +133,55 @@ uint8_t LEDPaletteTheme::getPaletteSize() {
   return LEDPaletteTheme::palette_size_;
 }
 
-EventHandlerResult LEDPaletteTheme::onFocusEvent(const char *input) {
-  if (!Runtime.has_leds)
-    return EventHandlerResult::OK;
+static constexpr char cmd_palette[] PROGMEM = "palette";
 
-  const char *cmd = PSTR("palette");
+const focusserial::Command LEDPaletteTheme::focus_commands_[] PROGMEM = {
+  FOCUS_COMMAND(cmd_palette, focusPalette),
+};
+focusserial::CommandTable LEDPaletteTheme::focus_command_table_(LEDPaletteTheme::focus_commands_);
 
-  if (::Focus.inputMatchesHelp(input))
-    return ::Focus.printHelp(cmd);
+EventHandlerResult LEDPaletteTheme::onSetup() {
+  if (Runtime.has_leds)
+    ::Focus.registerCommands(focus_command_table_);
+  return EventHandlerResult::OK;
+}
 
-  if (!::Focus.inputMatchesCommand(input, cmd))
-    return EventHandlerResult::OK;
+void LEDPaletteTheme::focusPalette() {
+  // The colors are read as they arrive, over as many cycles as that takes.
+  ::Focus.streamArguments(receivePaletteComponent, endPalette);
+}
 
-  if (::Focus.isEOL()) {
+void LEDPaletteTheme::receivePaletteComponent(uint16_t index, uint16_t value) {
+  // Each color is sent as three numbers: red, green, and blue.
+  switch (index % 3) {
+  case 0:
+    pending_color_.r = value;
+    break;
+  case 1:
+    pending_color_.g = value;
+    break;
+  case 2:
+    pending_color_.b = value;
+    if (index / 3 < palette_size_)
+      updatePaletteColor(index / 3, pending_color_);
+    break;
+  }
+}
+
+void LEDPaletteTheme::endPalette(uint16_t component_count) {
+  if (component_count == 0) {
     for (uint8_t i = 0; i < palette_size_; i++) {
       cRGB color;
 
       color = lookupPaletteColor(i);
       ::Focus.send(color);
     }
-    return EventHandlerResult::EVENT_CONSUMED;
+    return;
   }
 
-  uint8_t i = 0;
-  while (i < palette_size_ && !::Focus.isEOL()) {
-    cRGB color;
-
-    ::Focus.read(color);
-    updatePaletteColor(i, color);
-    i++;
-  }
   Runtime.storage().commit();
 
   ::LEDControl.refreshAll();
-
-  return EventHandlerResult::EVENT_CONSUMED;
 }
 
 EventHandlerResult LEDPaletteTheme::themeFocusEvent(const char *input,
@@ -171,40 +191,142 @@ EventHandlerResult LEDPaletteTheme::themeFocusEvent(const char *input,
   if (!Runtime.has_leds)
     return EventHandlerResult::OK;
 
-  if (::Focus.inputMatchesHelp(input))
-    return ::Focus.printHelp(expected_input);
+  if (::Focus.inputMatchesHelp(input)) {
+    ::Focus.printHelp(expected_input);
+    return ::Focus.printHelpVariants(expected_input, PSTR(".binary"), PSTR(".set"), PSTR(".range"));
+  }
 
-  if (!::Focus.inputMatchesCommand(input, expected_input))
+  if (::Focus.inputMatchesBinaryCommand(input, expected_input)) {
+    focusThemeBinary(theme_base, max_themes);
+  } else if (::Focus.inputMatchesCommandVariant(input, expected_input, PSTR(".set"))) {
+    focusThemeSet(theme_base, max_themes);
+  } else if (::Focus.inputMatchesCommandVariant(input, expected_input, PSTR(".range"))) {
+    focusThemeRange(theme_base, max_themes);
+  } else if (::Focus.inputMatchesCommand(input, expected_input)) {
+    focusTheme(theme_base, max_themes);
+  } else {
     return EventHandlerResult::OK;
+  }
 
-  uint16_t max_index = (max_themes * Runtime.device().led_count) / 2;
+  return EventHandlerResult::EVENT_CONSUMED;
+}
+
+void LEDPaletteTheme::focusTheme(uint16_t theme_base, uint8_t max_themes) {
+  stream_theme_base_ = theme_base;
+  stream_max_index_  = (max_themes * Runtime.device().led_count) / 2;
+  // The indexes are read as they arrive, over as many cycles as that takes.
+  ::Focus.streamArguments(receiveThemeIndex, endTheme);
+}
 
+void LEDPaletteTheme::focusThemeBinary(uint16_t theme_base, uint8_t max_themes) {
+  uint16_t max_index = (max_themes * Runtime.device().led_count) / 2;
+  // Sent as stored: two palette indexes per byte, the first one in the high
+  // nibble.
   if (::Focus.isEOL()) {
-    for (uint16_t pos = 0; pos < max_index; pos++) {
-      uint8_t indexes = Runtime.storage().read(theme_base + pos);
+    ::Focus.sendStorage(theme_base, max_index);
+  } else {
+    ::Focus.receiveStorage(theme_base, max_index, endThemeBinary);
+  }
+}
+
+// `<command>.set <theme> <index> <color index>...` writes the palette indexes
+// from the given position on, and `<command>.range <theme> <index> <count>`
+// sends `count` of them from there.
+void LEDPaletteTheme::focusThemeSet(uint16_t theme_base, uint8_t max_themes) {
+  stream_theme_base_ = theme_base;
+  stream_max_index_  = (max_themes * Runtime.device().led_count) / 2;
+  ::Focus.streamArguments(receiveThemePatch, endThemePatch);
+}
+
+void LEDPaletteTheme::focusThemeRange(uint16_t theme_base, uint8_t max_themes) {
+  stream_theme_base_ = theme_base;
+  stream_max_index_  = (max_themes * Runtime.device().led_count) / 2;
+  patch_count_       = 0;
+  ::Focus.streamArguments(receiveThemeRangeArgument, endThemeRange);
+}
+
+void LEDPaletteTheme::receiveThemeIndex(uint16_t index, uint16_t value) {
+  // Two palette indexes are stored in each byte, the first one in the high
+  // nibble.
+  uint16_t pos = index / 2;
+  if (pos >= stream_max_index_)
+    return;
+
+  if (index % 2 == 0) {
+    pending_indexes_ = value << 4;
+    return;
+  }
+  Runtime.storage().update(stream_theme_base_ + pos, pending_indexes_ + value);
+}
+
+void LEDPaletteTheme::endTheme(uint16_t index_count) {
+  if (index_count == 0) {
+    for (uint16_t pos = 0; pos < stream_max_index_; pos++) {
+      uint8_t indexes = Runtime.storage().read(stream_theme_base_ + pos);
 
       ::Focus.send((uint8_t)(indexes >> 4), indexes & ~0xf0);
     }
-    return EventHandlerResult::EVENT_CONSUMED;
+    return;
   }
 
-  uint16_t pos = 0;
+  // An odd number of indexes leaves the second half of the last byte at zero.
+  if (index_count % 2 != 0 && index_count / 2 < stream_max_index_)
+    Runtime.storage().update(stream_theme_base_ + index_count / 2, pending_indexes_);
 
-  while (!::Focus.isEOL() && (pos < max_index)) {
-    uint8_t idx1, idx2;
-    ::Focus.read(idx1);
-    ::Focus.read(idx2);
+  Runtime.storage().commit();
+
+  ::LEDControl.refreshAll();
+}
+
+void LEDPaletteTheme::endThemeBinary(bool success) {
+  if (!success)
+    return;
+  Runtime.storage().commit();
+  ::LEDControl.refreshAll();
+}
 
-    uint8_t indexes = (idx1 << 4) + idx2;
+void LEDPaletteTheme::receivePatchPosition(uint16_t index, uint16_t value) {
+  uint16_t position_count = stream_max_index_ * 2;
+  if (index == 0) {
+    uint32_t position = uint32_t(value) * Runtime.device().led_count;
+    patch_position_   = position < position_count ? position : position_count;
+  } else if (value < Runtime.device().led_count && patch_position_ < position_count) {
+    patch_position_ += value;
+  } else {
+    patch_position_ = position_count;
+  }
+}
 
-    Runtime.storage().update(theme_base + pos, indexes);
-    pos++;
+void LEDPaletteTheme::receiveThemePatch(uint16_t index, uint16_t value) {
+  if (index < 2) {
+    receivePatchPosition(index, value);
+    return;
   }
+  if (patch_position_ < stream_max_index_ * 2)
+    updateColorIndexAtPosition(stream_theme_base_, patch_position_++, value);
+}
+
+void LEDPaletteTheme::endThemePatch(uint16_t argument_count) {
+  if (argument_count < 3)
+    return;
+
+  // However many indexes were sent, they are committed together.
   Runtime.storage().commit();
 
   ::LEDControl.refreshAll();
+}
 
-  return EventHandlerResult::EVENT_CONSUMED;
+void LEDPaletteTheme::receiveThemeRangeArgument(uint16_t index, uint16_t value) {
+  if (index < 2) {
+    receivePatchPosition(index, value);
+  } else if (index == 2) {
+    patch_count_ = value;
+  }
+}
+
+void LEDPaletteTheme::endThemeRange(uint16_t argument_count) {
+  for (; patch_count_ > 0 && patch_position_ < stream_max_index_ * 2; patch_count_--, patch_position_++)
+    ::Focus.send(lookupColorIndexAtPosition(stream_theme_base_, patch_position_));
 }
 
 }  // namespace plugin
@@ -19,10 +19,11 @@
 
 #include <stdint.h>  // for uint16_t, uint8_t
 
-#include "kaleidoscope/KeyAddr.h"               // for KeyAddr
-#include "kaleidoscope/device/device.h"         // for cRGB
-#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
-#include "kaleidoscope/plugin.h"                // for Plugin
+#include "kaleidoscope/KeyAddr.h"                      // for KeyAddr
+#include "kaleidoscope/device/device.h"                // for cRGB
+#include "kaleidoscope/event_handler_result.h"         // for EventHandlerResult
+#include "kaleidoscope/plugin.h"                       // for Plugin
+#include "kaleidoscope/plugin/focusserial/Commands.h"  // for Command, CommandTable
 
 namespace kaleidoscope {
 namespace plugin {
@@ -40,7 +41,16 @@ class LEDPaletteTheme : public kaleidoscope::Plugin {
   static void updatePaletteColor(uint8_t palette_index, cRGB color);
   static const cRGB lookupPaletteColor(uint8_t palette_index);
 
-  EventHandlerResult onFocusEvent(const char *input);
+  EventHandlerResult onSetup();
+
+  // The Focus commands of a theme, for plugins to call from the handlers of
+  // their own commands: `<command>`, `<command>.binary`, `<command>.set` and
+  // `<command>.range`, respectively (see the README).
+  static void focusTheme(uint16_t theme_base, uint8_t max_themes);
+  static void focusThemeBinary(uint16_t theme_base, uint8_t max_themes);
+  static void focusThemeSet(uint16_t theme_base, uint8_t max_themes);
+  static void focusThemeRange(uint16_t theme_base, uint8_t max_themes);
+
   EventHandlerResult themeFocusEvent(const char *input,
                                      const char *expected_input,
                                      uint16_t theme_base,
@@ -52,6 +62,31 @@ class LEDPaletteTheme : public kaleidoscope::Plugin {
  private:
   static uint16_t palette_base_;
   static uint8_t palette_size_;
+
+  static const focusserial::Command focus_commands_[];
+  static focusserial::CommandTable focus_command_table_;
+  static void focusPalette();
+
+  // The state of streamed `palette` and theme requests.
+  static cRGB pending_color_;
+  static uint16_t stream_theme_base_;
+  static uint16_t stream_max_index_;
+  static uint8_t pending_indexes_;
+
+  static void receivePaletteComponent(uint16_t index, uint16_t value);
+  static void endPalette(uint16_t component_count);
+  static void receiveThemeIndex(uint16_t index, uint16_t value);
+  static void endTheme(uint16_t index_count);
+  static void endThemeBinary(bool success);
+
+  // The state of streamed `<theme>.set` and `<theme>.range` requests.
+  static uint16_t patch_position_;
+  static uint16_t patch_count_;
+  static void receivePatchPosition(uint16_t index, uint16_t value);
+  static void receiveThemePatch(uint16_t index, uint16_t value);
+  static void endThemePatch(uint16_t argument_count);
+  static void receiveThemeRangeArgument(uint16_t index, uint16_t value);
+  static void endThemeRange(uint16_t argument_count);
 };
 
 }  // namespace plugin
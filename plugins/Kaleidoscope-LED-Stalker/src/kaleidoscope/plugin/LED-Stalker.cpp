@@ -56,7 +56,7 @@ void StalkerEffect::TransientLEDMode::update() {
     uint8_t step = map_[key_addr.toInt()];
 
     // If key is active (held), set its animation position to the start
-    if (live_keys[key_addr] != Key_Inactive) {
+    if (live_keys.read(key_addr) != Key_Inactive) {
       step = 0xff;
     }
 
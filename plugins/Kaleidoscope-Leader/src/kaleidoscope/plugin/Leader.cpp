@@ -85,6 +85,7 @@ int8_t Leader::lookup() {
 void Leader::reset() {
   sequence_pos_ = 0;
   sequence_[0]  = Key_NoKey;
+  Runtime.stopTimer(timer_);
 }
 
 #ifndef NDEPRECATED
@@ -111,9 +112,9 @@ EventHandlerResult Leader::onKeyswitchEvent(KeyEvent &event) {
     if (!isLeader(event.key))
       return EventHandlerResult::OK;
 
-    start_time_              = Runtime.millisAtCycleStart();
     sequence_pos_            = 0;
     sequence_[sequence_pos_] = event.key;
+    startTimer();
 
     return EventHandlerResult::ABORT;
   }
@@ -124,7 +125,6 @@ EventHandlerResult Leader::onKeyswitchEvent(KeyEvent &event) {
     return EventHandlerResult::OK;
   }
 
-  start_time_              = Runtime.millisAtCycleStart();
   sequence_[sequence_pos_] = event.key;
   int8_t action_index      = lookup();
 
@@ -133,6 +133,7 @@ EventHandlerResult Leader::onKeyswitchEvent(KeyEvent &event) {
     return EventHandlerResult::OK;
   }
   if (action_index == PARTIAL_MATCH) {
+    startTimer();
     return EventHandlerResult::ABORT;
   }
 
@@ -143,22 +144,21 @@ EventHandlerResult Leader::onKeyswitchEvent(KeyEvent &event) {
   return EventHandlerResult::ABORT;
 }
 
-EventHandlerResult Leader::afterEachCycle() {
-  if (!isActive())
-    return EventHandlerResult::OK;
+// --- timeout ---
 
+void Leader::startTimer() {
 #ifndef NDEPRECATED
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-  if (Runtime.hasTimeExpired(start_time_, time_out))
-    reset();
+  Runtime.startTimer(timer_, time_out);
 #pragma GCC diagnostic pop
 #else
-  if (Runtime.hasTimeExpired(start_time_, timeout_))
-    reset();
+  Runtime.startTimer(timer_, timeout_);
 #endif
+}
 
-  return EventHandlerResult::OK;
+void Leader::onTimeout() {
+  ::Leader.reset();
 }
 
 }  // namespace plugin
@@ -23,6 +23,7 @@
 
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/KeyEventTracker.h"       // for KeyEventTracker
+#include "kaleidoscope/Timer.h"                 // for Timer
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
 #include "kaleidoscope/key_defs.h"              // for Key, Key_NoKey
 #include "kaleidoscope/plugin.h"                // for Plugin
@@ -93,16 +94,17 @@ class Leader : public kaleidoscope::Plugin {
 
   EventHandlerResult onNameQuery();
   EventHandlerResult onKeyswitchEvent(KeyEvent &event);
-  EventHandlerResult afterEachCycle();
 
  private:
   Key sequence_[LEADER_MAX_SEQUENCE_LENGTH + 1];
   KeyEventTracker event_tracker_;
   uint8_t sequence_pos_;
-  uint16_t start_time_ = 0;
-  uint16_t timeout_    = 1000;
+  uint16_t timeout_ = 1000;
+  Timer timer_{onTimeout};
 
   int8_t lookup();
+  void startTimer();
+  static void onTimeout();
 };
 
 }  // namespace plugin
@@ -104,23 +104,34 @@ EventHandlerResult MouseKeys::onSetup() {
 }
 
 // -----------------------------------------------------------------------------
-EventHandlerResult MouseKeys::afterEachCycle() {
-  if (directions_ == 0)
-    return EventHandlerResult::OK;
+// While any mouse cursor movement keys are held, a new cursor movement report
+// gets sent every `cursor_update_interval_` milliseconds.
+void MouseKeys::onCursorTimeout() {
+  ::MouseKeys.updateCursor();
+}
 
-  // Check timeout for position update interval.
-  if (Runtime.hasTimeExpired(last_cursor_update_time_, cursor_update_interval_)) {
-    sendMouseMoveReport();
-    last_cursor_update_time_ += cursor_update_interval_;
-  }
+void MouseKeys::updateCursor() {
+  if ((directions_ & cursor_mask_) == 0)
+    return;
 
-  // Check timeout for scroll report interval.
-  if (Runtime.hasTimeExpired(last_wheel_update_time_, settings_.wheel_update_interval)) {
-    sendMouseWheelReport();
-    last_wheel_update_time_ += settings_.wheel_update_interval;
-  }
+  sendMouseMoveReport();
+  last_cursor_update_time_ += cursor_update_interval_;
+  Runtime.startTimer(cursor_timer_, last_cursor_update_time_, cursor_update_interval_);
+}
 
-  return EventHandlerResult::OK;
+// -----------------------------------------------------------------------------
+// Likewise for mouse wheel keys, at intervals of `wheel_update_interval`.
+void MouseKeys::onWheelTimeout() {
+  ::MouseKeys.updateWheel();
+}
+
+void MouseKeys::updateWheel() {
+  if ((directions_ & wheel_mask_) == 0)
+    return;
+
+  sendMouseWheelReport();
+  last_wheel_update_time_ += settings_.wheel_update_interval;
+  Runtime.startTimer(wheel_timer_, last_wheel_update_time_, settings_.wheel_update_interval);
 }
 
 // -----------------------------------------------------------------------------
@@ -147,8 +158,8 @@ EventHandlerResult MouseKeys::onKeyEvent(KeyEvent &event) {
   }
 
   // Reports for mouse cursor and wheel movement keys are sent from the
-  // `afterReportingState()` handler (when first toggled on) and
-  // `afterEachCycle()` handler (when held).  We need to return `OK` here so
+  // `afterReportingState()` handler (when first toggled on) and the cursor and
+  // wheel timer callbacks (when held).  We need to return `OK` here so
   // that processing of events for these keys will complete.
   return EventHandlerResult::OK;
 }
@@ -181,9 +192,11 @@ EventHandlerResult MouseKeys::afterReportingState(const KeyEvent &event) {
     if (isMouseMoveKey(event.key)) {
       sendMouseMoveReport();
       last_cursor_update_time_ = Runtime.millisAtCycleStart();
+      Runtime.startTimer(cursor_timer_, cursor_update_interval_);
     } else if (isMouseWheelKey(event.key)) {
       sendMouseWheelReport();
       last_wheel_update_time_ = Runtime.millisAtCycleStart();
+      Runtime.startTimer(wheel_timer_, settings_.wheel_update_interval);
     }
   }
 
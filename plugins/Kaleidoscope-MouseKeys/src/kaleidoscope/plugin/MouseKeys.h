@@ -19,6 +19,7 @@
 #include <stdint.h>  // for uint8_t, uint16_t
 
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
+#include "kaleidoscope/Timer.h"                 // for Timer
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
 #include "kaleidoscope/key_defs.h"              // for Key
 #include "kaleidoscope/plugin.h"                // for Plugin
@@ -137,7 +138,6 @@ class MouseKeys : public kaleidoscope::Plugin {
 
   EventHandlerResult onSetup();
   EventHandlerResult onNameQuery();
-  EventHandlerResult afterEachCycle();
   EventHandlerResult onKeyEvent(KeyEvent &event);
   EventHandlerResult onAddToReport(Key key);
   EventHandlerResult afterReportingState(const KeyEvent &event);
@@ -165,6 +165,8 @@ class MouseKeys : public kaleidoscope::Plugin {
   uint16_t cursor_start_time_      = 0;
   uint8_t last_cursor_update_time_ = 0;
   uint8_t last_wheel_update_time_  = 0;
+  Timer cursor_timer_{onCursorTimeout};
+  Timer wheel_timer_{onWheelTimeout};
 
   // Mouse cursor and wheel movement directions are stored in a single bitfield
   // to save space.  The low four bits are for cursor movement, and the high
@@ -188,6 +190,11 @@ class MouseKeys : public kaleidoscope::Plugin {
   void sendMouseMoveReport() const;
   void sendMouseWheelReport() const;
 
+  static void onCursorTimeout();
+  static void onWheelTimeout();
+  void updateCursor();
+  void updateWheel();
+
   uint8_t accelStep() const;
   uint8_t cursorDelta() const;
 };
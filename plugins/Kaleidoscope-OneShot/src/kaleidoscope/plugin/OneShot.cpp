@@ -315,6 +315,14 @@ EventHandlerResult OneShot::afterEachCycle() {
   return EventHandlerResult::OK;
 }
 
+// ----------------------------------------------------------------------------
+EventHandlerResult OneShot::beforeSleeping() {
+  // Keys in the one-shot or pending states time out in `afterEachCycle()`.
+  if (temp_addrs_.begin() != temp_addrs_.end())
+    return EventHandlerResult::ABORT;
+  return EventHandlerResult::OK;
+}
+
 // ============================================================================
 // Private functions, not exposed to other plugins
 
@@ -197,6 +197,7 @@ class OneShot : public kaleidoscope::Plugin {
   EventHandlerResult onKeyEvent(KeyEvent &event);
   EventHandlerResult afterReportingState(const KeyEvent &event);
   EventHandlerResult afterEachCycle();
+  EventHandlerResult beforeSleeping();
 
   friend class OneShotConfig;
 
@@ -21,13 +21,12 @@
 #include <Kaleidoscope-FocusSerial.h>  // for Focus, FocusSerial
 #include <Kaleidoscope-OneShot.h>      // for OneShot
 
-#include "kaleidoscope/KeyAddr.h"               // for MatrixAddr, MatrixAddr<>::Range, KeyAddr
-#include "kaleidoscope/KeyAddrMap.h"            // for KeyAddrMap<>::Iterator, KeyAddrMap
+#include "kaleidoscope/KeyAddr.h"               // for KeyAddr
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/KeyMap.h"                // for KeyMap
 #include "kaleidoscope/LiveKeys.h"              // for LiveKeys, live_keys
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
-#include "kaleidoscope/key_defs.h"              // for Key, Key_Inactive, Key_Masked
+#include "kaleidoscope/key_defs.h"              // for Key
 #include "kaleidoscope/keyswitch_state.h"       // for INJECTED, keyToggledOff
 
 namespace kaleidoscope {
@@ -53,14 +52,8 @@ EventHandlerResult OneShotMetaKeys::onKeyEvent(KeyEvent &event) {
     // Note: we don't need to explicitly skip the key the active sticky key
     // itself (i.e. `event.addr`), because its entry in `live_keys[]` has not
     // yet been inserted at this point.
-    for (KeyAddr addr : KeyAddr::all()) {
-      // Get the entry from the keyboard state array.
-      Key key = live_keys[addr];
-      // Skip idle and masked entries.
-      if (key == Key_Inactive || key == Key_Masked) {
-        continue;
-      }
-      // Make everything else sticky.
+    // Make every active key sticky.
+    for (KeyAddr addr : live_keys.active()) {
       ::OneShot.setSticky(addr);
     }
     return EventHandlerResult::OK;
@@ -70,7 +63,7 @@ EventHandlerResult OneShotMetaKeys::onKeyEvent(KeyEvent &event) {
   // sticky, unless they were already active, in which case we let OneShot
   // release them from the "sticky" state.
   if (isMetaStickyActive() &&
-      live_keys[event.addr] != event.key) {
+      live_keys.read(event.addr) != event.key) {
     ::OneShot.setSticky(event.addr);
     return EventHandlerResult::OK;
   }
@@ -78,15 +71,15 @@ EventHandlerResult OneShotMetaKeys::onKeyEvent(KeyEvent &event) {
   // If a previously-inactive meta-sticky key was just pressed, we have OneShot
   // put it in the "pending" state so it will act like a OneShot key.
   if (event.key == OneShot_MetaStickyKey &&
-      live_keys[event.addr] != OneShot_MetaStickyKey) {
+      live_keys.read(event.addr) != OneShot_MetaStickyKey) {
     ::OneShot.setPending(event.addr);
   }
   return EventHandlerResult::OK;
 }
 
 bool OneShotMetaKeys::isMetaStickyActive() {
-  for (Key key : live_keys.all()) {
-    if (key == OneShot_MetaStickyKey)
+  for (KeyAddr key_addr : live_keys.active()) {
+    if (live_keys.read(key_addr) == OneShot_MetaStickyKey)
       return true;
   }
   return false;
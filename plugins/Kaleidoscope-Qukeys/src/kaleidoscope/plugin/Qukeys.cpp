@@ -109,6 +109,14 @@ EventHandlerResult Qukeys::afterEachCycle() {
   return EventHandlerResult::OK;
 }
 
+// The queue gets flushed by `afterEachCycle()`, so we need to stay awake until
+// it's empty.
+EventHandlerResult Qukeys::beforeSleeping() {
+  if (!event_queue_.isEmpty())
+    return EventHandlerResult::ABORT;
+  return EventHandlerResult::OK;
+}
+
 
 // -----------------------------------------------------------------------------
 
@@ -156,6 +156,7 @@ class Qukeys : public kaleidoscope::Plugin {
   EventHandlerResult onNameQuery();
   EventHandlerResult onKeyswitchEvent(KeyEvent &event);
   EventHandlerResult afterEachCycle();
+  EventHandlerResult beforeSleeping();
 
  private:
   // An array of Qukey objects in PROGMEM.
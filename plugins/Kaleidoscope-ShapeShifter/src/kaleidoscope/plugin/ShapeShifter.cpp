@@ -19,7 +19,7 @@
 
 #include <stdint.h>  // for uint8_t
 
-#include "kaleidoscope/KeyAddr.h"               // for MatrixAddr, MatrixAddr<>::Range, KeyAddr
+#include "kaleidoscope/KeyAddr.h"               // for KeyAddr
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/LiveKeys.h"              // for LiveKeys, live_keys
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult, EventHandlerResult::OK
@@ -52,8 +52,8 @@ EventHandlerResult ShapeShifter::onKeyEvent(KeyEvent &event) {
 
   bool shift_detected = false;
 
-  for (KeyAddr k : KeyAddr::all()) {
-    if (live_keys[k].isKeyboardShift())
+  for (KeyAddr k : live_keys.active()) {
+    if (live_keys.read(k).isKeyboardShift())
       shift_detected = true;
   }
   if (!shift_detected)
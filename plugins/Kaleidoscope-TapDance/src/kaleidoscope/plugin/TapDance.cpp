@@ -129,54 +129,49 @@ EventHandlerResult TapDance::onKeyswitchEvent(KeyEvent &event) {
   // first entry).
   flushQueue(event.addr);
   event_queue_.append(event);
+  Runtime.startTimer(timer_, event_queue_.timestamp(0), timeout());
   tapDanceAction(td_id, td_addr, ++tap_count_, Tap);
   return EventHandlerResult::ABORT;
 }
 
-EventHandlerResult TapDance::afterEachCycle() {
+void TapDance::onTimeout() {
+  ::TapDance.resolveTimedOut();
+}
+
+void TapDance::resolveTimedOut() {
   // If there's no active TapDance sequence, there's nothing to do.
   if (event_queue_.isEmpty())
-    return EventHandlerResult::OK;
+    return;
 
   // The first event in the queue is now guaranteed to be a TapDance key.
   KeyAddr td_addr = event_queue_.addr(0);
   Key td_key      = Layer.lookupOnActiveLayer(td_addr);
   uint8_t td_id   = td_key.getRaw() - ranges::TD_FIRST;
 
-  // Check for timeout
+  // Check for timeout. The timer is restarted for every new tap, but the
+  // (deprecated) timeout variable could have changed in the meantime.
   uint16_t start_time = event_queue_.timestamp(0);
-  // To avoid confusing editors with unmatched braces, we use a temporary
-  // boolean, until the deprecated code can be removed.
-  bool timed_out = false;
-#ifndef NDEPRECATED
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-  if (Runtime.hasTimeExpired(start_time, time_out))
-    timed_out = true;
-#pragma GCC diagnostic pop
-#else
-  if (Runtime.hasTimeExpired(start_time, timeout_))
-    timed_out = true;
-#endif
-  if (timed_out) {
-    // We start with the assumption that the TapDance key is still being held.
-    ActionType action = Hold;
-    // Now we search for a release event for the TapDance key, starting from the
-    // second event in the queue (the first one being its press event).
-    for (uint8_t i{1}; i < event_queue_.length(); ++i) {
-      // It should be safe to assume that if we find a second event for the same
-      // address, it's a release, so we skip the test for it.
-      if (event_queue_.addr(i) == td_addr) {
-        action = Timeout;
-        // We don't need to bother breaking here because this is basically
-        // guaranteed to be the last event in the queue.
-      }
+  if (!Runtime.hasTimeExpired(start_time, timeout())) {
+    Runtime.startTimer(timer_, start_time, timeout());
+    return;
+  }
+
+  // We start with the assumption that the TapDance key is still being held.
+  ActionType action = Hold;
+  // Now we search for a release event for the TapDance key, starting from the
+  // second event in the queue (the first one being its press event).
+  for (uint8_t i{1}; i < event_queue_.length(); ++i) {
+    // It should be safe to assume that if we find a second event for the same
+    // address, it's a release, so we skip the test for it.
+    if (event_queue_.addr(i) == td_addr) {
+      action = Timeout;
+      // We don't need to bother breaking here because this is basically
+      // guaranteed to be the last event in the queue.
     }
-    tapDanceAction(td_id, td_addr, tap_count_, action);
-    flushQueue();
-    tap_count_ = 0;
   }
-  return EventHandlerResult::OK;
+  tapDanceAction(td_id, td_addr, tap_count_, action);
+  flushQueue();
+  tap_count_ = 0;
 }
 
 }  // namespace plugin
@@ -25,6 +25,7 @@
 #include "kaleidoscope/KeyAddrEventQueue.h"     // for KeyAddrEventQueue
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/KeyEventTracker.h"       // for KeyEventTracker
+#include "kaleidoscope/Timer.h"                 // for Timer
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
 #include "kaleidoscope/key_defs.h"              // for Key
 #include "kaleidoscope/plugin.h"                // for Plugin
@@ -81,7 +82,6 @@ class TapDance : public kaleidoscope::Plugin {
 
   EventHandlerResult onNameQuery();
   EventHandlerResult onKeyswitchEvent(KeyEvent &event);
-  EventHandlerResult afterEachCycle();
 
   static constexpr bool isTapDanceKey(Key key) {
     return (key.getRaw() >= ranges::TD_FIRST &&
@@ -103,7 +103,23 @@ class TapDance : public kaleidoscope::Plugin {
   // Time to wait for another input event before resolving a TapDance sequence.
   uint16_t timeout_ = 200;
 
+  // Expires when the current TapDance sequence times out.
+  Timer timer_{onTimeout};
+
+  uint16_t timeout() const {
+#ifndef NDEPRECATED
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    return time_out;
+#pragma GCC diagnostic pop
+#else
+    return timeout_;
+#endif
+  }
+
   void flushQueue(KeyAddr ignored_addr = KeyAddr::none());
+  void resolveTimedOut();
+  static void onTimeout();
 };
 
 }  // namespace plugin
@@ -20,7 +20,7 @@
 #include <Kaleidoscope-FocusSerial.h>  // for Focus
 #include <Kaleidoscope-Ranges.h>       // for TT_FIRST
 
-#include "kaleidoscope/KeyAddr.h"                         // for KeyAddr, MatrixAddr, MatrixAddr...
+#include "kaleidoscope/KeyAddr.h"                         // for KeyAddr
 #include "kaleidoscope/KeyEvent.h"                        // for KeyEvent
 #include "kaleidoscope/LiveKeys.h"                        // for LiveKeys, live_keys
 #include "kaleidoscope/Runtime.h"                         // for Runtime, Runtime_
@@ -56,14 +56,11 @@ EventHandlerResult TopsyTurvy::onKeyEvent(KeyEvent &event) {
   }
 
   if (tt_addr_.isValid()) {
-    for (KeyAddr key_addr : KeyAddr::all()) {
+    for (KeyAddr key_addr : live_keys.active()) {
       if (key_addr == event.addr)
         continue;
 
-      Key active_key = live_keys[key_addr];
-      if (active_key == Key_Transparent)
-        continue;
-
+      Key active_key = live_keys.read(key_addr);
       if (active_key.isKeyboardKey() && !active_key.isKeyboardModifier()) {
         live_keys.activate(key_addr, Key_NoKey);
       }
@@ -83,8 +80,8 @@ EventHandlerResult TopsyTurvy::beforeReportingState(const KeyEvent &event) {
   // guaranteed to be safe, anyway. Therefore, we assume that if `tt_addr` is
   // valid, it is also the last key pressed.
   bool shift_detected = false;
-  for (KeyAddr key_addr : KeyAddr::all()) {
-    if (live_keys[key_addr].isKeyboardShift()) {
+  for (KeyAddr key_addr : live_keys.active()) {
+    if (live_keys.read(key_addr).isKeyboardShift()) {
       shift_detected = true;
       break;
     }
@@ -22,8 +22,7 @@
 #include <Kaleidoscope-FocusSerial.h>  // for Focus, FocusSerial
 #include <stdint.h>                    // for uint16_t, uint32_t
 
-#include "kaleidoscope/KeyAddr.h"                         // for MatrixAddr, MatrixAddr<>::Range
-#include "kaleidoscope/KeyAddrMap.h"                      // for KeyAddrMap<>::Iterator, KeyAddrMap
+#include "kaleidoscope/KeyAddr.h"                         // for KeyAddr
 #include "kaleidoscope/KeyEvent.h"                        // for KeyEvent
 #include "kaleidoscope/KeyMap.h"                          // for KeyMap
 #include "kaleidoscope/LiveKeys.h"                        // for LiveKeys, live_keys
@@ -119,9 +118,10 @@ EventHandlerResult Turbo::afterEachCycle() {
       // Send the empty report to register the release of all the held keys.
       Runtime.hid().keyboard().sendReport();
 
-      // Go through the `live_keys[]` array and add any Keyboard HID keys to the
-      // new report.
-      for (Key key : live_keys.all()) {
+      // Go through the active entries of the `live_keys[]` array and add any
+      // Keyboard HID keys to the new report.
+      for (KeyAddr key_addr : live_keys.active()) {
+        Key key = live_keys.read(key_addr);
         if (key.isKeyboardKey()) {
           Runtime.addToReport(key);
         }
@@ -134,6 +134,13 @@ EventHandlerResult Turbo::afterEachCycle() {
   return EventHandlerResult::OK;
 }
 
+EventHandlerResult Turbo::beforeSleeping() {
+  // A sticky Turbo key stays active after it's released.
+  if (active_)
+    return EventHandlerResult::ABORT;
+  return EventHandlerResult::OK;
+}
+
 EventHandlerResult Turbo::beforeSyncingLeds() {
   if (flash_ && active_) {
     static bool leds_on = false;
@@ -145,8 +152,8 @@ EventHandlerResult Turbo::beforeSyncingLeds() {
       flash_start_time_ = Runtime.millisAtCycleStart();
       leds_on           = !leds_on;
     }
-    for (KeyAddr key_addr : KeyAddr::all()) {
-      Key key = live_keys[key_addr];
+    for (KeyAddr key_addr : live_keys.active()) {
+      Key key = live_keys.read(key_addr);
       if (key.isKeyboardKey()) {
         LEDControl::setCrgbAt(key_addr, color);
       }
@@ -50,6 +50,7 @@ class Turbo : public kaleidoscope::Plugin {
   EventHandlerResult onNameQuery();
   EventHandlerResult onKeyEvent(KeyEvent &event);
   EventHandlerResult afterEachCycle();
+  EventHandlerResult beforeSleeping();
   EventHandlerResult beforeSyncingLeds();
 
  private:
@@ -119,20 +119,14 @@ class KeyAddrBitfield {
         block_ = bitfield_.data_[block_index_];
         block_ >>= bit_index_;
 
-        // Now we iterate through that block until we either find a bit that is set, or we
-        // find that there are no more bits set. If (as expected most of the time) no bits
-        // are set, we do nothing:
-        while (block_ != 0) {
-          // If the low (remaining) bit is set, generate an `KeyAddr` object from the
-          // bitfield coordinates and store it for the dereference operator to return:
-          if (block_ & 1) {
-            index_ = KeyAddrBitfield::index(block_index_, bit_index_);
-            return true;
-          }
-          // The low bit wasn't set, so we shift the data block by one and track that
-          // shift with the bit coordinate (`bit_index_`):
-          block_ >>= 1;
-          bit_index_ += 1;
+        // If (as expected most of the time) no bits are set, we skip the whole block.
+        // Otherwise, we skip straight to the lowest remaining bit that is set (by
+        // counting the trailing zeros), generate a `KeyAddr` object from the bitfield
+        // coordinates, and store it for the dereference operator to return:
+        if (block_ != 0) {
+          bit_index_ += __builtin_ctz(block_);
+          index_ = KeyAddrBitfield::index(block_index_, bit_index_);
+          return true;
         }
 
         // When we're done checking a block, move on to the next one:
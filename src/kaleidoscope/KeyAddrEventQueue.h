@@ -17,18 +17,34 @@
 
 #pragma once
 
-#include <Arduino.h>  // for bitRead, bitWrite
-#include <stdint.h>   // for uint8_t, uint16_t
+#include <stdint.h>  // for uint8_t, uint16_t, uint32_t, uint64_t
 //#include <assert.h>
 
-#include "kaleidoscope/KeyAddr.h"          // for KeyAddr
-#include "kaleidoscope/KeyEvent.h"         // for KeyEvent, KeyEventId
-#include "kaleidoscope/Runtime.h"          // for Runtime, Runtime_
-#include "kaleidoscope/key_defs.h"         // for Key_Undefined
-#include "kaleidoscope/keyswitch_state.h"  // for IS_PRESSED, WAS_PRESSED, keyToggledOff
+#include "kaleidoscope/KeyAddr.h"                         // for KeyAddr
+#include "kaleidoscope/KeyEvent.h"                        // for KeyEvent, KeyEventId
+#include "kaleidoscope/Runtime.h"                         // for Runtime, Runtime_
+#include "kaleidoscope/key_defs.h"                        // for Key_Undefined
+#include "kaleidoscope/keyswitch_state.h"                 // for IS_PRESSED, WAS_PRESSED, keyToggledOff
+#include "kaleidoscope_internal/type_traits/type_traits"  // IWYU pragma: keep
+// IWYU pragma: no_include <type_traits>
 
 namespace kaleidoscope {
 
+// The smallest unsigned integer type with at least one bit for each entry of a
+// queue with the given capacity. Capacities of up to 64 entries are supported.
+template<uint8_t _capacity>
+struct KeyAddrEventQueueBitfield {
+  static_assert(_capacity <= 64,
+                "EventQueue error: _capacity too large (max 64)!");
+
+  typedef typename std::conditional<
+    (_capacity <= 8), uint8_t,
+    typename std::conditional<
+      (_capacity <= 16), uint16_t,
+      typename std::conditional<
+        (_capacity <= 32), uint32_t, uint64_t>::type>::type>::type Type;
+};
+
 // This class defines a keyswitch event queue that stores both press and release
 // events, recording the key address, a timestamp, and the keyswitch state
 // (press or release). It is optimized for random access to the queue entries,
@@ -37,9 +53,9 @@ namespace kaleidoscope {
 // plugin. Its performance is better for a queue that needs to be searched much
 // more frequently than entries are added or removed.
 template<uint8_t _capacity,
-         typename _Bitfield  = uint8_t,
+         typename _Bitfield  = typename KeyAddrEventQueueBitfield<_capacity>::Type,
          typename _Timestamp = uint16_t>
-class KeyAddrEventQueue {
+class ShiftingKeyAddrEventQueue {
 
   static_assert(_capacity <= (sizeof(_Bitfield) * 8),
                 "EventQueue error: _Bitfield type too small for _capacity!");
@@ -82,7 +98,7 @@ class KeyAddrEventQueue {
 
   bool isRelease(uint8_t index) const {
     // assert(index < length_);
-    return bitRead(release_event_bits_, index);
+    return (release_event_bits_ >> index) & 1;
   }
   bool isPress(uint8_t index) const {
     // assert(index < length_);
@@ -96,7 +112,12 @@ class KeyAddrEventQueue {
     event_ids_[length_]  = event.id();
     addrs_[length_]      = event.addr;
     timestamps_[length_] = Runtime.millisAtCycleStart();
-    bitWrite(release_event_bits_, length_, keyToggledOff(event.state));
+    _Bitfield bit        = _Bitfield(1) << length_;
+    if (keyToggledOff(event.state)) {
+      release_event_bits_ |= bit;
+    } else {
+      release_event_bits_ &= ~bit;
+    }
     ++length_;
   }
 
@@ -115,7 +136,7 @@ class KeyAddrEventQueue {
       timestamps_[i] = timestamps_[i + 1];
     }
     // mask = all ones for bits >= n, zeros otherwise
-    _Bitfield mask = _Bitfield(~0) << n;
+    _Bitfield mask = _Bitfield(~_Bitfield(0)) << n;
     // use the inverse mask to get just the low bits (that won't be shifted)
     _Bitfield low_bits = release_event_bits_ & ~mask;
     // shift the event bits
@@ -137,6 +158,7 @@ class KeyAddrEventQueue {
     }
     length_ -= n;
     for (uint8_t i{0}; i < length_; ++i) {
+      event_ids_[i]  = event_ids_[i + n];
       addrs_[i]      = addrs_[i + n];
       timestamps_[i] = timestamps_[i + n];
     }
@@ -171,4 +193,175 @@ class KeyAddrEventQueue {
   }
 };
 
+// This class has the same interface and storage layout as
+// `ShiftingKeyAddrEventQueue`, but the entries are stored in a ring buffer, so
+// removing events from the head of the queue (which is what plugins do when
+// they flush their queues) doesn't need to move any of the other entries. The
+// price for that is a little bit of index arithmetic on every access to an
+// entry. Removing an entry from the middle of the queue moves the entries on
+// whichever side of it is shorter.
+template<uint8_t _capacity,
+         typename _Bitfield  = typename KeyAddrEventQueueBitfield<_capacity>::Type,
+         typename _Timestamp = uint16_t>
+class RingKeyAddrEventQueue {
+
+  static_assert(_capacity <= (sizeof(_Bitfield) * 8),
+                "EventQueue error: _Bitfield type too small for _capacity!");
+
+ private:
+  uint8_t head_{0};
+  uint8_t length_{0};
+  KeyEventId event_ids_[_capacity];   // NOLINT(runtime/arrays)
+  KeyAddr addrs_[_capacity];          // NOLINT(runtime/arrays)
+  _Timestamp timestamps_[_capacity];  // NOLINT(runtime/arrays)
+  // The release bits are indexed by storage slot, not by queue position, so
+  // they don't need to be shifted either.
+  _Bitfield release_event_bits_;
+
+  // Translate a queue position to a storage slot.
+  uint8_t slot(uint8_t index) const {
+    uint8_t s = head_ + index;
+    if (s >= _capacity)
+      s -= _capacity;
+    return s;
+  }
+
+  bool releaseBit(uint8_t s) const {
+    return (release_event_bits_ >> s) & 1;
+  }
+  void setReleaseBit(uint8_t s, bool release) {
+    _Bitfield bit = _Bitfield(1) << s;
+    if (release) {
+      release_event_bits_ |= bit;
+    } else {
+      release_event_bits_ &= ~bit;
+    }
+  }
+
+  void copySlot(uint8_t to, uint8_t from) {
+    event_ids_[to]  = event_ids_[from];
+    addrs_[to]      = addrs_[from];
+    timestamps_[to] = timestamps_[from];
+    setReleaseBit(to, releaseBit(from));
+  }
+
+ public:
+  uint8_t length() const {
+    return length_;
+  }
+  bool isEmpty() const {
+    return (length_ == 0);
+  }
+  bool isFull() const {
+    return (length_ == _capacity);
+  }
+
+  // Queue entry access methods. Note: the caller is responsible for bounds
+  // checking, because it's expected that a for loop will be used when searching
+  // the queue, which will terminate when `index >= queue.length()`.
+  KeyEventId id(uint8_t index) const {
+    // assert(index < length_);
+    return event_ids_[slot(index)];
+  }
+
+  KeyAddr addr(uint8_t index) const {
+    // assert(index < length_);
+    return addrs_[slot(index)];
+  }
+
+  _Timestamp timestamp(uint8_t index) const {
+    // assert(index < length_);
+    return timestamps_[slot(index)];
+  }
+
+  bool isRelease(uint8_t index) const {
+    // assert(index < length_);
+    return releaseBit(slot(index));
+  }
+  bool isPress(uint8_t index) const {
+    // assert(index < length_);
+    return !isRelease(index);
+  }
+
+  // Append a new event on the end of the queue. Note: the caller is responsible
+  // for bounds checking; we don't guard against it here.
+  void append(const KeyEvent &event) {
+    // assert(length_ < _capacity);
+    uint8_t s      = slot(length_);
+    event_ids_[s]  = event.id();
+    addrs_[s]      = event.addr;
+    timestamps_[s] = Runtime.millisAtCycleStart();
+    setReleaseBit(s, keyToggledOff(event.state));
+    ++length_;
+  }
+
+  // Remove an event from the queue. Removing the head of the queue is just a
+  // matter of moving the head index.
+  void remove(uint8_t n = 0) {
+    if (n >= length_ || length_ == 0)
+      return;
+    // assert(length > n);
+    if (n < length_ / 2) {
+      // Move the preceding entries one slot towards the tail.
+      for (uint8_t i{n}; i > 0; --i)
+        copySlot(slot(i), slot(i - 1));
+      head_ = slot(1);
+    } else {
+      // Move the subsequent entries one slot towards the head.
+      for (uint8_t i{n}; i + 1 < length_; ++i)
+        copySlot(slot(i), slot(i + 1));
+    }
+    --length_;
+  }
+
+  void shift() {
+    remove(0);
+  }
+
+  void shift(uint8_t n) {
+    if (n >= length_) {
+      clear();
+      return;
+    }
+    head_ = slot(n);
+    length_ -= n;
+  }
+
+  // Empty the queue entirely.
+  void clear() {
+    head_   = 0;
+    length_ = 0;
+  }
+
+  KeyEvent event(uint8_t i) const {
+    uint8_t state = isRelease(i) ? WAS_PRESSED : IS_PRESSED;
+    return KeyEvent{addr(i), state, Key_Undefined, id(i)};
+  }
+
+  // Only call this after `KeyEventTracker::shouldIgnore()` returns `true`.
+  bool shouldAbort(const KeyEvent &event) const {
+    // If the queue is empty, don't abort.
+    if (length_ == 0)
+      return false;
+    // See `ShiftingKeyAddrEventQueue::shouldAbort()`.
+    KeyEventId offset = event.id() - event_ids_[head_];
+    return offset >= 0;
+  }
+};
+
+// The queue implementation used by plugins. Define
+// `KALEIDOSCOPE_RING_BUFFER_EVENT_QUEUE` to use the ring buffer instead of the
+// shifting queue.
+#ifdef KALEIDOSCOPE_RING_BUFFER_EVENT_QUEUE
+template<uint8_t _capacity,
+         typename _Bitfield  = typename KeyAddrEventQueueBitfield<_capacity>::Type,
+         typename _Timestamp = uint16_t>
+using KeyAddrEventQueue = RingKeyAddrEventQueue<_capacity, _Bitfield, _Timestamp>;
+#else
+template<uint8_t _capacity,
+         typename _Bitfield  = typename KeyAddrEventQueueBitfield<_capacity>::Type,
+         typename _Timestamp = uint16_t>
+using KeyAddrEventQueue = ShiftingKeyAddrEventQueue<_capacity, _Bitfield, _Timestamp>;
+#endif
+
 }  // namespace kaleidoscope
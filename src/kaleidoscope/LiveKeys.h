@@ -16,13 +16,17 @@
 
 #pragma once
 
-#include "kaleidoscope/KeyAddr.h"     // for KeyAddr
-#include "kaleidoscope/KeyAddrMap.h"  // for KeyAddrMap<>::Iterator, KeyAddrMap
+#include "kaleidoscope/KeyAddr.h"          // for KeyAddr
+#include "kaleidoscope/KeyAddrBitfield.h"  // for KeyAddrBitfield
+#include "kaleidoscope/KeyAddrMap.h"       // for KeyAddrMap<>::Iterator, KeyAddrMap
 #include "kaleidoscope/KeyMap.h"      // for KeyMap
 #include "kaleidoscope/key_defs.h"    // for Key, Key_Masked, Key_Inactive
 
 namespace kaleidoscope {
 
+// Forward declaration to enable friend declaration.
+class Runtime_;  // IWYU pragma: keep
+
 /// A representation of the "live" state of the keys on the keyboard
 ///
 /// This is structure of `Key` values, indexed by `KeyAddr` values, with one
@@ -41,6 +45,14 @@ namespace kaleidoscope {
 /// engaged), and the `Key` value is what the that key is "sending" at the
 /// time. At the end of its processing of a `KeyEvent`, Kaleidoscope will use
 /// the contents of this array to populate the Keyboard HID reports.
+///
+/// Usually, only a handful of keys are active at any given time, so
+/// `LiveKeys` keeps a bitfield alongside the array that marks the entries that
+/// might be active (i.e. those that are neither `Key_Inactive` nor
+/// `Key_Masked`). It is kept up to date by `activate()`, `clear()` & `mask()`,
+/// so those functions should be preferred over writing entries directly. Code
+/// that needs to find the active keys should use `active()` to visit only those
+/// entries, rather than checking all of them.
 
 class LiveKeys {
  public:
@@ -54,32 +66,49 @@ class LiveKeys {
   }
 
   // For array-style subscript addressing of entries by reference. The client
-  // code can alter values in the array this way.
+  // code can alter values in the array this way. Because we can't know what
+  // will be written through the reference, the entry is (conservatively) marked
+  // as active; if it turns out to be inactive, it will get dropped from the
+  // index the next time a report is built. Code that only reads entries should
+  // use `read()` (or a `const` reference) instead, which leaves the index be.
   Key &operator[](KeyAddr key_addr) {
     if (key_addr.isValid()) {
+      active_.set(key_addr);
       return key_map_[key_addr];
     }
     dummy_ = Key_Masked;
     return dummy_;
   }
 
+  /// Returns the entry for `key_addr`, without touching the index of active
+  /// entries, the way reading through the non-`const` `operator[]` would.
+  const Key &read(KeyAddr key_addr) const {
+    return (*this)[key_addr];
+  }
+
   /// Set an entry to "active" with a specified `Key` value.
   void activate(KeyAddr key_addr, Key key) {
-    if (key_addr.isValid())
+    if (key_addr.isValid()) {
       key_map_[key_addr] = key;
+      active_.write(key_addr, (key != Key_Inactive && key != Key_Masked));
+    }
   }
 
   /// Deactivate an entry by setting its value to `Key_Inactive`.
   void clear(KeyAddr key_addr) {
-    if (key_addr.isValid())
+    if (key_addr.isValid()) {
       key_map_[key_addr] = Key_Inactive;
+      active_.clear(key_addr);
+    }
   }
 
   /// Mask a key by setting its entry to `Key_Masked`. The key will become
   /// unmasked by Kaleidoscope on release (but not on a key press event).
   void mask(KeyAddr key_addr) {
-    if (key_addr.isValid())
+    if (key_addr.isValid()) {
       key_map_[key_addr] = Key_Masked;
+      active_.clear(key_addr);
+    }
   }
 
   /// Clear the entire array by setting all values to `Key_Inactive`.
@@ -87,18 +116,93 @@ class LiveKeys {
     for (Key &key : key_map_) {
       key = Key_Inactive;
     }
+    active_.clear();
   }
 
   /// Returns an iterator for use in range-based for loops:
   ///
   ///   for (Key key : live_keys.all()) {...}
+  ///
+  /// The entries should be treated as read-only; use `activate()`, `clear()` or
+  /// `mask()` to change them.
   KeyMap &all() {
     return key_map_;
   }
 
+  // ---------------------------------------------------------------------------
+  // Iterator over the active entries, in ascending `KeyAddr` order
+  class ActiveKeys {
+   public:
+    class Iterator {
+     public:
+      Iterator(const LiveKeys &live_keys, KeyAddrBitfield::Iterator position)
+        : live_keys_(live_keys), position_(position) {}
+
+      bool operator!=(const Iterator &other) {
+        // The index can have stray bits set (see `operator[]` above), so we
+        // check the entries themselves, and skip the ones that aren't active.
+        while (position_ != other.position_) {
+          Key key = live_keys_.key_map_[*position_];
+          if (key != Key_Inactive && key != Key_Masked)
+            return true;
+          ++position_;
+        }
+        return false;
+      }
+
+      KeyAddr operator*() {
+        return *position_;
+      }
+
+      void operator++() {
+        ++position_;
+      }
+
+     private:
+      const LiveKeys &live_keys_;
+      KeyAddrBitfield::Iterator position_;
+    };
+
+    explicit ActiveKeys(const LiveKeys &live_keys)
+      : live_keys_(live_keys) {}
+
+    Iterator begin() const {
+      return Iterator{live_keys_, live_keys_.active_.begin()};
+    }
+    Iterator end() const {
+      return Iterator{live_keys_, live_keys_.active_.end()};
+    }
+
+   private:
+    const LiveKeys &live_keys_;
+  };
+
+  /// Returns an iterator for use in range-based for loops that visits only the
+  /// addresses of active entries (i.e. those that are neither `Key_Inactive`
+  /// nor `Key_Masked`):
+  ///
+  ///   for (KeyAddr key_addr : live_keys.active()) {...}
+  ///
+  /// Entries can be changed with `activate()`, `clear()` or `mask()` while
+  /// iterating; an entry further along that gets activated will be visited.
+  ActiveKeys active() const {
+    return ActiveKeys{*this};
+  }
+
+  /// The index `active()` goes by: the addresses of the entries that might be
+  /// active. It's a superset of those, which the likes of `read()` don't grow.
+  const KeyAddrBitfield &activeIndex() const {
+    return active_;
+  }
+
  private:
   KeyMap key_map_;
+  // Entries that might be active. This is allowed to be a superset of the real
+  // thing, but never a subset.
+  KeyAddrBitfield active_;
   mutable Key dummy_{0, 0};
+
+  friend class Runtime_;
 };
 
 extern LiveKeys live_keys;
@@ -22,6 +22,7 @@
 #include "kaleidoscope/KeyAddr.h"                   // for KeyAddr, MatrixAddr, MatrixAddr...
 #include "kaleidoscope/KeyEvent.h"                  // for KeyEvent
 #include "kaleidoscope/LiveKeys.h"                  // for LiveKeys, live_keys
+#include "kaleidoscope/Timer.h"                     // for Timer
 #include "kaleidoscope/device/device.h"             // for Base<>::HID, VirtualProps::HID
 #include "kaleidoscope/driver/hid/base/Keyboard.h"  // for Keyboard
 #include "kaleidoscope/keyswitch_state.h"           // for keyToggledOff, keyToggledOn
@@ -31,6 +32,10 @@ namespace kaleidoscope {
 
 uint32_t Runtime_::millis_at_cycle_start_;
 KeyAddr Runtime_::last_addr_toggled_on_ = KeyAddr::none();
+bool Runtime_::held_keyswitch_events_enabled_;
+Timer *Runtime_::timers_;
+Timer *Runtime_::expired_timers_;
+uint8_t Runtime_::idle_sleep_interval_;
 
 static void onUSBReset();
 
@@ -82,7 +87,111 @@ void Runtime_::loop(void) {
   // event is being handled at a time.
   device().scanMatrix();
 
+  // Held keyswitches don't produce any events unless a plugin has asked for
+  // them.
+  if (held_keyswitch_events_enabled_)
+    handleHeldKeyswitches();
+
+  // Call the callbacks of any timers that have reached their deadlines before
+  // the `afterEachCycle()` handlers, which is where plugins used to check for
+  // their timeouts.
+  handleExpiredTimers();
+
   kaleidoscope::Hooks::afterEachCycle();
+
+  if (idle_sleep_interval_ != 0)
+    sleepUntilNextDeadline();
+}
+
+// ----------------------------------------------------------------------------
+void Runtime_::sleepUntilNextDeadline() {
+  // Held keyswitches may be of interest to plugins in every cycle, so we only
+  // sleep while none are pressed, and only if no plugin objects.
+  if (device().pressedKeyswitchCount() != 0)
+    return;
+  if (Hooks::beforeSleeping() != EventHandlerResult::OK)
+    return;
+
+  uint32_t deadline = millis_at_cycle_start_ + idle_sleep_interval_;
+  if (timers_ != nullptr && int32_t(timers_->deadline_ - deadline) < 0)
+    deadline = timers_->deadline_;
+
+  // If the next deadline is due in the next cycle anyway, there's no point.
+  if (int32_t(deadline - millis_at_cycle_start_) <= 1)
+    return;
+
+  device().sleepUntil(deadline);
+}
+
+// ----------------------------------------------------------------------------
+void Runtime_::scheduleTimer(Timer &timer, uint32_t deadline) {
+  stopTimer(timer);
+
+  timer.deadline_ = deadline;
+  timer.pending_  = true;
+
+  // Timers with equal deadlines expire in the order they were started, so the
+  // new one goes after any that aren't due before it.
+  Timer **link = &timers_;
+  while (*link != nullptr &&
+         int32_t((*link)->deadline_ - deadline) <= 0)
+    link = &(*link)->next_;
+  timer.next_ = *link;
+  *link       = &timer;
+}
+
+// ----------------------------------------------------------------------------
+void Runtime_::stopTimer(Timer &timer) {
+  if (!timer.pending_)
+    return;
+  timer.pending_ = false;
+
+  // The timer is either still waiting in the sorted list, or it's due, and
+  // about to be dispatched by `handleExpiredTimers()`.
+  Timer **lists[] = {&timers_, &expired_timers_};
+  for (Timer **list : lists) {
+    for (Timer **link = list; *link != nullptr; link = &(*link)->next_) {
+      if (*link == &timer) {
+        *link       = timer.next_;
+        timer.next_ = nullptr;
+        return;
+      }
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+void Runtime_::handleExpiredTimers() {
+  // First, move all the timers that are due off of the pending list. That way,
+  // a callback that restarts its own timer with a deadline that has already
+  // passed won't get called again until the next cycle.
+  Timer **link = &timers_;
+  while (*link != nullptr &&
+         int32_t(millis_at_cycle_start_ - (*link)->deadline_) >= 0)
+    link = &(*link)->next_;
+
+  if (link == &timers_)
+    return;
+
+  expired_timers_ = timers_;
+  timers_         = *link;
+  *link           = nullptr;
+
+  while (expired_timers_ != nullptr) {
+    Timer *timer    = expired_timers_;
+    expired_timers_ = timer->next_;
+    timer->next_    = nullptr;
+    timer->pending_ = false;
+    timer->callback_();
+  }
+}
+
+// ----------------------------------------------------------------------------
+void Runtime_::handleHeldKeyswitches() {
+  for (KeyAddr key_addr : KeyAddr::all()) {
+    if (device().isKeyswitchPressed(key_addr))
+      kaleidoscope::Hooks::onKeyswitchHeld(key_addr);
+  }
 }
 
 // ----------------------------------------------------------------------------
@@ -102,7 +211,7 @@ void Runtime_::handleKeyswitchEvent(KeyEvent event) {
   if (keyToggledOff(event.state)) {
     // When a key toggles off, set the event's key value to whatever the key's
     // current value is in the live keys state array.
-    event.key = live_keys[event.addr];
+    event.key = live_keys.read(event.addr);
     // If that key was masked, unmask it and return.
     if (event.key == Key_Masked) {
       live_keys.clear(event.addr);
@@ -204,24 +313,28 @@ void Runtime_::prepareKeyboardReport(const KeyEvent &event) {
   // before building the new report, start clean
   device().hid().keyboard().releaseAllKeys();
 
-  // Build report from composite keymap cache. This can be much more efficient
-  // with a bitfield. What we should be doing here is going through the array
-  // and checking for HID values (Keyboard, Consumer, System) and directly
-  // adding them to their respective reports. This comes before the old plugin
-  // hooks are called for the new event so that the report will be full complete
-  // except for that new event.
-  for (KeyAddr key_addr : KeyAddr::all()) {
+  // Build report from composite keymap cache. Rather than checking every entry
+  // in the `live_keys` array, we only visit the ones in its index of entries
+  // that might be active, in the same (ascending) order, so the resulting
+  // report (and the sequence of `onAddToReport()` calls) is the same as it would
+  // be if we walked the whole array. This comes before the old plugin hooks are
+  // called for the new event so that the report will be full complete except
+  // for that new event.
+  for (KeyAddr key_addr : live_keys.active_) {
     // Skip this event's key addr; we will deal with that later. This is most
     // important in the case of a key release, because we can't safely remove
     // any keycode(s) added to the report later.
     if (key_addr == event.addr)
       continue;
 
-    Key key = live_keys[key_addr];
+    Key key = live_keys.key_map_[key_addr];
 
-    // If the key is idle or masked, we can ignore it.
-    if (key == Key_Inactive || key == Key_Masked)
+    // If the key is idle or masked, we can ignore it. It got into the index
+    // through a direct write to `live_keys[]`, so we drop it now.
+    if (key == Key_Inactive || key == Key_Masked) {
+      live_keys.active_.clear(key_addr);
       continue;
+    }
 
     addToReport(key);
   }
@@ -286,7 +399,7 @@ void Runtime_::sendKeyboardReport(const KeyEvent &event) {
     }
   } else if (event.addr != last_addr_toggled_on_) {
     // (not a keyboard key OR toggled off) AND not last keyboard key toggled on
-    Key last_key = live_keys[last_addr_toggled_on_];
+    Key last_key = live_keys.read(last_addr_toggled_on_);
     if (last_key.isKeyboardKey()) {
       hid().keyboard().pressModifiers(last_key);
     }
@@ -21,6 +21,7 @@
 #include "kaleidoscope/KeyAddr.h"               // for KeyAddr
 #include "kaleidoscope/KeyEvent.h"              // for KeyEvent
 #include "kaleidoscope/LiveKeys.h"              // for LiveKeys, live_keys
+#include "kaleidoscope/Timer.h"                 // for Timer
 #include "kaleidoscope/device/device.h"         // for Device
 #include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
 #include "kaleidoscope/hooks.h"                 // for Hooks
@@ -83,6 +84,8 @@ class Runtime_ {
   }
 
   void rebootBootloader() {
+    // Write-back storage drivers may still be holding changes back.
+    device().storage().flush();
     device().rebootBootloader();
   }
 
@@ -132,10 +135,54 @@ class Runtime_ {
     return (elapsed_time >= ttl);
   }
 
+  /** Start a timer
+   *
+   * Registers `timer` with the timer service, so that its callback function
+   * gets called once `timeout` milliseconds have elapsed since `start_time`,
+   * with the same semantics as `hasTimeExpired(start_time, timeout)`. This is
+   * meant to replace checking `hasTimeExpired()` in every cycle: the callback
+   * is only called when the deadline has been reached, and plugins don't need a
+   * per-cycle hook at all to handle timeouts.
+   *
+   * If the timer was already pending, it is restarted with the new deadline. If
+   * the deadline has already passed, the callback will be called at the end of
+   * the current cycle (or the next one, if the timer was started from a timer
+   * callback).
+   */
+  template<typename _Timestamp, typename _Timeout>
+  static void startTimer(Timer &timer, _Timestamp start_time, _Timeout timeout) {
+    _Timestamp elapsed_time = millis_at_cycle_start_ - start_time;
+    scheduleTimer(timer, millis_at_cycle_start_ - elapsed_time + timeout);
+  }
+
+  /** Start a timer that expires `timeout` milliseconds from the current cycle's
+   * start time.
+   */
+  template<typename _Timeout>
+  static void startTimer(Timer &timer, _Timeout timeout) {
+    scheduleTimer(timer, millis_at_cycle_start_ + timeout);
+  }
+
+  /** Stop a pending timer, without calling its callback function.
+   *
+   * It is safe to call this for a timer that isn't pending.
+   */
+  static void stopTimer(Timer &timer);
+
   EventHandlerResult onFocusEvent(const char *input) {
     return kaleidoscope::Hooks::onFocusEvent(input);
   }
 
+  /** Tell the plugins that the contents of storage were replaced
+   *
+   * To be called after writing to storage directly, in a way the plugins that
+   * use it don't know about, so that they can reload whatever they keep of it
+   * in RAM.
+   */
+  EventHandlerResult onStorageChange() {
+    return kaleidoscope::Hooks::onStorageChange();
+  }
+
   /** Handle a physical keyswitch event
    *
    * This method is called in response to physical keyswitch state changes. Its
@@ -155,6 +202,34 @@ class Runtime_ {
    */
   void handleKeyswitchEvent(KeyEvent event);
 
+  /** Opt in to per-cycle events for held keyswitches
+   *
+   * Keyscanners only report keyswitches that toggle on or off, so holding keys
+   * down costs nothing from one cycle to the next. A plugin that needs to act
+   * on every cycle that a keyswitch is held can call this method (usually from
+   * its `onSetup()` handler). From then on, the `onKeyswitchHeld()` plugin
+   * handlers get called once per cycle, after the keyswitches have been
+   * scanned, for every keyswitch that is pressed at that point. This includes
+   * the cycle in which the keyswitch toggled on.
+   */
+  void enableHeldKeyswitchEvents() {
+    held_keyswitch_events_enabled_ = true;
+  }
+
+  /** Let the keyboard sleep between cycles while it's idle
+   *
+   * By default, the main loop runs continuously, even when nothing is
+   * happening. When idle sleep is enabled, at the end of any cycle in which no
+   * keyswitches are pressed, and no plugin's `beforeSleeping()` handler returns
+   * `ABORT`, the MCU is put to sleep until the next timer deadline, or for at
+   * most `interval` milliseconds. The interval thus limits how long it can take
+   * the keyboard to notice a keypress while idle, unless the device can be
+   * woken up by one. An interval of zero (the default) disables idle sleep.
+   */
+  void setIdleSleepInterval(uint8_t interval) {
+    idle_sleep_interval_ = interval;
+  }
+
   /** Handle a logical key event
    *
    * This method triggers the handling of a logical "key event". Ususally that
@@ -201,7 +276,7 @@ class Runtime_ {
    */
   Key lookupKey(KeyAddr key_addr) {
     // First, check for an active key value in the `live_keys` array.
-    Key key = live_keys[key_addr];
+    Key key = live_keys.read(key_addr);
     // If that entry is clear, look up the entry from the active keymap layers.
     if (key == Key_Transparent) {
       key = Layer.lookupOnActiveLayer(key_addr);
@@ -212,6 +287,15 @@ class Runtime_ {
  private:
   static uint32_t millis_at_cycle_start_;
   static KeyAddr last_addr_toggled_on_;
+  static bool held_keyswitch_events_enabled_;
+  static Timer *timers_;
+  static Timer *expired_timers_;
+  static uint8_t idle_sleep_interval_;
+
+  void handleHeldKeyswitches();
+  void sleepUntilNextDeadline();
+  static void scheduleTimer(Timer &timer, uint32_t deadline);
+  static void handleExpiredTimers();
 };
 
 extern kaleidoscope::Runtime_ Runtime;
@@ -0,0 +1,57 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint32_t
+
+namespace kaleidoscope {
+
+/// A deadline that can be registered with the central timer service
+///
+/// Instead of checking `Runtime.hasTimeExpired()` in a per-cycle hook, a plugin
+/// can own a `Timer` (usually as a member variable), and start it with
+/// `Runtime.startTimer()`. When the deadline is reached, `Runtime` calls the
+/// timer's callback function once, at the end of the cycle, just before the
+/// `afterEachCycle()` plugin handlers are called. To get called repeatedly, the
+/// callback function needs to restart the timer itself.
+///
+/// Pending timers are kept in an intrusive list, sorted by deadline, so the
+/// service doesn't need any storage of its own, and checking for expired timers
+/// only ever needs to look at the first one.
+class Timer {
+ public:
+  typedef void (*Callback)();
+
+  explicit constexpr Timer(Callback callback)
+    : callback_(callback) {}
+
+  /// Returns `true` if the timer has been started, and hasn't yet expired or
+  /// been stopped.
+  bool isPending() const {
+    return pending_;
+  }
+
+ private:
+  friend class Runtime_;
+
+  Callback callback_;
+  uint32_t deadline_ = 0;
+  Timer *next_       = nullptr;
+  bool pending_      = false;
+};
+
+}  // namespace kaleidoscope
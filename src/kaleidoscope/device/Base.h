@@ -28,7 +28,7 @@
 
 #include "kaleidoscope/driver/bootloader/None.h"  // for None
 #include "kaleidoscope/driver/hid/Base.h"         // for Base, BaseProps
-#include "kaleidoscope/driver/keyscanner/Base.h"  // for BaseProps
+#include "kaleidoscope/driver/keyscanner/Base.h"  // for BaseProps, ScanRateSettings
 #include "kaleidoscope/driver/keyscanner/None.h"  // for None
 #include "kaleidoscope/driver/led/None.h"         // for cRGB, BaseProps, CRGB, None
 #include "kaleidoscope/driver/mcu/Base.h"         // for BaseProps
@@ -271,6 +271,31 @@ class Base {
   void actOnMatrixScan(void) {
     key_scanner_.actOnMatrixScan();
   }
+  /**
+   * Returns the scan rate settings of the key scanner.
+   *
+   * Key scanners that don't support changing their scan rate return all-zero
+   * settings.
+   */
+  driver::keyscanner::ScanRateSettings scanRate() {
+    return key_scanner_.scanRate();
+  }
+  /**
+   * Change the scan rate settings of the key scanner.
+   *
+   * @param settings are the scan intervals (in microseconds) to use while keys
+   * are in use and while idle, and the time without activity (in milliseconds)
+   * after which the key scanner switches to the idle interval.
+   */
+  void setScanRate(const driver::keyscanner::ScanRateSettings &settings) {
+    key_scanner_.setScanRate(settings);
+  }
+  /**
+   * Returns the current scan interval of the key scanner, in microseconds.
+   */
+  uint16_t scanInterval() {
+    return key_scanner_.scanInterval();
+  }
   /** @} */
 
   /** @defgroup kaleidoscope_hardware_reattach Kaleidoscope::Hardware/Attach & Detach
@@ -323,6 +348,18 @@ class Base {
     mcu_.setUSBResetHook(hook);
   }
 
+  /**
+   * Put the MCU to sleep until `deadline` (a `millis()` timestamp).
+   *
+   * Called by `Runtime` between cycles while the keyboard is idle. The MCU may
+   * wake up early, for example on a USB or pin-change interrupt.
+   *
+   * @param deadline the `millis()` timestamp at which to wake up
+   */
+  void sleepUntil(uint32_t deadline) {
+    mcu_.sleepUntil(deadline);
+  }
+
   /**
    * @defgroup kaleidoscope_hardware_keyswitch_state Kaleidoscope::Hardware/Key-switch state
    *
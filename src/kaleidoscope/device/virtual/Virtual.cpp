@@ -32,10 +32,11 @@
 
 // From Kaleidoscope:
 #include "kaleidoscope/KeyAddr.h"                                  // for MatrixAddr, MatrixAddr...
+#include "kaleidoscope/Runtime.h"                                  // for Runtime, Runtime_
 #include "kaleidoscope/device/virtual/DefaultHIDReportConsumer.h"  // for DefaultHIDReportConsumer
 #include "kaleidoscope/device/virtual/Logging.h"                   // for log_error, logging
 #include "kaleidoscope/key_defs.h"                                 // for Key_NoKey
-#include "kaleidoscope/keyswitch_state.h"                          // for IS_PRESSED, WAS_PRESSED
+#include "kaleidoscope/keyswitch_state.h"                          // for IS_PRESSED, WAS_PRESSED, keyToggledOff, keyToggledOn
 
 // FIXME: This relates to virtual/cores/arduino/EEPROM.h.
 //        EEPROM static data must be defined here as only
@@ -260,7 +261,8 @@ void VirtualKeyScanner::actOnMatrixScan() {
       break;
     }
 
-    if (key_state != 0)
+    // Only keyswitches that toggled on or off produce events.
+    if (keyToggledOn(key_state) || keyToggledOff(key_state))
       handleKeyswitchEvent(Key_NoKey, key_addr, key_state);
     keystates_prev_[key_addr.toInt()] = keystates_[key_addr.toInt()];
 
@@ -271,6 +273,15 @@ void VirtualKeyScanner::actOnMatrixScan() {
       keystates_prev_[key_addr.toInt()] = KeyState::NotPressed;
     }
   }
+
+  scan_rate_.update(n_pressed_switches_ != 0, Runtime.millisAtCycleStart());
+  if (wakeup_enabled_ && scan_rate_.isIdle())
+    wakeup_.arm();
+}
+
+void VirtualKeyScanner::setScanRate(const driver::keyscanner::ScanRateSettings &settings) {
+  scan_rate_.setSettings(settings, Runtime.millisAtCycleStart());
+  wakeup_.disarm();
 }
 
 uint8_t VirtualKeyScanner::pressedKeyswitchCount() const {
@@ -296,6 +307,8 @@ bool VirtualKeyScanner::wasKeyswitchPressed(KeyAddr key_addr) const {
 
 void VirtualKeyScanner::setKeystate(KeyAddr keyAddr, KeyState ks) {
   keystates_[keyAddr.toInt()] = ks;
+  if (ks != KeyState::NotPressed)
+    wakeup_.trigger();
 }
 
 VirtualKeyScanner::KeyState VirtualKeyScanner::getKeystate(KeyAddr keyAddr) const {
@@ -321,6 +334,8 @@ void VirtualLEDDriver::setup() {
 }
 
 void VirtualLEDDriver::syncLeds() {
+  ++sync_count_;
+
   // log format: red.green.blue where values are written in hex; followed by a space, followed by the next LED
   std::stringstream ss;
   ss << std::hex;
@@ -25,15 +25,17 @@
 #include KALEIDOSCOPE_HARDWARE_H
 
 // From system:
-#include <stdint.h>  // for uint8_t
+#include <stdint.h>  // for uint8_t, uint32_t, int32_t
 // From Arduino libraries:
+#include <Arduino.h>         // for millis
 #include <HardwareSerial.h>  // for Serial
 // From Kaleidoscope:
-#include "kaleidoscope/device/Base.h"             // for Base
-#include "kaleidoscope/driver/bootloader/None.h"  // for None
-#include "kaleidoscope/driver/hid/Keyboardio.h"   // for Keyboardio
-#include "kaleidoscope/driver/keyscanner/Base.h"  // for Base
-#include "kaleidoscope/driver/mcu/None.h"         // for None
+#include "kaleidoscope/device/Base.h"                   // for Base
+#include "kaleidoscope/driver/bootloader/None.h"        // for None
+#include "kaleidoscope/driver/hid/Keyboardio.h"         // for Keyboardio
+#include "kaleidoscope/driver/keyscanner/Base.h"        // for Base, ScanRate, ScanRateSettings
+#include "kaleidoscope/driver/keyscanner/ScanWakeup.h"  // for ScanWakeup
+#include "kaleidoscope/driver/mcu/None.h"               // for None
 
 namespace kaleidoscope {
 namespace device {
@@ -62,6 +64,9 @@ class VirtualKeyScanner
   void setup();
   void readMatrix();
   void scanMatrix() {
+    wakeup_.resume();
+    if (wakeup_.isArmed())
+      return;
     this->readMatrix();
     this->actOnMatrixScan();
   }
@@ -77,6 +82,28 @@ class VirtualKeyScanner
     read_matrix_enabled_ = state;
   }
 
+  // The simulator scans the matrix on every cycle, but it keeps track of the
+  // scan rate a hardware keyscanner would use, so that it can be tested.
+  driver::keyscanner::ScanRateSettings scanRate() const {
+    return scan_rate_.settings();
+  }
+  void setScanRate(const driver::keyscanner::ScanRateSettings &settings);
+  uint16_t scanInterval() const {
+    return scan_rate_.interval();
+  }
+
+  // Models a keyscanner that suspends scanning while idle, until a keyswitch
+  // closes (see `ATmegaProps::keyscan_wakeup`). Pressing a key through
+  // `setKeystate()` stands in for the pin change interrupt.
+  void setWakeupEnabled(bool state) {
+    wakeup_enabled_ = state;
+    if (!state)
+      wakeup_.disarm();
+  }
+  bool isScanSuspended() const {
+    return wakeup_.isArmed();
+  }
+
   void setKeystate(KeyAddr keyAddr, KeyState ks);
   KeyState getKeystate(KeyAddr keyAddr) const;
 
@@ -89,6 +116,10 @@ class VirtualKeyScanner
 
   bool read_matrix_enabled_;
 
+  driver::keyscanner::ScanRate scan_rate_;
+  driver::keyscanner::ScanWakeup wakeup_;
+  bool wakeup_enabled_ = false;
+
   KeyState keystates_[matrix_rows * matrix_columns];       // NOLINT(runtime/arrays)
   KeyState keystates_prev_[matrix_rows * matrix_columns];  // NOLINT(runtime/arrays)
 };
@@ -106,8 +137,15 @@ class VirtualLEDDriver
   void setCrgbAt(uint8_t i, cRGB color);
   cRGB getCrgbAt(uint8_t i) const;
 
+  // The number of times the LEDs have been synced so far, for tests to check
+  // that nothing gets sent needlessly.
+  uint32_t syncCount() const {
+    return sync_count_;
+  }
+
  private:
   cRGB led_states_[led_count];  // NOLINT(runtime/arrays)
+  uint32_t sync_count_ = 0;
 };
 
 // This overrides only the drivers and keeps the driver props of
@@ -145,6 +183,13 @@ class VirtualDevice
   auto serialPort() -> decltype(Serial) & {
     return Serial;
   }
+
+  // There's nothing to wait for in the virtual build, so sleeping is modelled
+  // as a jump in time: the virtual `millis()` advances by one on every call, so
+  // we stop just short of the deadline, and the next cycle starts there.
+  void sleepUntil(uint32_t deadline) {
+    while ((int32_t)(deadline - millis()) > 1) {}
+  }
 };
 
 }  // namespace virt
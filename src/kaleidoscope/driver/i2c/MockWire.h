@@ -0,0 +1,109 @@
+/* -*- mode: c++ -*-
+ * kaleidoscope::driver::i2c::MockWire -- Simulated RequestQueue backend
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifdef KALEIDOSCOPE_VIRTUAL_BUILD
+
+#include <stdint.h>  // for uint8_t
+
+#include <map>     // for map
+#include <set>     // for set
+#include <vector>  // for vector
+
+namespace kaleidoscope {
+namespace driver {
+namespace i2c {
+
+/// A `RequestQueue` backend for the virtual build
+///
+/// Instead of talking to a bus, this records every transfer it is asked to
+/// do, answers reads with data set up beforehand, and can pretend that writes
+/// take a while to finish, or that a device doesn't answer at all.
+class MockWire {
+ public:
+  struct Transfer {
+    uint8_t address;
+    bool read;
+    std::vector<uint8_t> data;
+  };
+
+  /// Every transfer carried out so far, in order.
+  std::vector<Transfer> transfers;
+
+  /// Sets the data that reads from `address` get back.
+  void respond(uint8_t address, std::vector<uint8_t> data) {
+    responses_[address] = data;
+  }
+
+  /// Makes the device at `address` stop (or start again) acknowledging
+  /// transfers.
+  void setAvailable(uint8_t address, bool available) {
+    if (available)
+      missing_.erase(address);
+    else
+      missing_.insert(address);
+  }
+
+  /// Makes every write keep the backend busy for the next `polls` calls to
+  /// `busy()`, like an interrupt-driven transfer would.
+  void setWriteDuration(uint8_t polls) {
+    write_duration_ = polls;
+  }
+
+  bool busy() {
+    if (busy_polls_ == 0)
+      return false;
+    --busy_polls_;
+    return true;
+  }
+
+  uint8_t write(uint8_t address, const uint8_t *data, uint8_t length) {
+    transfers.push_back(Transfer{address, false, std::vector<uint8_t>(data, data + length)});
+    if (missing_.count(address))
+      return 2;  // NACK on the address, like `Wire.endTransmission()`
+    busy_polls_ = write_duration_;
+    return 0;
+  }
+
+  uint8_t read(uint8_t address, uint8_t *data, uint8_t length) {
+    transfers.push_back(Transfer{address, true, {}});
+    busy_polls_ = 0;  // Reads wait for the write in progress to finish.
+    if (missing_.count(address))
+      return 0;
+    const std::vector<uint8_t> &response = responses_[address];
+    uint8_t count                        = 0;
+    while (count < length && count < response.size()) {
+      data[count] = response[count];
+      transfers.back().data.push_back(response[count]);
+      ++count;
+    }
+    return count;
+  }
+
+ private:
+  std::map<uint8_t, std::vector<uint8_t>> responses_;
+  std::set<uint8_t> missing_;
+  uint8_t write_duration_ = 0;
+  uint8_t busy_polls_     = 0;
+};
+
+}  // namespace i2c
+}  // namespace driver
+}  // namespace kaleidoscope
+
+#endif  // ifdef KALEIDOSCOPE_VIRTUAL_BUILD
@@ -0,0 +1,183 @@
+/* -*- mode: c++ -*-
+ * kaleidoscope::driver::i2c::RequestQueue -- Prioritized I2C transfer queue
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t
+
+namespace kaleidoscope {
+namespace driver {
+namespace i2c {
+
+struct Request;
+
+/// Called right before a write request is sent, to fill in `length` bytes of
+/// data. Doing that this late means that the latest data gets sent, even if it
+/// changed while the request was waiting in the queue.
+typedef void (*PrepareCallback)(const Request &request, uint8_t *data);
+
+/// Called once a request has been carried out. For writes, `status` is the
+/// backend's result code (zero on success), for reads, it is zero if all the
+/// requested bytes arrived, and `length` is the number of bytes that did.
+typedef void (*CompleteCallback)(const Request &request, uint8_t status,
+                                 const uint8_t *data, uint8_t length);
+
+/// An I2C transfer waiting to be carried out by a `RequestQueue`
+struct Request {
+  enum Flags : uint8_t {
+    WRITE         = 0,
+    READ          = 1 << 0,
+    HIGH_PRIORITY = 1 << 1,
+  };
+
+  uint8_t address;
+  uint8_t length;
+  uint8_t flags;
+  // Free for the submitter to use, to tell requests apart (an LED bank number,
+  // for example).
+  uint8_t tag;
+  void *context;
+  PrepareCallback prepare;
+  CompleteCallback complete;
+
+  bool isRead() const {
+    return flags & READ;
+  }
+  bool isHighPriority() const {
+    return flags & HIGH_PRIORITY;
+  }
+
+  /// Two requests are the same if they would transfer the same data.
+  bool isSameAs(const Request &other) const {
+    return address == other.address && flags == other.flags &&
+           tag == other.tag && context == other.context;
+  }
+};
+
+/// A queue of I2C transfers, carried out a few at a time
+///
+/// Drivers of devices on an I2C bus submit their transfers here, instead of
+/// talking to the bus directly, and `run()` carries them out later. High
+/// priority requests (keyscan reads, typically) always go first, in the order
+/// they were submitted, and low priority ones (LED updates) are limited to a
+/// number per call, so that a large update gets spread over several cycles
+/// instead of stalling one of them.
+///
+/// Submitting a request that is already waiting in the queue does not add it
+/// again. Since the data for writes is only assembled right before they are
+/// sent, the pending request will still send the latest data.
+///
+/// The `_Backend` does the actual transfers. It must provide:
+///
+/// - `uint8_t write(uint8_t address, const uint8_t *data, uint8_t length)`,
+///   returning zero on success, or an error code, like
+///   `Wire.endTransmission()`. It may return before the transfer is done.
+/// - `uint8_t read(uint8_t address, uint8_t *data, uint8_t length)`, returning
+///   the number of bytes read. Reads block, and wait for any transfer still in
+///   progress to finish first.
+/// - `bool busy()`, returning true while a transfer started by `write()` is
+///   still in progress. Low priority requests aren't started while the backend
+///   is busy; they are left for a later call to `run()`.
+template<typename _Backend, uint8_t _capacity, uint8_t _max_length>
+class RequestQueue {
+ public:
+  bool submit(const Request &request) {
+    if (request.length > _max_length)
+      return false;
+    for (uint8_t i = 0; i < count_; i++) {
+      if (requests_[i].isSameAs(request))
+        return true;
+    }
+    if (count_ == _capacity)
+      return false;
+    requests_[count_++] = request;
+    return true;
+  }
+
+  uint8_t pending() const {
+    return count_;
+  }
+
+  /// Carries out all the pending high priority requests, and at most
+  /// `low_priority_budget` of the others, as long as the backend isn't busy.
+  void run(uint8_t low_priority_budget) {
+    while (count_ != 0) {
+      uint8_t index = nextRequest(low_priority_budget != 0);
+      if (index == count_)
+        return;
+      if (!requests_[index].isHighPriority()) {
+        if (backend_.busy())
+          return;
+        --low_priority_budget;
+      }
+
+      // The request is taken off the queue before it is carried out, so that
+      // its callbacks may submit it (or others) again.
+      Request request = requests_[index];
+      remove(index);
+      execute(request);
+    }
+  }
+
+  _Backend &backend() {
+    return backend_;
+  }
+
+ private:
+  Request requests_[_capacity];
+  uint8_t count_ = 0;
+  _Backend backend_;
+
+  uint8_t nextRequest(bool include_low_priority) const {
+    uint8_t first_low_priority = count_;
+    for (uint8_t i = 0; i < count_; i++) {
+      if (requests_[i].isHighPriority())
+        return i;
+      if (first_low_priority == count_)
+        first_low_priority = i;
+    }
+    return include_low_priority ? first_low_priority : count_;
+  }
+
+  void remove(uint8_t index) {
+    --count_;
+    for (uint8_t i = index; i < count_; i++)
+      requests_[i] = requests_[i + 1];
+  }
+
+  void execute(const Request &request) {
+    uint8_t data[_max_length];
+    uint8_t status;
+    uint8_t length = request.length;
+
+    if (request.isRead()) {
+      length = backend_.read(request.address, data, request.length);
+      status = length == request.length ? 0 : 1;
+    } else {
+      if (request.prepare)
+        (*request.prepare)(request, data);
+      status = backend_.write(request.address, data, request.length);
+    }
+
+    if (request.complete)
+      (*request.complete)(request, status, data, length);
+  }
+};
+
+}  // namespace i2c
+}  // namespace driver
+}  // namespace kaleidoscope
@@ -0,0 +1,57 @@
+/* -*- mode: c++ -*-
+ * kaleidoscope::driver::i2c::WireBackend -- RequestQueue backend using Wire
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef KALEIDOSCOPE_VIRTUAL_BUILD
+
+#include <Wire.h>    // for Wire
+#include <stdint.h>  // for uint8_t
+
+namespace kaleidoscope {
+namespace driver {
+namespace i2c {
+
+/// A `RequestQueue` backend for the Arduino `Wire` library
+///
+/// `Wire` only does blocking transfers, so this backend is never busy; the
+/// queue still keeps large LED updates from being sent all in one cycle.
+class WireBackend {
+ public:
+  bool busy() {
+    return false;
+  }
+
+  uint8_t write(uint8_t address, const uint8_t *data, uint8_t length) {
+    Wire.beginTransmission(address);
+    Wire.write(data, length);
+    return Wire.endTransmission();
+  }
+
+  uint8_t read(uint8_t address, uint8_t *data, uint8_t length) {
+    uint8_t count = Wire.requestFrom(address, length);
+    for (uint8_t i = 0; i < count; i++)
+      data[i] = Wire.read();
+    return count;
+  }
+};
+
+}  // namespace i2c
+}  // namespace driver
+}  // namespace kaleidoscope
+
+#endif  // ifndef KALEIDOSCOPE_VIRTUAL_BUILD
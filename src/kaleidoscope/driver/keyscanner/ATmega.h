@@ -19,9 +19,13 @@
 
 #include <stdint.h>  // for uint16_t, uint8_t
 
-#include "kaleidoscope/device/avr/pins_and_ports.h"  // IWYU pragma: keep
-#include "kaleidoscope/driver/keyscanner/Base.h"     // for BaseProps
-#include "kaleidoscope/driver/keyscanner/None.h"     // for None
+#include "kaleidoscope/device/avr/pins_and_ports.h"     // IWYU pragma: keep
+#include "kaleidoscope/driver/keyscanner/Base.h"        // for BaseProps, ChangedBits, DebouncePolicy
+#include "kaleidoscope/driver/keyscanner/None.h"        // for None
+#include "kaleidoscope/driver/keyscanner/ScanRate.h"    // for ScanRate, ScanRateSettings
+#include "kaleidoscope/driver/keyscanner/ScanWakeup.h"  // for ScanWakeup, scanWakeupInterruptEnabled
+#include "kaleidoscope/driver/mcu/Wakeup.h"             // for Wakeup
+#include "kaleidoscope/keyswitch_state.h"               // for IS_PRESSED, WAS_PRESSED
 
 #ifndef KALEIDOSCOPE_VIRTUAL_BUILD
 #include <avr/wdt.h>
@@ -35,6 +39,27 @@ struct ATmegaProps : kaleidoscope::driver::keyscanner::BaseProps {
   static const uint16_t keyscan_interval = 1500;
   typedef uint16_t RowState;
 
+  /*
+   * When `idle_keyscan_interval` is non-zero, the keyscanner switches to
+   * scanning every `idle_keyscan_interval` microseconds once no keys have been
+   * pressed for `keyscan_idle_timeout` milliseconds, and back to
+   * `keyscan_interval` as soon as it sees a keyswitch close.
+   */
+  static const uint16_t idle_keyscan_interval = 0;
+  static const uint16_t keyscan_idle_timeout  = 1000;
+
+  /*
+   * With `keyscan_wakeup` set, an idle keyscanner stops scanning the matrix row
+   * by row: it drives all of its rows at once, so that a single read of the
+   * columns on each idle tick tells whether any keyswitch closed.
+   *
+   * A sketch can also have it wake up on a pin change interrupt, with
+   * `KALEIDOSCOPE_KEYSCANNER_WAKEUP_ISR()` (see `ScanWakeup.h`). Only port B
+   * pins can raise those, so the idle scan timer only stops if all the columns
+   * are on port B; otherwise, it keeps running to catch presses on the others.
+   */
+  static const bool keyscan_wakeup = false;
+
   /*
    * The following two lines declare an empty array. Both of these must be
    * shadowed by the descendant keyscanner description class.
@@ -71,28 +96,43 @@ class ATmega : public kaleidoscope::driver::keyscanner::Base<_KeyScannerProps> {
       OUTPUT_HIGH(_KeyScannerProps::matrix_row_pins[i]);
     }
 
-    setScanCycleTime(_KeyScannerProps::keyscan_interval);
+    setScanRate(ScanRateSettings{_KeyScannerProps::keyscan_interval,
+                                 _KeyScannerProps::idle_keyscan_interval,
+                                 _KeyScannerProps::keyscan_idle_timeout});
   }
 
 
-  /* setScanCycleTime takes a value of between 0 and 8192. This corresponds (roughly) to the number of microseconds to wait between scanning the key matrix. Our debouncing algorithm does four checks before deciding that a result is valid. Most normal mechanical switches specify a 5ms debounce period. On an ATMega32U4, 1700 gets you about 5ms of debouncing.
+  /* setScanCycleTime takes a value of between 0 and 8192. This corresponds (roughly) to the number of microseconds to wait between scanning the key matrix while keys are in use (see `setScanRate()` for the idle scan rate). The default debouncing algorithm does four checks before deciding that a result is valid. Most normal mechanical switches specify a 5ms debounce period. On an ATMega32U4, 1700 gets you about 5ms of debouncing.
 
   Because keycanning is triggered by an interrupt but not run in that interrupt, the actual amount of time between scans is prone to a little bit of jitter.
 
   */
   void setScanCycleTime(uint16_t c) {
-    TCCR1B = _BV(WGM13);
-    TCCR1A = 0;
-
-    const uint32_t cycles = (F_CPU / 2000000) * c;
+    ScanRateSettings settings = scan_rate_.settings();
+    settings.interval         = c;
+    setScanRate(settings);
+  }
 
-    ICR1   = cycles;
-    TCCR1B = _BV(WGM13) | _BV(CS10);
-    TIMSK1 = _BV(TOIE1);
+  ScanRateSettings scanRate() {
+    return scan_rate_.settings();
+  }
+  void setScanRate(const ScanRateSettings &settings) {
+    // New settings start out at the active interval, so a suspended scan ends
+    // here too, rather than at the next key press.
+    if (wakeup_.isArmed() || wakeup_.resume()) {
+      wakeup_.disarm();
+      releaseRows();
+    }
+    scan_rate_.setSettings(settings, millis());
+    startScanTimer(scan_rate_.interval());
+  }
+  uint16_t scanInterval() {
+    return scan_rate_.interval();
   }
 
   __attribute__((optimize(2))) void readMatrix(void) {
     typename _KeyScannerProps::RowState any_debounced_changes = 0;
+    typename _KeyScannerProps::RowState activity              = 0;
 
     for (uint8_t current_row = 0; current_row < _KeyScannerProps::matrix_rows; current_row++) {
       OUTPUT_TOGGLE(_KeyScannerProps::matrix_row_pins[current_row]);
@@ -100,32 +140,69 @@ class ATmega : public kaleidoscope::driver::keyscanner::Base<_KeyScannerProps> {
 
       OUTPUT_TOGGLE(_KeyScannerProps::matrix_row_pins[current_row]);
 
-      any_debounced_changes |= debounce(hot_pins, &matrix_state_[current_row].debouncer);
+      any_debounced_changes |= matrix_state_[current_row].debouncer.debounce(hot_pins);
+      activity |= hot_pins | matrix_state_[current_row].debouncer.state();
 
       if (any_debounced_changes) {
         for (uint8_t current_row = 0; current_row < _KeyScannerProps::matrix_rows; current_row++) {
-          matrix_state_[current_row].current = matrix_state_[current_row].debouncer.debounced_state;
+          matrix_state_[current_row].current = matrix_state_[current_row].debouncer.state();
         }
       }
     }
+
+    if (scan_rate_.update(activity != 0, millis()))
+      startScanTimer(scan_rate_.interval());
+    if (_KeyScannerProps::keyscan_wakeup && scan_rate_.isIdle())
+      armWakeup();
   }
   void scanMatrix() {
+    if (wakeup_.resume()) {
+      // A column went hot while scanning was suspended.
+      releaseRows();
+      do_scan_ = true;
+    }
     if (do_scan_) {
       do_scan_ = false;
-      readMatrix();
+      // While scanning is suspended, all the rows are driven, so a keyswitch
+      // closing anywhere shows up on its column. Unless one did, there is
+      // nothing more to do until the next idle tick.
+      bool suspended = wakeup_.isArmed();
+      if (suspended && readCols()) {
+        wakeup_.disarm();
+        releaseRows();
+        suspended = false;
+      }
+      if (!suspended)
+        readMatrix();
     }
     actOnMatrixScan();
   }
 
+  /* Called from the pin change interrupt handler when scanning is suspended.
+   */
+  void wakeUp() {
+#ifdef PCICR
+    if (wakeupInterruptEnabled())
+      PCICR &= ~_BV(PCIE0);
+#endif
+    wakeup_.trigger();
+    kaleidoscope::driver::mcu::Wakeup::request();
+  }
+  bool isScanSuspended() const {
+    return wakeup_.isArmed();
+  }
+
   void __attribute__((optimize(2))) actOnMatrixScan() {
     for (uint8_t row = 0; row < _KeyScannerProps::matrix_rows; row++) {
-      for (uint8_t col = 0; col < _KeyScannerProps::matrix_columns; col++) {
-        uint8_t keyState = (bitRead(matrix_state_[row].previous, col) << 0) | (bitRead(matrix_state_[row].current, col) << 1);
-        if (keyState) {
-          ThisType::handleKeyswitchEvent(Key_NoKey, typename _KeyScannerProps::KeyAddr(row, col), keyState);
-        }
+      typename _KeyScannerProps::RowState previous = matrix_state_[row].previous;
+      typename _KeyScannerProps::RowState current  = matrix_state_[row].current;
+      // Only keyswitches that toggled on or off produce events; held keys
+      // don't cost anything here.
+      for (uint8_t col : ChangedBits<typename _KeyScannerProps::RowState>(previous, current)) {
+        uint8_t keyState = bitRead(current, col) ? IS_PRESSED : WAS_PRESSED;
+        ThisType::handleKeyswitchEvent(Key_NoKey, typename _KeyScannerProps::KeyAddr(row, col), keyState);
       }
-      matrix_state_[row].previous = matrix_state_[row].current;
+      matrix_state_[row].previous = current;
     }
   }
 
@@ -158,27 +235,95 @@ class ATmega : public kaleidoscope::driver::keyscanner::Base<_KeyScannerProps> {
 
 
  protected:
-  /*
-    each of these variables are storing the state for a row of keys
-
-    so for key 0, the counter is represented by db0[0] and db1[0]
-    and the state in debounced_state[0].
-  */
-  struct debounce_t {
-    typename _KeyScannerProps::RowState db0;              // counter bit 0
-    typename _KeyScannerProps::RowState db1;              // counter bit 1
-    typename _KeyScannerProps::RowState debounced_state;  // debounced state
-  };
-
   struct row_state_t {
     typename _KeyScannerProps::RowState previous;
     typename _KeyScannerProps::RowState current;
-    debounce_t debouncer;
+    typename _KeyScannerProps::template DebouncePolicy<typename _KeyScannerProps::RowState> debouncer;
   };
 
  private:
   typedef _KeyScannerProps KeyScannerProps_;
   static row_state_t matrix_state_[_KeyScannerProps::matrix_rows];
+  ScanRate scan_rate_;
+  ScanWakeup wakeup_;
+
+  // Programs Timer1 to overflow every `interval` microseconds. Intervals over
+  // 8191us don't fit in the counter at full speed, so those use a prescaler.
+  // The counter starts over, so that the first tick after switching from the
+  // idle interval to the active one isn't late, and that TOP (which isn't
+  // double buffered in this mode) isn't lowered below the count.
+  void startScanTimer(uint16_t interval) {
+    TCCR1B = _BV(WGM13);
+    TCCR1A = 0;
+    TCNT1  = 0;
+
+    const uint32_t cycles = (F_CPU / 2000000) * (uint32_t)interval;
+
+    if (cycles > 0xffff) {
+      ICR1   = cycles / 8;
+      TCCR1B = _BV(WGM13) | _BV(CS11);
+    } else {
+      ICR1   = cycles;
+      TCCR1B = _BV(WGM13) | _BV(CS10);
+    }
+    TIMSK1 = _BV(TOIE1);
+  }
+
+  static constexpr bool isWakeupColumn(uint8_t col) {
+    return (_KeyScannerProps::matrix_col_pins[col] >> PORT_SHIFTER) == PINB_ADDRESS;
+  }
+  static constexpr uint8_t wakeupPinMask(uint8_t col = 0) {
+    return col == _KeyScannerProps::matrix_columns
+             ? 0
+             : (isWakeupColumn(col) ? PIN_MASK_FOR_PIN(_KeyScannerProps::matrix_col_pins[col]) : 0) |
+                 wakeupPinMask(col + 1);
+  }
+  static constexpr bool allColumnsWakeUp(uint8_t col = 0) {
+    return col == _KeyScannerProps::matrix_columns ||
+           (isWakeupColumn(col) && allColumnsWakeUp(col + 1));
+  }
+
+  // The pin change interrupt registers are only touched if the sketch handles
+  // `PCINT0_vect` for us; otherwise, they may well belong to someone else.
+  static bool wakeupInterruptEnabled() {
+    return wakeupPinMask() != 0 && scanWakeupInterruptEnabled();
+  }
+
+  // Drives all the rows, so that any keyswitch closing pulls its column low,
+  // and suspends scanning until that happens.
+  void armWakeup() {
+    for (uint8_t i = 0; i < _KeyScannerProps::matrix_rows; i++)
+      OUTPUT_LOW(_KeyScannerProps::matrix_row_pins[i]);
+    wakeup_.arm();
+
+#ifdef PCICR
+    if (wakeupInterruptEnabled()) {
+      if (allColumnsWakeUp()) {
+        TCCR1B = _BV(WGM13);
+        TIMSK1 = 0;
+      }
+      PCMSK0 = wakeupPinMask();
+      PCIFR  = _BV(PCIF0);
+      PCICR |= _BV(PCIE0);
+    }
+#endif
+
+    // A keyswitch that closed while we were getting here didn't cause a pin
+    // change we could see, so look for one.
+    if (readCols())
+      wakeUp();
+  }
+
+  void releaseRows() {
+#ifdef PCICR
+    if (wakeupInterruptEnabled()) {
+      PCICR &= ~_BV(PCIE0);
+      PCMSK0 = 0;
+    }
+#endif
+    for (uint8_t i = 0; i < _KeyScannerProps::matrix_rows; i++)
+      OUTPUT_HIGH(_KeyScannerProps::matrix_row_pins[i]);
+  }
 
   /*
    * This function has loop unrolling disabled on purpose: we want to give the
@@ -204,30 +349,6 @@ class ATmega : public kaleidoscope::driver::keyscanner::Base<_KeyScannerProps> {
 
     return hot_pins;
   }
-
-  static inline typename _KeyScannerProps::RowState debounce(
-    typename _KeyScannerProps::RowState sample, debounce_t *debouncer) {
-    typename _KeyScannerProps::RowState delta, changes;
-
-    // Use xor to detect changes from last stable state:
-    // if a key has changed, it's bit will be 1, otherwise 0
-    delta = sample ^ debouncer->debounced_state;
-
-    // Increment counters and reset any unchanged bits:
-    // increment bit 1 for all changed keys
-    debouncer->db1 = ((debouncer->db1) ^ (debouncer->db0)) & delta;
-    // increment bit 0 for all changed keys
-    debouncer->db0 = ~(debouncer->db0) & delta;
-
-    // Calculate returned change set: if delta is still true
-    // and the counter has wrapped back to 0, the key is changed.
-
-    changes = ~(~delta | (debouncer->db0) | (debouncer->db1));
-    // Update state: in this case use xor to flip any bit that is true in changes.
-    debouncer->debounced_state ^= changes;
-
-    return changes;
-  }
 };
 #else   // ifndef KALEIDOSCOPE_VIRTUAL_BUILD
 template<typename _KeyScannerProps>
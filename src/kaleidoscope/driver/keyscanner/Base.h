@@ -19,8 +19,10 @@
 
 #include <stdint.h>  // for uint8_t
 
-#include "kaleidoscope/MatrixAddr.h"  // IWYU pragma: keep
-#include "kaleidoscope/key_defs.h"    // for Key
+#include "kaleidoscope/MatrixAddr.h"                  // IWYU pragma: keep
+#include "kaleidoscope/driver/keyscanner/Debounce.h"  // for Counter
+#include "kaleidoscope/driver/keyscanner/ScanRate.h"  // for ScanRateSettings
+#include "kaleidoscope/key_defs.h"                    // for Key
 
 // IWYU pragma: no_include "kaleidoscope/KeyAddr.h"
 
@@ -28,10 +30,75 @@ namespace kaleidoscope {
 namespace driver {
 namespace keyscanner {
 
+/// Iterates over the positions of the bits that differ between two row states.
+///
+/// Keyscanners use this to dispatch events only for keyswitches that toggled
+/// on or off during a scan, instead of testing every bit of the matrix:
+///
+///     for (uint8_t col : ChangedBits<RowState>(previous, current)) {
+///       ...
+///     }
+///
+/// Positions are visited in ascending order, and rows with no changes cost no
+/// more than a single comparison.
+template<typename _RowState>
+class ChangedBits {
+ public:
+  ChangedBits(_RowState previous, _RowState current)
+    : changes_(previous ^ current) {}
+
+  class Iterator {
+   public:
+    explicit Iterator(_RowState bits)
+      : bits_(bits) {}
+
+    bool operator!=(const Iterator &other) const {
+      return bits_ != other.bits_;
+    }
+    uint8_t operator*() const {
+      return lowestSetBit(bits_);
+    }
+    Iterator &operator++() {
+      // Clear the lowest set bit.
+      bits_ &= bits_ - 1;
+      return *this;
+    }
+
+   private:
+    _RowState bits_;
+  };
+
+  Iterator begin() const {
+    return Iterator(changes_);
+  }
+  Iterator end() const {
+    return Iterator(0);
+  }
+
+ private:
+  _RowState changes_;
+
+  // `__builtin_ctz()` takes an `unsigned int`, which is only 16 bits wide on
+  // AVR, so wider row states need the `long` variants.
+  static uint8_t lowestSetBit(_RowState bits) {
+    if (sizeof(_RowState) <= sizeof(unsigned int))
+      return __builtin_ctz(bits);
+    if (sizeof(_RowState) <= sizeof(unsigned long))
+      return __builtin_ctzl(bits);
+    return __builtin_ctzll(bits);
+  }
+};
+
 struct BaseProps {
   static constexpr uint8_t matrix_rows    = 0;
   static constexpr uint8_t matrix_columns = 0;
   typedef MatrixAddr<matrix_rows, matrix_columns> KeyAddr;
+
+  // The debouncer keyscanners use for each row of their matrix (see
+  // `Debounce.h` for the available ones). Devices can shadow this in their
+  // keyscanner props to trade latency against chatter protection.
+  template<typename _RowState>
+  using DebouncePolicy = debounce::Counter<_RowState>;
 };
 
 template<typename _KeyScannerProps>
@@ -61,6 +128,16 @@ class Base {
   bool wasKeyswitchPressed(KeyAddr key_addr) {
     return false;
   }
+
+  // Keyscanners that can't change their scan rate report all-zero settings,
+  // and ignore attempts to change them.
+  ScanRateSettings scanRate() {
+    return ScanRateSettings{0, 0, 0};
+  }
+  void setScanRate(const ScanRateSettings &settings) {}
+  uint16_t scanInterval() {
+    return 0;
+  }
 };
 
 }  // namespace keyscanner
@@ -0,0 +1,289 @@
+/* -*- mode: c++ -*-
+ * kaleidoscope::driver::keyscanner::debounce -- Keyswitch debouncing
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t
+
+namespace kaleidoscope {
+namespace driver {
+namespace keyscanner {
+namespace debounce {
+
+// Debouncers for keyscanners.
+//
+// A debouncer keeps the state of one row of keyswitches (one bit per column),
+// and all the keys of a row are debounced in parallel, with bitwise
+// operations. Keyscanners that get the state of a whole half of the keyboard at
+// once may treat that as a single, wider row. Every debouncer has the same
+// interface:
+//
+//  - `_RowState debounce(_RowState sample)` takes the raw state of the row, as
+//    read from the matrix in the current scan, and returns the bits of the
+//    keyswitches whose debounced state changed as a result.
+//
+//  - `_RowState state() const` returns the current debounced state of the row.
+//
+// Keyscanners pick one through the `DebouncePolicy` alias template of their
+// props, which takes the row state type as its only parameter, e.g.:
+//
+//     template<typename _RowState>
+//     using DebouncePolicy = debounce::Eager<_RowState, 4>;
+//
+// All the debouncers that count scans do so per key, so a key's counter only
+// advances when the keyscanner feeds it a new sample.
+
+namespace internal {
+
+// The number of bits needed to count up to `value`.
+constexpr uint8_t bitWidth(uint8_t value) {
+  return value == 0 ? 0 : 1 + bitWidth(value >> 1);
+}
+
+// A set of per-key counters that count up to `_max`, stored as bit planes:
+// bit `b` of the counter for the key in column `n` is bit `n` of `planes_[b]`.
+// This way, the counters of all the keys of a row are updated in parallel.
+template<typename _RowState, uint8_t _max>
+class SlicedCounter {
+ public:
+  // Increments the counters of the keys in `mask`. None of them may be at
+  // `_max` already.
+  void increment(_RowState mask) {
+    for (uint8_t bit = 0; bit < width; ++bit) {
+      _RowState carry = planes_[bit] & mask;
+      planes_[bit] ^= mask;
+      mask = carry;
+    }
+  }
+
+  // Decrements the counters of the keys in `mask`. None of them may be at zero
+  // already.
+  void decrement(_RowState mask) {
+    for (uint8_t bit = 0; bit < width; ++bit) {
+      _RowState borrow = ~planes_[bit] & mask;
+      planes_[bit] ^= mask;
+      mask = borrow;
+    }
+  }
+
+  // Resets the counters of the keys in `mask` to zero.
+  void clear(_RowState mask) {
+    for (uint8_t bit = 0; bit < width; ++bit)
+      planes_[bit] &= ~mask;
+  }
+
+  // Returns the bits of the keys whose counters are equal to `value`.
+  _RowState equals(uint8_t value) const {
+    _RowState result = ~_RowState(0);
+    for (uint8_t bit = 0; bit < width; ++bit)
+      result &= (value & (1 << bit)) ? planes_[bit] : ~planes_[bit];
+    return result;
+  }
+
+ private:
+  static constexpr uint8_t width = bitWidth(_max);
+  _RowState planes_[width]       = {};
+};
+
+}  // namespace internal
+
+/// No debouncing
+///
+/// Every sample is taken as the new state. This is for keyscanners that get
+/// their samples from controllers that have already debounced them, such as the
+/// ones in the halves of split keyboards.
+template<typename _RowState>
+class None {
+ public:
+  _RowState debounce(_RowState sample) {
+    _RowState changes = sample ^ state_;
+    state_            = sample;
+    return changes;
+  }
+
+  _RowState state() const {
+    return state_;
+  }
+
+ private:
+  _RowState state_ = 0;
+};
+
+/// Symmetric counter debouncing (the default)
+///
+/// A keyswitch has to be sampled in the same (changed) state in four
+/// consecutive scans before the change is accepted. This filters out noise in
+/// both directions, but it also adds three scan intervals of latency to every
+/// press and release. It behaves like `Asymmetric<_RowState, 4, 4>`, with a
+/// slightly cheaper implementation.
+template<typename _RowState>
+class Counter {
+ public:
+  _RowState debounce(_RowState sample) {
+    _RowState delta, changes;
+
+    // Use xor to detect changes from last stable state:
+    // if a key has changed, it's bit will be 1, otherwise 0
+    delta = sample ^ debounced_state_;
+
+    // Increment counters and reset any unchanged bits:
+    // increment bit 1 for all changed keys
+    db1_ = (db1_ ^ db0_) & delta;
+    // increment bit 0 for all changed keys
+    db0_ = ~db0_ & delta;
+
+    // Calculate returned change set: if delta is still true
+    // and the counter has wrapped back to 0, the key is changed.
+    changes = ~(~delta | db0_ | db1_);
+    // Update state: in this case use xor to flip any bit that is true in changes.
+    debounced_state_ ^= changes;
+
+    return changes;
+  }
+
+  _RowState state() const {
+    return debounced_state_;
+  }
+
+ private:
+  // Each key has a two-bit counter, with bit 0 of the counter for the key in
+  // column `n` in bit `n` of `db0_`, and bit 1 of it in the same bit of `db1_`.
+  _RowState db0_             = 0;
+  _RowState db1_             = 0;
+  _RowState debounced_state_ = 0;
+};
+
+/// Asymmetric counter debouncing
+///
+/// Like `Counter`, but a press is accepted after `_press_scans` consecutive
+/// pressed samples, and a release after `_release_scans` consecutive released
+/// ones. Setting `_press_scans` to 1 makes presses register immediately, while
+/// releases, where chatter is more common, are still filtered.
+template<typename _RowState, uint8_t _press_scans, uint8_t _release_scans>
+class Asymmetric {
+ public:
+  _RowState debounce(_RowState sample) {
+    // Count the consecutive samples that differ from the debounced state, and
+    // reset the count of every key that agrees with it.
+    _RowState delta = sample ^ state_;
+    counter_.clear(~delta);
+    counter_.increment(delta);
+
+    _RowState changes = delta & ((~state_ & counter_.equals(_press_scans)) |
+                                 (state_ & counter_.equals(_release_scans)));
+    counter_.clear(changes);
+    state_ ^= changes;
+
+    return changes;
+  }
+
+  _RowState state() const {
+    return state_;
+  }
+
+ private:
+  static_assert(_press_scans > 0 && _release_scans > 0,
+                "The asymmetric debouncer needs at least one sample to accept a change");
+
+  internal::SlicedCounter<_RowState, (_press_scans > _release_scans ? _press_scans : _release_scans)> counter_;
+  _RowState state_ = 0;
+};
+
+/// Integrating debouncing
+///
+/// Each key has a counter that goes up (to at most `_threshold`) with every
+/// pressed sample, and down (to zero at the least) with every released one. A
+/// key becomes pressed when its counter reaches `_threshold`, and released when
+/// it gets back to zero. Unlike the counter debouncers, an occasional stray
+/// sample only delays a change instead of restarting the count, which makes
+/// this the most robust choice for noisy matrices.
+template<typename _RowState, uint8_t _threshold>
+class Integrator {
+ public:
+  _RowState debounce(_RowState sample) {
+    counter_.increment(sample & ~counter_.equals(_threshold));
+    counter_.decrement(~sample & ~counter_.equals(0));
+
+    _RowState changes = (~state_ & counter_.equals(_threshold)) |
+                        (state_ & counter_.equals(0));
+    state_ ^= changes;
+
+    return changes;
+  }
+
+  _RowState state() const {
+    return state_;
+  }
+
+ private:
+  static_assert(_threshold > 0,
+                "The threshold of the integrating debouncer must be at least one");
+
+  internal::SlicedCounter<_RowState, _threshold> counter_;
+  _RowState state_ = 0;
+};
+
+/// Eager (defer-free) debouncing
+///
+/// A change of a keyswitch's state is accepted as soon as it is first seen,
+/// and the keyswitch is then locked out for the `_settle_scans` scans that
+/// follow, during which its bouncing contacts are ignored. After that, the next
+/// sample that differs from the debounced state is accepted again. This keeps
+/// presses and releases as fast as the scan rate allows, but it relies on the
+/// matrix being free of noise when the keys aren't moving: a single spurious
+/// sample results in a spurious event.
+///
+/// The settle window should cover the switches' bounce time, which is usually
+/// specified as 5ms for mechanical switches, so with a scan interval of 1.5ms,
+/// four scans is a sensible setting.
+template<typename _RowState, uint8_t _settle_scans>
+class Eager {
+ public:
+  _RowState debounce(_RowState sample) {
+    // Release the locked-out keys whose settle windows are over, and advance
+    // the counters of the others.
+    _RowState settled = locked_ & counter_.equals(_settle_scans);
+    locked_ &= ~settled;
+    counter_.clear(settled);
+    counter_.increment(locked_);
+
+    // Any other key that has changed is reported right away, and locked out.
+    _RowState changes = (sample ^ state_) & ~locked_;
+    state_ ^= changes;
+    locked_ |= changes;
+
+    return changes;
+  }
+
+  _RowState state() const {
+    return state_;
+  }
+
+ private:
+  static_assert(_settle_scans > 0,
+                "The settle window of the eager debouncer must be at least one scan");
+
+  // The scans since each locked-out key was locked out.
+  internal::SlicedCounter<_RowState, _settle_scans> counter_;
+  _RowState locked_ = 0;
+  _RowState state_  = 0;
+};
+
+}  // namespace debounce
+}  // namespace keyscanner
+}  // namespace driver
+}  // namespace kaleidoscope
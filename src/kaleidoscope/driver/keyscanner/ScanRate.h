@@ -0,0 +1,94 @@
+/* -*- mode: c++ -*-
+ * kaleidoscope::driver::keyscanner::ScanRate -- Adaptive keyscan rate
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint16_t, uint32_t
+
+namespace kaleidoscope {
+namespace driver {
+namespace keyscanner {
+
+/// The scan rate settings of a keyscanner
+///
+/// While keys are in use, the keyscanner scans the matrix every `interval`
+/// microseconds. Once no keyswitch has been pressed (or bouncing) for
+/// `idle_timeout` milliseconds, it slows down to scanning every
+/// `idle_interval` microseconds, until it sees the next change. An
+/// `idle_interval` of zero disables idle scanning.
+struct ScanRateSettings {
+  uint16_t interval;
+  uint16_t idle_interval;
+  uint16_t idle_timeout;
+};
+
+/// Chooses between the active and idle scan intervals
+///
+/// Keyscanners report the outcome of every scan to `update()`, and reprogram
+/// their scan timers whenever it returns `true`. The time is passed in by the
+/// caller, so that this can be tested without any hardware.
+class ScanRate {
+ public:
+  const ScanRateSettings &settings() const {
+    return settings_;
+  }
+
+  /// Changes the settings, and switches back to the active interval.
+  void setSettings(const ScanRateSettings &settings, uint32_t now) {
+    settings_      = settings;
+    last_activity_ = now;
+    idle_          = false;
+  }
+
+  bool isIdle() const {
+    return idle_;
+  }
+
+  /// Returns the interval to wait for before the next scan, in microseconds.
+  uint16_t interval() const {
+    return idle_ ? settings_.idle_interval : settings_.interval;
+  }
+
+  /// Records the outcome of a scan. `active` should be true if any keyswitch
+  /// was pressed, or read differently from its debounced state, during the
+  /// scan. Returns true if the scan interval has changed.
+  bool update(bool active, uint32_t now) {
+    if (active) {
+      last_activity_ = now;
+      if (!idle_)
+        return false;
+      idle_ = false;
+      return true;
+    }
+
+    if (idle_ || settings_.idle_interval == 0 ||
+        now - last_activity_ < settings_.idle_timeout)
+      return false;
+
+    idle_ = true;
+    return true;
+  }
+
+ private:
+  ScanRateSettings settings_ = {0, 0, 0};
+  uint32_t last_activity_    = 0;
+  bool idle_                 = false;
+};
+
+}  // namespace keyscanner
+}  // namespace driver
+}  // namespace kaleidoscope
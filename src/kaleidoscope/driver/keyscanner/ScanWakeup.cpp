@@ -0,0 +1,30 @@
+/* kaleidoscope::driver::keyscanner::ScanWakeup -- Interrupt-driven scan wakeup
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope/driver/keyscanner/ScanWakeup.h"
+
+namespace kaleidoscope {
+namespace driver {
+namespace keyscanner {
+
+// Overridden by `KALEIDOSCOPE_KEYSCANNER_WAKEUP_ISR()`.
+__attribute__((weak)) bool scanWakeupInterruptEnabled() {
+  return false;
+}
+
+}  // namespace keyscanner
+}  // namespace driver
+}  // namespace kaleidoscope
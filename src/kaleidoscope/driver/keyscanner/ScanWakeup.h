@@ -0,0 +1,106 @@
+/* -*- mode: c++ -*-
+ * kaleidoscope::driver::keyscanner::ScanWakeup -- Interrupt-driven scan wakeup
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t
+
+namespace kaleidoscope {
+namespace driver {
+namespace keyscanner {
+
+/// Tracks whether matrix scanning is suspended until a keyswitch closes
+///
+/// Once a keyscanner has gone idle (see `ScanRate`), it can drive all of its
+/// rows at once, `arm()` this, and stop scanning row by row. Whatever notices a
+/// closed keyswitch first -- a pin change interrupt on one of the columns, if
+/// there is one, or a read of the columns on an idle tick -- calls `trigger()`,
+/// and the next time the keyscanner gets to run, `resume()` tells it to release
+/// the rows again and go back to regular, debounced scanning.
+///
+/// `trigger()` is the only method that may be called from an interrupt
+/// handler; everything else runs in the main loop.
+class ScanWakeup {
+ public:
+  /// Returns true while scanning is suspended, waiting for a keyswitch to close.
+  bool isArmed() const {
+    return state_ == ARMED;
+  }
+
+  void arm() {
+    state_ = ARMED;
+  }
+  void disarm() {
+    state_ = DISARMED;
+  }
+
+  /// Records a wakeup interrupt. Returns false if scanning wasn't suspended.
+  bool trigger() {
+    if (state_ != ARMED)
+      return false;
+    state_ = TRIGGERED;
+    return true;
+  }
+
+  /// Returns true (once) if a wakeup interrupt has arrived since the last call,
+  /// and disarms.
+  bool resume() {
+    if (state_ != TRIGGERED)
+      return false;
+    state_ = DISARMED;
+    return true;
+  }
+
+ private:
+  enum State : uint8_t {
+    DISARMED,
+    ARMED,
+    TRIGGERED,
+  };
+  volatile State state_ = DISARMED;
+};
+
+/// Whether the sketch has set up the pin change interrupt that wakes the
+/// keyscanner up (see `KALEIDOSCOPE_KEYSCANNER_WAKEUP_ISR()` below).
+/// Without it, a suspended keyscanner still looks for closed keyswitches on
+/// each idle tick.
+bool scanWakeupInterruptEnabled();
+
+}  // namespace keyscanner
+}  // namespace driver
+}  // namespace kaleidoscope
+
+/*
+ * Makes an ATmega keyscanner with `keyscan_wakeup` set wake up on a pin change
+ * interrupt, rather than on its next idle tick. To be used once, at the top
+ * level of a sketch. It defines the `PCINT0_vect` handler, which is why it is
+ * left to the sketch: libraries such as SoftwareSerial define it too.
+ */
+#if defined(__AVR__) && !defined(KALEIDOSCOPE_VIRTUAL_BUILD)
+#define KALEIDOSCOPE_KEYSCANNER_WAKEUP_ISR()                           \
+  bool kaleidoscope::driver::keyscanner::scanWakeupInterruptEnabled() { \
+    return true;                                                       \
+  }                                                                    \
+  ISR(PCINT0_vect) {                                                   \
+    Runtime.device().keyScanner().wakeUp();                            \
+  }
+#else  // if defined(__AVR__) && !defined(KALEIDOSCOPE_VIRTUAL_BUILD)
+#define KALEIDOSCOPE_KEYSCANNER_WAKEUP_ISR()                           \
+  bool kaleidoscope::driver::keyscanner::scanWakeupInterruptEnabled() { \
+    return true;                                                       \
+  }
+#endif  // if defined(__AVR__) && !defined(KALEIDOSCOPE_VIRTUAL_BUILD)
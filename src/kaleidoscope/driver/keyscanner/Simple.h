@@ -17,9 +17,11 @@
 
 #pragma once
 
-#include <stdint.h>                               // for uint16_t, uint8_t, uint32_t
-#include "kaleidoscope/driver/keyscanner/Base.h"  // for BaseProps
-#include "kaleidoscope/driver/keyscanner/None.h"  // for None
+#include <stdint.h>                                   // for uint16_t, uint8_t, uint32_t
+#include "kaleidoscope/driver/keyscanner/Base.h"      // for BaseProps, ChangedBits, DebouncePolicy
+#include "kaleidoscope/driver/keyscanner/None.h"      // for None
+#include "kaleidoscope/driver/keyscanner/ScanRate.h"  // for ScanRate, ScanRateSettings
+#include "kaleidoscope/keyswitch_state.h"             // for IS_PRESSED, WAS_PRESSED
 
 
 namespace kaleidoscope {
@@ -31,6 +33,15 @@ struct SimpleProps : kaleidoscope::driver::keyscanner::BaseProps {
   static const uint32_t keyscan_interval_micros = 1500;
   typedef uint16_t RowState;
 
+  /*
+   * When `idle_keyscan_interval_micros` is non-zero, the keyscanner switches to
+   * scanning that often once no keys have been pressed for
+   * `keyscan_idle_timeout_millis`, and back to `keyscan_interval_micros` as soon
+   * as it sees a keyswitch close.
+   */
+  static const uint16_t idle_keyscan_interval_micros = 0;
+  static const uint16_t keyscan_idle_timeout_millis  = 1000;
+
   /*
    * The following two lines declare an empty array. Both of these must be
    * shadowed by the descendant keyscanner description class.
@@ -44,22 +55,10 @@ struct SimpleProps : kaleidoscope::driver::keyscanner::BaseProps {
 template<typename _KeyScannerProps>
 class Simple : public kaleidoscope::driver::keyscanner::Base<_KeyScannerProps> {
  protected:
-  /*
-    each of these variables are storing the state for a row of keys
-
-    so for key 0, the counter is represented by db0[0] and db1[0]
-    and the state in debounced_state[0].
-  */
-  struct debounce_t {
-    typename _KeyScannerProps::RowState db0;              // counter bit 0
-    typename _KeyScannerProps::RowState db1;              // counter bit 1
-    typename _KeyScannerProps::RowState debounced_state;  // debounced state
-  };
-
   struct row_state_t {
     typename _KeyScannerProps::RowState previous;
     typename _KeyScannerProps::RowState current;
-    debounce_t debouncer;
+    typename _KeyScannerProps::template DebouncePolicy<typename _KeyScannerProps::RowState> debouncer;
   };
 
  private:
@@ -67,6 +66,7 @@ class Simple : public kaleidoscope::driver::keyscanner::Base<_KeyScannerProps> {
   typedef _KeyScannerProps KeyScannerProps_;
   static row_state_t matrix_state_[_KeyScannerProps::matrix_rows];
   static uint32_t next_scan_at_;
+  ScanRate scan_rate_;
 
  public:
   void setup() {
@@ -86,11 +86,26 @@ class Simple : public kaleidoscope::driver::keyscanner::Base<_KeyScannerProps> {
       pinMode(_KeyScannerProps::matrix_row_pins[i], OUTPUT);
       digitalWrite(_KeyScannerProps::matrix_row_pins[i], HIGH);
     }
+
+    setScanRate(ScanRateSettings{_KeyScannerProps::keyscan_interval_micros,
+                                 _KeyScannerProps::idle_keyscan_interval_micros,
+                                 _KeyScannerProps::keyscan_idle_timeout_millis});
+  }
+
+  ScanRateSettings scanRate() {
+    return scan_rate_.settings();
+  }
+  void setScanRate(const ScanRateSettings &settings) {
+    scan_rate_.setSettings(settings, millis());
+  }
+  uint16_t scanInterval() {
+    return scan_rate_.interval();
   }
 
 
   __attribute__((optimize(3))) void readMatrix(void) {
     typename _KeyScannerProps::RowState any_debounced_changes = 0;
+    typename _KeyScannerProps::RowState activity              = 0;
 
     for (uint8_t current_row = 0; current_row < _KeyScannerProps::matrix_rows; current_row++) {
       digitalWrite(_KeyScannerProps::matrix_row_pins[current_row], LOW);
@@ -98,33 +113,38 @@ class Simple : public kaleidoscope::driver::keyscanner::Base<_KeyScannerProps> {
       digitalWrite(_KeyScannerProps::matrix_row_pins[current_row], HIGH);
 
 
-      any_debounced_changes |= debounce(hot_pins, &matrix_state_[current_row].debouncer);
+      any_debounced_changes |= matrix_state_[current_row].debouncer.debounce(hot_pins);
+      activity |= hot_pins | matrix_state_[current_row].debouncer.state();
 
       if (any_debounced_changes) {
         for (uint8_t current_row = 0; current_row < _KeyScannerProps::matrix_rows; current_row++) {
-          matrix_state_[current_row].current = matrix_state_[current_row].debouncer.debounced_state;
+          matrix_state_[current_row].current = matrix_state_[current_row].debouncer.state();
         }
       }
     }
+
+    scan_rate_.update(activity != 0, millis());
   }
   void scanMatrix() {
     uint32_t current_micros_ = micros();
     if (current_micros_ >= next_scan_at_) {
-      next_scan_at_ = current_micros_ + _KeyScannerProps::keyscan_interval_micros;
       readMatrix();
+      next_scan_at_ = current_micros_ + scan_rate_.interval();
     }
     actOnMatrixScan();
   }
 
   void __attribute__((optimize(3))) actOnMatrixScan() {
     for (uint8_t row = 0; row < _KeyScannerProps::matrix_rows; row++) {
-      for (uint8_t col = 0; col < _KeyScannerProps::matrix_columns; col++) {
-        uint8_t keyState = (bitRead(matrix_state_[row].previous, col) << 0) | (bitRead(matrix_state_[row].current, col) << 1);
-        if (keyState) {
-          ThisType::handleKeyswitchEvent(Key_NoKey, typename _KeyScannerProps::KeyAddr(row, col), keyState);
-        }
+      typename _KeyScannerProps::RowState previous = matrix_state_[row].previous;
+      typename _KeyScannerProps::RowState current  = matrix_state_[row].current;
+      // Only keyswitches that toggled on or off produce events; held keys
+      // don't cost anything here.
+      for (uint8_t col : ChangedBits<typename _KeyScannerProps::RowState>(previous, current)) {
+        uint8_t keyState = bitRead(current, col) ? IS_PRESSED : WAS_PRESSED;
+        ThisType::handleKeyswitchEvent(Key_NoKey, typename _KeyScannerProps::KeyAddr(row, col), keyState);
       }
-      matrix_state_[row].previous = matrix_state_[row].current;
+      matrix_state_[row].previous = current;
     }
   }
 
@@ -180,30 +200,6 @@ class Simple : public kaleidoscope::driver::keyscanner::Base<_KeyScannerProps> {
 
     return hot_pins;
   }
-
-  static inline typename _KeyScannerProps::RowState debounce(
-    typename _KeyScannerProps::RowState sample, debounce_t *debouncer) {
-    typename _KeyScannerProps::RowState delta, changes;
-
-    // Use xor to detect changes from last stable state:
-    // if a key has changed, it's bit will be 1, otherwise 0
-    delta = sample ^ debouncer->debounced_state;
-
-    // Increment counters and reset any unchanged bits:
-    // increment bit 1 for all changed keys
-    debouncer->db1 = ((debouncer->db1) ^ (debouncer->db0)) & delta;
-    // increment bit 0 for all changed keys
-    debouncer->db0 = ~(debouncer->db0) & delta;
-
-    // Calculate returned change set: if delta is still true
-    // and the counter has wrapped back to 0, the key is changed.
-
-    changes = ~(~delta | (debouncer->db0) | (debouncer->db1));
-    // Update state: in this case use xor to flip any bit that is true in changes.
-    debouncer->debounced_state ^= changes;
-
-    return changes;
-  }
 };
 #else   // ifndef KALEIDOSCOPE_VIRTUAL_BUILD
 template<typename _KeyScannerProps>
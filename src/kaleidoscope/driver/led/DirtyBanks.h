@@ -0,0 +1,87 @@
+/* -*- mode: c++ -*-
+ * kaleidoscope::driver::led::DirtyBanks -- Per-bank LED change tracking
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t, uint16_t, uint32_t
+
+#include "kaleidoscope_internal/type_traits/type_traits"  // IWYU pragma: keep
+// IWYU pragma: no_include <type_traits>
+
+namespace kaleidoscope {
+namespace driver {
+namespace led {
+
+/// Tracks which banks of LEDs changed since they were last sent
+///
+/// Many LED controllers get their colors a bank (a fixed-size group of LEDs) at
+/// a time. Their drivers mark the bank of every LED whose color changes, and
+/// only send the marked banks when syncing, instead of all of them whenever
+/// anything changed. All banks start out marked, so the first sync sends
+/// everything.
+template<uint8_t _bank_count>
+class DirtyBanks {
+  static_assert(_bank_count <= 32,
+                "DirtyBanks error: _bank_count too large (max 32)!");
+
+ public:
+  typedef typename std::conditional<
+    (_bank_count <= 8), uint8_t,
+    typename std::conditional<
+      (_bank_count <= 16), uint16_t, uint32_t>::type>::type Bitmap;
+
+  static constexpr uint8_t bank_count = _bank_count;
+
+  void mark(uint8_t bank) {
+    bits_ |= bankBit(bank);
+  }
+  void markAll() {
+    bits_ = all_banks;
+  }
+  void clear(uint8_t bank) {
+    bits_ &= ~bankBit(bank);
+  }
+
+  /// Marks `bank` if `new_color` differs from `old_color`.
+  template<typename Color>
+  void update(uint8_t bank, const Color &old_color, const Color &new_color) {
+    if (old_color.r != new_color.r ||
+        old_color.g != new_color.g ||
+        old_color.b != new_color.b)
+      mark(bank);
+  }
+
+  bool isDirty(uint8_t bank) const {
+    return bits_ & bankBit(bank);
+  }
+  bool any() const {
+    return bits_ != 0;
+  }
+
+ private:
+  static constexpr Bitmap all_banks = Bitmap(~Bitmap(0)) >> (sizeof(Bitmap) * 8 - _bank_count);
+
+  Bitmap bits_ = all_banks;
+
+  static Bitmap bankBit(uint8_t bank) {
+    return Bitmap(1) << bank;
+  }
+};
+
+}  // namespace led
+}  // namespace driver
+}  // namespace kaleidoscope
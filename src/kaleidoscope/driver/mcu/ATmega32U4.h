@@ -17,7 +17,15 @@
 
 #pragma once
 
-#include "kaleidoscope/driver/mcu/Base.h"  // for Base, BaseProps
+#include <stdint.h>  // for uint32_t
+
+#ifndef KALEIDOSCOPE_VIRTUAL_BUILD
+#include <Arduino.h>    // for millis, Serial
+#include <avr/sleep.h>  // for set_sleep_mode, sleep_cpu, sleep_disable, sleep_enable
+#endif
+
+#include "kaleidoscope/driver/mcu/Base.h"    // for Base, BaseProps
+#include "kaleidoscope/driver/mcu/Wakeup.h"  // for Wakeup
 
 namespace kaleidoscope {
 namespace driver {
@@ -77,6 +85,23 @@ class ATmega32U4 : public kaleidoscope::driver::mcu::Base<_Props> {
   bool USBConfigured() {
     return USBDevice.configured();
   }
+
+  void sleepUntil(uint32_t deadline) {
+    // Idle mode stops the CPU clock, but leaves the timers and the USB
+    // controller running, so any of their interrupts will wake us up. Timer0
+    // does so every millisecond to keep `millis()` running, after which we go
+    // back to sleep. Any other interrupt (the keyscanner's, or USB traffic) may
+    // have left work for the main loop, so we return to it.
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    while ((int32_t)(millis() - deadline) < 0) {
+      uint32_t now = millis();
+      sleep_enable();
+      sleep_cpu();
+      sleep_disable();
+      if (millis() == now || Wakeup::take() || Serial.available())
+        return;
+    }
+  }
 };
 #else
 template<typename _Props>
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <stdint.h>  // for uint32_t
+
 namespace kaleidoscope {
 namespace driver {
 namespace mcu {
@@ -70,6 +72,17 @@ class Base {
   }
 
   void setUSBResetHook(void (*hook)()) {}
+
+  /**
+   * Sleep until `deadline` (a `millis()` timestamp).
+   *
+   * The MCU should be put into a low-power state that any interrupt (timer,
+   * USB, pin change) wakes it up from, and stay there until the deadline has
+   * been reached, or an interrupt other than the one keeping `millis()` running
+   * woke it up (see `Wakeup`). Returning early is always allowed; this default
+   * implementation returns immediately, leaving the main loop spinning.
+   */
+  void sleepUntil(uint32_t deadline) {}
 };
 
 }  // namespace mcu
@@ -17,9 +17,10 @@
 
 #pragma once
 
-#include <Arduino.h>                       // NVIC_Reset
-#include <USBCore.h>                       // For connect, disconnect, USBCore
-#include "kaleidoscope/driver/mcu/Base.h"  // for Base, BaseProps
+#include <Arduino.h>                         // NVIC_Reset, millis, Serial, __WFI
+#include <USBCore.h>                         // For connect, disconnect, USBCore
+#include "kaleidoscope/driver/mcu/Base.h"    // for Base, BaseProps
+#include "kaleidoscope/driver/mcu/Wakeup.h"  // for Wakeup
 
 namespace kaleidoscope {
 namespace driver {
@@ -48,6 +49,18 @@ class GD32 : public kaleidoscope::driver::mcu::Base<_Props> {
     USBCore().setResetHook(hook);
   }
 
+  void sleepUntil(uint32_t deadline) {
+    // The SysTick interrupt wakes us up every millisecond, after which we go
+    // back to sleep. Any other interrupt (the keyscanner's, or USB traffic) may
+    // have left work for the main loop, so we return to it.
+    while ((int32_t)(millis() - deadline) < 0) {
+      uint32_t now = millis();
+      __WFI();
+      if (millis() == now || Wakeup::take() || Serial.available())
+        return;
+    }
+  }
+
 
   void setup() {
   }
@@ -0,0 +1,28 @@
+/* -*- mode: c++ -*-
+ * driver::mcu::Wakeup -- Ending an MCU's sleep from interrupt handlers
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope/driver/mcu/Wakeup.h"
+
+namespace kaleidoscope {
+namespace driver {
+namespace mcu {
+
+volatile bool Wakeup::requested_;
+
+}  // namespace mcu
+}  // namespace driver
+}  // namespace kaleidoscope
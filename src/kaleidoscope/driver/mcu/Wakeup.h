@@ -0,0 +1,51 @@
+/* -*- mode: c++ -*-
+ * driver::mcu::Wakeup -- Ending an MCU's sleep from interrupt handlers
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace kaleidoscope {
+namespace driver {
+namespace mcu {
+
+/// Lets interrupt handlers wake the main loop up from `sleepUntil()`
+///
+/// An MCU driver's `sleepUntil()` goes back to sleep after the interrupt that
+/// keeps `millis()` running, and returns after any other. When that interrupt
+/// and another arrive together, the other one can't be told apart from it, so
+/// handlers that must not wait for the sleep to end (like a keyscanner's pin
+/// change interrupt) should call `request()` too.
+class Wakeup {
+ public:
+  static void request() {
+    requested_ = true;
+  }
+
+  /// Returns whether a wakeup was requested since the last call.
+  static bool take() {
+    if (!requested_)
+      return false;
+    requested_ = false;
+    return true;
+  }
+
+ private:
+  static volatile bool requested_;
+};
+
+}  // namespace mcu
+}  // namespace driver
+}  // namespace kaleidoscope
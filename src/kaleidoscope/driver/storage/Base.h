@@ -59,6 +59,9 @@ class Base {
 
   void setup() {}
   void commit() {}
+  /// Writes any changes the driver has been holding back to storage right away.
+  /// Only write-back drivers (see `DeferredCommit`) hold changes back.
+  void flush() {}
 };
 
 }  // namespace storage
@@ -0,0 +1,45 @@
+/* -*- mode: c++ -*-
+ * kaleidoscope::driver::storage::DeferredCommit -- Write-back commit scheduling
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope/driver/storage/DeferredCommit.h"
+
+#include <stdint.h>  // for uint16_t
+
+#include "kaleidoscope/Runtime.h"  // for Runtime, Runtime_
+#include "kaleidoscope/Timer.h"    // for Timer
+
+namespace kaleidoscope {
+namespace driver {
+namespace storage {
+
+Timer DeferredCommit::timer_{DeferredCommit::onTimeout};
+
+void DeferredCommit::schedule(uint16_t delay) {
+  Runtime.startTimer(timer_, delay);
+}
+
+void DeferredCommit::cancel() {
+  Runtime.stopTimer(timer_);
+}
+
+void DeferredCommit::onTimeout() {
+  Runtime.storage().flush();
+}
+
+}  // namespace storage
+}  // namespace driver
+}  // namespace kaleidoscope
@@ -0,0 +1,85 @@
+/* -*- mode: c++ -*-
+ * kaleidoscope::driver::storage::DeferredCommit -- Write-back commit scheduling
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint16_t
+
+#include "kaleidoscope/Timer.h"  // for Timer
+
+namespace kaleidoscope {
+namespace driver {
+namespace storage {
+
+/// Schedules the commits of write-back storage drivers
+///
+/// Flash-backed storage drivers keep a copy of their data in RAM, and every
+/// commit erases and rewrites a whole flash page, which stalls the firmware for
+/// several milliseconds, and wears the flash out. Plugins commit after every
+/// change they make, so such drivers defer the actual work: their `commit()`
+/// calls `schedule()`, which (re)starts a timer, and once no further commit has
+/// been requested for a while, the timer calls `Runtime.storage().flush()`,
+/// which writes all the changes made in the meantime at once.
+class DeferredCommit {
+ public:
+  /// Makes the storage get flushed `delay` milliseconds from now, unless
+  /// `schedule()` gets called again before that.
+  static void schedule(uint16_t delay);
+  static void cancel();
+  static bool isScheduled() {
+    return timer_.isPending();
+  }
+
+ private:
+  static Timer timer_;
+  static void onTimeout();
+};
+
+/// The `commit()` and `flush()` of a write-back storage driver
+///
+/// Drivers that write all their data back at once derive from this, passing
+/// themselves as `_Storage`, and implement `writeBack()`, which it calls from
+/// `flush()` if anything was committed since the last write. `commit()` flushes
+/// right away if `_StorageProps::commit_delay` is zero, and schedules the flush
+/// with `DeferredCommit` otherwise.
+template<typename _Storage, typename _StorageProps>
+class DeferredCommitStorage {
+ public:
+  void commit() {
+    commit_pending_ = true;
+    if (_StorageProps::commit_delay == 0) {
+      flush();
+    } else {
+      DeferredCommit::schedule(_StorageProps::commit_delay);
+    }
+  }
+
+  void flush() {
+    DeferredCommit::cancel();
+    if (!commit_pending_)
+      return;
+    commit_pending_ = false;
+    static_cast<_Storage *>(this)->writeBack();
+  }
+
+ private:
+  bool commit_pending_ = false;
+};
+
+}  // namespace storage
+}  // namespace driver
+}  // namespace kaleidoscope
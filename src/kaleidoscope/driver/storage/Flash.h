@@ -31,6 +31,7 @@
 #include <FlashStorage.h>
 
 #include "kaleidoscope/driver/storage/Base.h"
+#include "kaleidoscope/driver/storage/DeferredCommit.h"
 
 // We need to undefine Flash, because `FlashStorage` defines it as a macro, yet,
 // we want to use it as a class name.
@@ -42,11 +43,18 @@ namespace storage {
 
 struct FlashProps : kaleidoscope::driver::storage::BaseProps {
   static constexpr uint16_t length = EEPROM_EMULATION_SIZE;
+  // How long commits are deferred for, in milliseconds (see
+  // `DeferredCommitStorage`).
+  static constexpr uint16_t commit_delay = 500;
 };
 
 template<typename _StorageProps>
-class Flash : public kaleidoscope::driver::storage::Base<_StorageProps> {
+class Flash : public kaleidoscope::driver::storage::Base<_StorageProps>,
+              public DeferredCommitStorage<Flash<_StorageProps>, _StorageProps> {
  public:
+  using DeferredCommitStorage<Flash<_StorageProps>, _StorageProps>::commit;
+  using DeferredCommitStorage<Flash<_StorageProps>, _StorageProps>::flush;
+
   template<typename T>
   T &get(uint16_t offset, T &t) {
     return EEPROM.get(offset, t);
@@ -69,7 +77,8 @@ class Flash : public kaleidoscope::driver::storage::Base<_StorageProps> {
     EEPROM.update(idx, val);
   }
 
-  void commit() {
+  // Called by `flush()`.
+  void writeBack() {
     EEPROM.commit();
   }
 };
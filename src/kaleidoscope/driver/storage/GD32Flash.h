@@ -23,6 +23,7 @@
 #include <FlashStorage.h>
 
 #include "kaleidoscope/driver/storage/Base.h"
+#include "kaleidoscope/driver/storage/DeferredCommit.h"
 
 namespace kaleidoscope {
 namespace driver {
@@ -30,11 +31,18 @@ namespace storage {
 
 struct GD32FlashProps : kaleidoscope::driver::storage::BaseProps {
   static constexpr uint16_t length = 16384;
+  // How long commits are deferred for, in milliseconds (see
+  // `DeferredCommitStorage`).
+  static constexpr uint16_t commit_delay = 500;
 };
 
 template<typename _StorageProps>
-class GD32Flash : public EEPROMClass<_StorageProps::length> {
+class GD32Flash : public EEPROMClass<_StorageProps::length>,
+                  public DeferredCommitStorage<GD32Flash<_StorageProps>, _StorageProps> {
  public:
+  using DeferredCommitStorage<GD32Flash<_StorageProps>, _StorageProps>::commit;
+  using DeferredCommitStorage<GD32Flash<_StorageProps>, _StorageProps>::flush;
+
   void setup() {
     EEPROMClass<_StorageProps::length>::begin();
   }
@@ -46,6 +54,11 @@ class GD32Flash : public EEPROMClass<_StorageProps::length> {
     }
     return true;
   }
+
+  // Called by `flush()`.
+  void writeBack() {
+    EEPROMClass<_StorageProps::length>::commit();
+  }
 };
 
 }  // namespace storage
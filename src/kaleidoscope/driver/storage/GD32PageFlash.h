@@ -0,0 +1,63 @@
+/* -*- mode: c++ -*-
+ * kaleidoscope::driver::storage::GD32PageFlash -- Raw GD32 flash pages
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifdef ARDUINO_ARCH_GD32
+
+#include <Arduino.h>  // for fmc_lock, fmc_page_erase, fmc_unlock, fmc_word_program
+#include <stdint.h>   // for uint8_t, uint16_t, uint32_t
+#include <string.h>   // for memcpy
+
+namespace kaleidoscope {
+namespace driver {
+namespace storage {
+
+/// A `LogStructuredFlash` backend using the GD32's internal flash
+///
+/// Works on the pages starting at `_base_address`, which must be page aligned,
+/// and must not be used by the firmware itself, or by any other storage (the
+/// end of the flash, below whatever `FlashAsEEPROM` uses, is a good spot).
+template<uint32_t _base_address, uint16_t _page_size>
+class GD32PageFlash {
+ public:
+  void erasePage(uint16_t page) {
+    fmc_unlock();
+    fmc_page_erase(_base_address + uint32_t(page) * _page_size);
+    fmc_lock();
+  }
+
+  void program(uint32_t address, const uint8_t *data, uint16_t size) {
+    fmc_unlock();
+    for (uint16_t i = 0; i < size; i += 4) {
+      uint32_t word;
+      memcpy(&word, &data[i], 4);
+      fmc_word_program(_base_address + address + i, word);
+    }
+    fmc_lock();
+  }
+
+  void read(uint32_t address, uint8_t *data, uint16_t size) {
+    memcpy(data, reinterpret_cast<const uint8_t *>(_base_address + address), size);
+  }
+};
+
+}  // namespace storage
+}  // namespace driver
+}  // namespace kaleidoscope
+
+#endif
@@ -0,0 +1,296 @@
+/* -*- mode: c++ -*-
+ * kaleidoscope::driver::storage::LogStructuredFlash -- Wear-leveling flash storage
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t, uint16_t, uint32_t
+#include <string.h>  // for memcpy, memset
+
+#include "kaleidoscope/driver/storage/Base.h"            // for Base, BaseProps
+#include "kaleidoscope/driver/storage/DeferredCommit.h"  // for DeferredCommitStorage
+#include "kaleidoscope/util/crc16.h"                     // for _crc_ccitt_update
+
+namespace kaleidoscope {
+namespace driver {
+namespace storage {
+
+struct LogStructuredFlashProps : kaleidoscope::driver::storage::BaseProps {
+  static constexpr uint16_t length = 1024;
+  // The size of an erasable flash page, and the number of them in each of the
+  // two banks the log alternates between.
+  static constexpr uint16_t page_size     = 2048;
+  static constexpr uint8_t pages_per_bank = 2;
+  // See `DeferredCommitStorage`.
+  static constexpr uint16_t commit_delay = 500;
+  // Props must also provide a `Flash` typedef: the backend that does the
+  // actual erasing and programming (see below).
+};
+
+/// A storage driver that appends changes to a log in flash
+///
+/// Drivers built on `EEPROMClass` erase and rewrite their whole flash page on
+/// every commit, even if a single byte changed. This one splits the data into
+/// four byte chunks, and every commit appends a small record for each chunk
+/// that changed to the end of a log instead. Only when the log is full does it
+/// get compacted: the other bank is erased, and a snapshot of the current data
+/// is written there. Flash is thus erased once every few hundred commits,
+/// rather than on every one of them, and the erases alternate between the two
+/// banks.
+///
+/// Each record is eight bytes: the chunk index, the chunk's data, and a CRC. A
+/// bank starts with a header holding a sequence number, which is written only
+/// after the snapshot is complete, so if power is lost during compaction, the
+/// previous bank is still the one that gets used. Records with a bad CRC (a
+/// write torn by power loss) are skipped.
+///
+/// A RAM copy of the data serves as the index: `setup()` replays the log into
+/// it, reads are served from it, and writes mark the chunks they change, to be
+/// appended by `flush()`. Like `GD32Flash`, commits are deferred (see
+/// `DeferredCommitStorage`).
+///
+/// The `Flash` backend from the Props must provide:
+///
+/// - `void erasePage(uint16_t page)`, setting all bytes of a page to 0xff,
+/// - `void program(uint32_t address, const uint8_t *data, uint16_t size)`,
+///   where `address` and `size` are multiples of four, and programming can only
+///   clear bits,
+/// - `void read(uint32_t address, uint8_t *data, uint16_t size)`.
+///
+/// Addresses are relative to the start of the first page. The backend needs to
+/// have `2 * pages_per_bank` pages.
+///
+/// The on-flash format is not compatible with the other flash drivers, so
+/// switching a device over to this one loses the data stored with the old one.
+template<typename _StorageProps>
+class LogStructuredFlash : public kaleidoscope::driver::storage::Base<_StorageProps>,
+                           public DeferredCommitStorage<LogStructuredFlash<_StorageProps>, _StorageProps> {
+ public:
+  using DeferredCommitStorage<LogStructuredFlash<_StorageProps>, _StorageProps>::commit;
+  using DeferredCommitStorage<LogStructuredFlash<_StorageProps>, _StorageProps>::flush;
+
+  typedef typename _StorageProps::Flash Flash;
+
+  static constexpr uint16_t chunk_size       = 4;
+  static constexpr uint16_t chunk_count      = _StorageProps::length / chunk_size;
+  static constexpr uint16_t record_size      = 8;
+  static constexpr uint32_t bank_size        = uint32_t(_StorageProps::page_size) * _StorageProps::pages_per_bank;
+  static constexpr uint16_t records_per_bank = bank_size / record_size - 1;
+
+  static_assert(_StorageProps::length % chunk_size == 0,
+                "LogStructuredFlash error: length must be a multiple of 4!");
+  static_assert(_StorageProps::page_size % record_size == 0,
+                "LogStructuredFlash error: page_size must be a multiple of 8!");
+  static_assert(chunk_count < records_per_bank,
+                "LogStructuredFlash error: a bank is too small to hold all the data!");
+
+  void setup() {
+    memset(data_, _StorageProps::uninitialized_byte, sizeof(data_));
+    memset(dirty_, 0, sizeof(dirty_));
+    active_bank_ = NO_BANK;
+    next_slot_   = records_per_bank;
+    sequence_    = 0;
+
+    Header headers[2];
+    for (uint8_t bank = 0; bank < 2; bank++)
+      readHeader(bank, headers[bank]);
+    for (uint8_t bank = 0; bank < 2; bank++) {
+      if (headers[bank].magic != MAGIC)
+        continue;
+      if (active_bank_ == NO_BANK ||
+          int32_t(headers[bank].sequence - sequence_) > 0) {
+        active_bank_ = bank;
+        sequence_    = headers[bank].sequence;
+      }
+    }
+    if (active_bank_ == NO_BANK)
+      return;
+
+    uint8_t record[record_size];
+    for (next_slot_ = 0; next_slot_ < records_per_bank; next_slot_++) {
+      flash_.read(recordAddress(active_bank_, next_slot_), record, record_size);
+      if (isErased(record, record_size))
+        break;
+      uint16_t chunk = record[0] | (record[1] << 8);
+      uint16_t crc   = record[6] | (record[7] << 8);
+      if (chunk < chunk_count && crc == recordCRC(record))
+        memcpy(&data_[chunk * chunk_size], &record[2], chunk_size);
+    }
+  }
+
+  template<typename T>
+  T &get(uint16_t offset, T &t) {
+    memcpy(&t, &data_[offset], sizeof(T));
+    return t;
+  }
+
+  template<typename T>
+  const T &put(uint16_t offset, const T &t) {
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&t);
+    for (uint16_t i = 0; i < sizeof(T); i++)
+      update(offset + i, bytes[i]);
+    return t;
+  }
+
+  uint8_t read(int idx) {
+    return data_[idx];
+  }
+
+  void write(int idx, uint8_t val) {
+    update(idx, val);
+  }
+
+  // Bytes that don't change aren't marked, so rewriting the same data costs
+  // nothing at commit time.
+  void update(int idx, uint8_t val) {
+    if (data_[idx] == val)
+      return;
+    data_[idx]     = val;
+    uint16_t chunk = idx / chunk_size;
+    dirty_[chunk / 8] |= 1 << (chunk % 8);
+  }
+
+  bool isSliceUninitialized(uint16_t offset, uint16_t size) {
+    for (uint16_t o = offset; o < offset + size; o++) {
+      if (data_[o] != _StorageProps::uninitialized_byte)
+        return false;
+    }
+    return true;
+  }
+
+  // Called by `flush()`.
+  void writeBack() {
+    uint16_t dirty_count = 0;
+    for (uint16_t chunk = 0; chunk < chunk_count; chunk++) {
+      if (isDirty(chunk))
+        dirty_count++;
+    }
+    if (dirty_count == 0)
+      return;
+
+    if (active_bank_ == NO_BANK || next_slot_ + dirty_count > records_per_bank) {
+      compact();
+      return;
+    }
+    for (uint16_t chunk = 0; chunk < chunk_count; chunk++) {
+      if (isDirty(chunk))
+        appendRecord(active_bank_, chunk);
+    }
+    memset(dirty_, 0, sizeof(dirty_));
+  }
+
+  Flash &flash() {
+    return flash_;
+  }
+
+ private:
+  static constexpr uint32_t MAGIC   = 0x4b4c4f47;  // "KLOG"
+  static constexpr uint8_t NO_BANK = 0xff;
+
+  struct Header {
+    uint32_t magic;
+    uint32_t sequence;
+  };
+
+  Flash flash_;
+  uint8_t data_[_StorageProps::length];
+  uint8_t dirty_[(chunk_count + 7) / 8];
+  uint8_t active_bank_ = NO_BANK;
+  uint16_t next_slot_  = records_per_bank;
+  uint32_t sequence_   = 0;
+
+  bool isDirty(uint16_t chunk) const {
+    return dirty_[chunk / 8] & (1 << (chunk % 8));
+  }
+
+  static bool isErased(const uint8_t *data, uint16_t size) {
+    for (uint16_t i = 0; i < size; i++) {
+      if (data[i] != 0xff)
+        return false;
+    }
+    return true;
+  }
+
+  static uint16_t recordCRC(const uint8_t *record) {
+    uint16_t crc = 0xffff;
+    for (uint8_t i = 0; i < record_size - 2; i++)
+      crc = _crc_ccitt_update(crc, record[i]);
+    return crc;
+  }
+
+  // The header takes up the first record slot of each bank.
+  static uint32_t recordAddress(uint8_t bank, uint16_t slot) {
+    return bank * bank_size + uint32_t(slot + 1) * record_size;
+  }
+
+  void readHeader(uint8_t bank, Header &header) {
+    uint8_t bytes[record_size];
+    flash_.read(bank * bank_size, bytes, record_size);
+    header.magic    = readWord(&bytes[0]);
+    header.sequence = readWord(&bytes[4]);
+  }
+
+  void writeHeader(uint8_t bank, uint32_t sequence) {
+    uint8_t bytes[record_size];
+    writeWord(&bytes[0], MAGIC);
+    writeWord(&bytes[4], sequence);
+    flash_.program(bank * bank_size, bytes, record_size);
+  }
+
+  void appendRecord(uint8_t bank, uint16_t chunk) {
+    uint8_t record[record_size];
+    record[0] = chunk & 0xff;
+    record[1] = chunk >> 8;
+    memcpy(&record[2], &data_[chunk * chunk_size], chunk_size);
+    uint16_t crc = recordCRC(record);
+    record[6]    = crc & 0xff;
+    record[7]    = crc >> 8;
+    flash_.program(recordAddress(bank, next_slot_++), record, record_size);
+  }
+
+  // Writes a snapshot of all the data to the other bank, and switches to it.
+  // Chunks that were never written are left out; they read back as erased.
+  void compact() {
+    uint8_t bank = active_bank_ == 0 ? 1 : 0;
+    for (uint8_t page = 0; page < _StorageProps::pages_per_bank; page++)
+      flash_.erasePage(bank * _StorageProps::pages_per_bank + page);
+
+    next_slot_ = 0;
+    for (uint16_t chunk = 0; chunk < chunk_count; chunk++) {
+      if (!isErased(&data_[chunk * chunk_size], chunk_size))
+        appendRecord(bank, chunk);
+    }
+    writeHeader(bank, sequence_ + 1);
+
+    active_bank_ = bank;
+    sequence_++;
+    memset(dirty_, 0, sizeof(dirty_));
+  }
+
+  static uint32_t readWord(const uint8_t *bytes) {
+    return uint32_t(bytes[0]) | (uint32_t(bytes[1]) << 8) |
+           (uint32_t(bytes[2]) << 16) | (uint32_t(bytes[3]) << 24);
+  }
+
+  static void writeWord(uint8_t *bytes, uint32_t word) {
+    for (uint8_t i = 0; i < 4; i++)
+      bytes[i] = word >> (i * 8);
+  }
+};
+
+}  // namespace storage
+}  // namespace driver
+}  // namespace kaleidoscope
@@ -0,0 +1,112 @@
+/* -*- mode: c++ -*-
+ * kaleidoscope::driver::storage::SimulatedFlash -- In-memory flash for testing
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifdef KALEIDOSCOPE_VIRTUAL_BUILD
+
+#include <stdint.h>  // for uint8_t, uint16_t, uint32_t
+#include <string.h>  // for memcpy, memset
+
+namespace kaleidoscope {
+namespace driver {
+namespace storage {
+
+/// A `LogStructuredFlash` backend for the virtual build
+///
+/// Keeps the "flash" in memory, and behaves like the real thing in the ways
+/// that matter to a storage driver: erasing sets a page to all ones, and
+/// programming can only clear bits. It counts how many times each page was
+/// erased, and can simulate losing power after a number of operations, after
+/// which everything it is asked to do is silently ignored.
+template<uint16_t _page_size, uint8_t _page_count>
+class SimulatedFlash {
+ public:
+  static constexpr uint32_t total_size = uint32_t(_page_size) * _page_count;
+
+  SimulatedFlash() {
+    memset(data_, 0xff, sizeof(data_));
+  }
+
+  void erasePage(uint16_t page) {
+    if (page >= _page_count || !usePower())
+      return;
+    memset(&data_[uint32_t(page) * _page_size], 0xff, _page_size);
+    erase_counts_[page]++;
+  }
+
+  void program(uint32_t address, const uint8_t *data, uint16_t size) {
+    if (address + size > total_size || !usePower())
+      return;
+    for (uint16_t i = 0; i < size; i++)
+      data_[address + i] &= data[i];
+    program_count_++;
+  }
+
+  void read(uint32_t address, uint8_t *data, uint16_t size) {
+    memcpy(data, &data_[address], size);
+  }
+
+  uint16_t eraseCount(uint16_t page) const {
+    return erase_counts_[page];
+  }
+  uint32_t totalEraseCount() const {
+    uint32_t total = 0;
+    for (uint16_t count : erase_counts_)
+      total += count;
+    return total;
+  }
+  uint32_t programCount() const {
+    return program_count_;
+  }
+
+  /// Direct access to the contents, to inspect or corrupt them.
+  uint8_t *data() {
+    return data_;
+  }
+
+  /// Makes everything after the next `operations` erases and programs fail.
+  void cutPowerAfter(uint32_t operations) {
+    operations_left_ = operations;
+    power_cut_       = true;
+  }
+  void restorePower() {
+    power_cut_ = false;
+  }
+
+ private:
+  uint8_t data_[total_size];
+  uint16_t erase_counts_[_page_count] = {};
+  uint32_t program_count_             = 0;
+  uint32_t operations_left_           = 0;
+  bool power_cut_                     = false;
+
+  bool usePower() {
+    if (!power_cut_)
+      return true;
+    if (operations_left_ == 0)
+      return false;
+    operations_left_--;
+    return true;
+  }
+};
+
+}  // namespace storage
+}  // namespace driver
+}  // namespace kaleidoscope
+
+#endif
@@ -173,6 +173,19 @@ class SignatureCheckDummy {};
              (KeyEvent &event),                                           __NL__ \
              (event), ##__VA_ARGS__)                                      __NL__ \
                                                                           __NL__ \
+   /* Called once per cycle for every keyswitch that is held down, but */ __NL__ \
+   /* only after a plugin has opted in by calling                      */ __NL__ \
+   /* `Runtime.enableHeldKeyswitchEvents()`. Keyscanners only report   */ __NL__ \
+   /* keyswitches that toggle on or off, so this is the only way for a */ __NL__ \
+   /* plugin to act on a held keyswitch every cycle.                   */ __NL__ \
+   OPERATION(onKeyswitchHeld,                                             __NL__ \
+             1,                                                           __NL__ \
+             _CURRENT_IMPLEMENTATION,                                     __NL__ \
+             _ABORTABLE,                                                  __NL__ \
+             (),(),(), /* non template */                                 __NL__ \
+             (KeyAddr key_addr),                                          __NL__ \
+             (key_addr), ##__VA_ARGS__)                                   __NL__ \
+                                                                          __NL__ \
    /* Function called for every logical key event, including ones that */ __NL__ \
    /* originate from a physical keyswitch and ones that are injected   */ __NL__ \
    /* by plugins. The `event` parameter is passed by reference so its  */ __NL__ \
@@ -234,6 +247,16 @@ class SignatureCheckDummy {};
                 _NOT_ABORTABLE,                                           __NL__ \
                 (),(),(), /* non template */                              __NL__ \
                 (), (), ##__VA_ARGS__)                                    __NL__ \
+   /* Called when the contents of storage were replaced behind the     */ __NL__ \
+   /* back of the plugins (by the eeprom.contents Focus command, for   */ __NL__ \
+   /* example). Plugins that keep anything derived from storage in     */ __NL__ \
+   /* RAM should reload it.                                            */ __NL__ \
+   OPERATION(onStorageChange,                                             __NL__ \
+             1,                                                           __NL__ \
+             _CURRENT_IMPLEMENTATION,                                     __NL__ \
+                _NOT_ABORTABLE,                                           __NL__ \
+                (),(),(), /* non template */                              __NL__ \
+                (), (), ##__VA_ARGS__)                                    __NL__ \
    /* Called immediately before the LEDs get updated. This is for */      __NL__ \
    /* plugins that override the current LED mode. */                      __NL__ \
    OPERATION(beforeSyncingLeds,                                           __NL__ \
@@ -276,6 +299,17 @@ class SignatureCheckDummy {};
                (),(),(), /* non template */                               __NL__ \
                (),(),##__VA_ARGS__)                                       __NL__ \
                                                                           __NL__ \
+   /* Called at the end of a cycle, when idle sleep is enabled, no     */ __NL__ \
+   /* keyswitches are pressed, and the keyboard is about to sleep      */ __NL__ \
+   /* until the next timer deadline. A plugin that still needs to be   */ __NL__ \
+   /* called every cycle should return `ABORT` to stay awake.          */ __NL__ \
+   OPERATION(beforeSleeping,                                              __NL__ \
+             1,                                                           __NL__ \
+             _CURRENT_IMPLEMENTATION,                                     __NL__ \
+             _ABORTABLE,                                                  __NL__ \
+             (),(),(), /* non template */                                 __NL__ \
+             (),(),##__VA_ARGS__)                                         __NL__ \
+                                                                          __NL__ \
    /* Called before setup to enable plugins at compile time            */ __NL__ \
    /* to explore the sketch.                                           */ __NL__ \
    OPERATION(exploreSketch ,                                              __NL__ \
@@ -328,6 +362,10 @@ class SignatureCheckDummy {};
       OP(onKeyswitchEvent, 1)                                           __NL__ \
    END(onKeyswitchEvent, 1)                                             __NL__ \
                                                                         __NL__ \
+   START(onKeyswitchHeld, 1)                                            __NL__ \
+      OP(onKeyswitchHeld, 1)                                            __NL__ \
+   END(onKeyswitchHeld, 1)                                              __NL__ \
+                                                                        __NL__ \
    START(onKeyEvent, 1)                                                 __NL__ \
       OP(onKeyEvent, 1)                                                 __NL__ \
    END(onKeyEvent, 1)                                                   __NL__ \
@@ -348,6 +386,10 @@ class SignatureCheckDummy {};
       OP(onLEDModeChange, 1)                                            __NL__ \
    END(onLEDModeChange, 1)                                              __NL__ \
                                                                         __NL__ \
+   START(onStorageChange, 1)                                            __NL__ \
+      OP(onStorageChange, 1)                                            __NL__ \
+   END(onStorageChange, 1)                                              __NL__ \
+                                                                        __NL__ \
    START(beforeSyncingLeds, 1)                                          __NL__ \
       OP(beforeSyncingLeds, 1)                                          __NL__ \
    END(beforeSyncingLeds, 1)                                            __NL__ \
@@ -364,6 +406,10 @@ class SignatureCheckDummy {};
       OP(afterEachCycle, 1)                                             __NL__ \
    END(afterEachCycle, 1)                                               __NL__ \
                                                                         __NL__ \
+   START(beforeSleeping, 1)                                             __NL__ \
+      OP(beforeSleeping, 1)                                             __NL__ \
+   END(beforeSleeping, 1)                                               __NL__ \
+                                                                        __NL__ \
    START(exploreSketch, 1)                                              __NL__ \
       OP(exploreSketch, 1)                                              __NL__ \
    END(exploreSketch, 1)
@@ -16,7 +16,8 @@
 
 #pragma once
 
-#include <stdint.h>  // for uint8_t
+#include <Arduino.h>  // for pgm_read_byte
+#include <stdint.h>   // for uint8_t
 
 #include "kaleidoscope/KeyAddr.h"          // for KeyAddr
 #include "kaleidoscope/device/device.h"    // for Device
@@ -25,10 +26,21 @@
 
 extern const Key keymaps_linear[][kaleidoscope_internal::device.matrix_rows * kaleidoscope_internal::device.matrix_columns];
 
+// Bitmaps of the non-transparent keys in each layer of `keymaps_linear`, stored
+// in PROGMEM, one bit per key (by `KeyAddr::toInt()`), with each layer padded
+// to a whole number of bytes. These are generated at compile time by the
+// `KEYMAPS()` macro; if the sketch doesn't use it, this is `nullptr`.
+extern const uint8_t *const keymaps_opaque_keys;
+
 namespace kaleidoscope {
 
 inline Key keyFromKeymap(uint8_t layer, KeyAddr key_addr) {
   return keymaps_linear[layer][key_addr.toInt()].readFromProgmem();
 }
 
+inline uint8_t opaqueKeysFromKeymap(uint8_t layer, uint8_t block) {
+  constexpr uint8_t blocks_per_layer = (kaleidoscope_internal::device.numKeys() + 7) / 8;
+  return pgm_read_byte(&keymaps_opaque_keys[(layer * blocks_per_layer) + block]);
+}
+
 }  // namespace kaleidoscope
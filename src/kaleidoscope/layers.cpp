@@ -15,7 +15,7 @@
  */
 
 #include <stdint.h>  // for uint8_t, int8_t
-#include <string.h>  // for memmove, memset
+#include <string.h>  // for memmove
 
 #include "kaleidoscope/KeyAddr.h"          // for MatrixAddr, MatrixAddr<>::Range, KeyAddr
 #include "kaleidoscope/KeyAddrMap.h"       // for KeyAddrMap<>::Iterator, KeyAddrMap
@@ -25,7 +25,7 @@
 #include "kaleidoscope/device/device.h"    // for Device
 #include "kaleidoscope/hooks.h"            // for Hooks
 #include "kaleidoscope/key_defs.h"         // for Key, LAYER_MOVE_OFFSET, LAYER_SHIFT_OFFSET
-#include "kaleidoscope/keymaps.h"          // for keyFromKeymap
+#include "kaleidoscope/keymaps.h"          // for keyFromKeymap, keymaps_opaque_keys, opaqueKeysFr...
 #include "kaleidoscope/keyswitch_state.h"  // for keyToggledOn
 #include "kaleidoscope/layers.h"           // for Layer_, Layer, Layer_::GetKeyFunction, Layer_:...
 #include "kaleidoscope_internal/device.h"  // for device
@@ -43,12 +43,16 @@ uint8_t layer_count = 0;
 
 __attribute__((weak)) extern constexpr Key keymaps_linear[][kaleidoscope_internal::device.matrix_rows * kaleidoscope_internal::device.matrix_columns] = {};
 
+__attribute__((weak)) extern const uint8_t *const keymaps_opaque_keys = nullptr;
+
 namespace kaleidoscope {
 uint8_t Layer_::active_layer_count_ = 1;
 int8_t Layer_::active_layers_[MAX_ACTIVE_LAYERS];
 
 uint8_t Layer_::active_layer_keymap_[kaleidoscope_internal::device.numKeys()];
 Layer_::GetKeyFunction Layer_::getKey = &Layer_::getKeyFromPROGMEM;
+Layer_::GetOpaqueKeysFunction Layer_::getOpaqueKeys_ = &Layer_::getOpaqueKeysFromPROGMEM;
+Layer_::GetKeyFunction Layer_::opaque_keys_source_   = &Layer_::getKeyFromPROGMEM;
 
 void Layer_::setup() {
   // Update the active layer cache (every entry will be `0` to start)
@@ -142,29 +146,93 @@ Key Layer_::getKeyFromPROGMEM(uint8_t layer, KeyAddr key_addr) {
   return keyFromKeymap(layer, key_addr);
 }
 
-void Layer_::updateActiveLayers(void) {
-  // First, set every entry in the active layer keymap to point to the default
-  // layer (layer 0).
-  memset(active_layer_keymap_, 0, kaleidoscope_internal::device.numKeys());
-
-  // For each key address, set its entry in the active layer keymap to the value
-  // of the top active layer that has a non-transparent entry for that address.
-  for (auto key_addr : KeyAddr::all()) {
-    for (uint8_t i = active_layer_count_; i > 0; --i) {
-      uint8_t layer = unshifted(active_layers_[i - 1]);
-
-      Key key = (*getKey)(layer, key_addr);
-      if (key != Key_Transparent) {
-        active_layer_keymap_[key_addr.toInt()] = layer;
-        break;
-      }
+uint8_t Layer_::getOpaqueKeysFromPROGMEM(uint8_t layer, uint8_t block) {
+  // If the sketch didn't define its keymap with `KEYMAPS()`, there's no
+  // precomputed bitmap table to read from.
+  if (keymaps_opaque_keys == nullptr)
+    return getOpaqueKeysFromGetKey(&getKeyFromPROGMEM, layer, block);
+  return opaqueKeysFromKeymap(layer, block);
+}
+
+uint8_t Layer_::getOpaqueKeysFromGetKey(GetKeyFunction get_key,
+                                        uint8_t layer,
+                                        uint8_t block) {
+  uint8_t keys        = 0;
+  uint8_t start_index = block * 8;
+  for (uint8_t bit = 0; bit < 8; ++bit) {
+    uint8_t index = start_index + bit;
+    if (index >= kaleidoscope_internal::device.numKeys())
+      break;
+    if ((*get_key)(layer, KeyAddr(index)) != Key_Transparent)
+      keys |= (1 << bit);
+  }
+  return keys;
+}
+
+void Layer_::setKeymapSource(GetKeyFunction get_key,
+                             GetOpaqueKeysFunction get_opaque_keys) {
+  getKey              = get_key;
+  getOpaqueKeys_      = get_opaque_keys;
+  opaque_keys_source_ = get_key;
+  updateActiveLayers();
+}
+
+uint8_t Layer_::opaqueKeys(uint8_t layer, uint8_t block) {
+  // If `getKey` was replaced without also supplying a matching bitmap source,
+  // the bitmaps have to be computed from `getKey` itself.
+  if (getKey != opaque_keys_source_)
+    return getOpaqueKeysFromGetKey(getKey, layer, block);
+  return (*getOpaqueKeys_)(layer, block);
+}
+
+void Layer_::updateActiveLayerBlock(uint8_t block, uint8_t keys) {
+  // Starting from the top of the active layer stack, each key in `keys` gets
+  // its entry in the active layer keymap set to the first layer that has a
+  // non-transparent entry for it, eight keys at a time.
+  for (uint8_t i = active_layer_count_; i > 0 && keys != 0; --i) {
+    uint8_t layer = unshifted(active_layers_[i - 1]);
+    uint8_t found = opaqueKeys(layer, block) & keys;
+    keys &= ~found;
+
+    uint8_t *entry = &active_layer_keymap_[block * 8];
+    for (; found != 0; found >>= 1, ++entry) {
+      if (found & 1)
+        *entry = layer;
     }
   }
-  // Even if there are no active layers (a situation that should be prevented by
-  // `deactivate()`), each key will be mapped from the base layer (layer
-  // 0). Likewise, for any address where all active layers have a transparent
-  // entry, that key will be mapped from the base layer, even if the base layer
-  // has been deactivated.
+  // Any key that's transparent on all active layers gets mapped from the base
+  // layer (layer 0), even if the base layer has been deactivated.
+  uint8_t *entry = &active_layer_keymap_[block * 8];
+  for (; keys != 0; keys >>= 1, ++entry) {
+    if (keys & 1)
+      *entry = 0;
+  }
+}
+
+void Layer_::updateActiveLayers(void) {
+  // Rebuild the whole active layer keymap. Even if there are no active layers
+  // (a situation that should be prevented by `deactivate()`), each key will be
+  // mapped from the base layer (layer 0).
+  for (uint8_t block = 0; block < opaque_key_blocks_; ++block) {
+    uint8_t keys = 0xff;
+    // The last block might not be full.
+    uint8_t remaining = kaleidoscope_internal::device.numKeys() - (block * 8);
+    if (remaining < 8)
+      keys = (1 << remaining) - 1;
+    updateActiveLayerBlock(block, keys);
+  }
+}
+
+void Layer_::updateActiveLayers(uint8_t layer) {
+  // When a single layer is added to or removed from the stack, only the keys
+  // that aren't transparent on that layer can change, so we leave the rest of
+  // the active layer keymap alone.
+  layer = unshifted(layer);
+  for (uint8_t block = 0; block < opaque_key_blocks_; ++block) {
+    uint8_t keys = opaqueKeys(layer, block);
+    if (keys != 0)
+      updateActiveLayerBlock(block, keys);
+  }
 }
 
 void Layer_::move(uint8_t layer) {
@@ -198,16 +266,24 @@ void Layer_::activate(uint8_t layer) {
 
   // Guarantee that we don't overflow by removing layers from the bottom if
   // we're about to exceed the size of the active layers array.
+  bool removed_bottom_layer = false;
   while (active_layer_count_ >= MAX_ACTIVE_LAYERS) {
     remove(0);
+    removed_bottom_layer = true;
   }
 
   // Otherwise, push it onto the active layer stack
   active_layers_[active_layer_count_++] = layer;
 
   // Update the keymap cache (but not live_composite_keymap_; that gets
-  // updated separately, when keys toggle on or off. See layers.h)
-  updateActiveLayers();
+  // updated separately, when keys toggle on or off. See layers.h). Unless we
+  // had to drop layers from the bottom of the stack, only the keys covered by
+  // the new top layer can have changed.
+  if (removed_bottom_layer) {
+    updateActiveLayers();
+  } else {
+    updateActiveLayers(layer);
+  }
 
   kaleidoscope::Hooks::onLayerChange();
 }
@@ -236,8 +312,9 @@ void Layer_::deactivate(uint8_t layer) {
   // above it down to fill in the gap.
   remove(current_pos);
 
-  // Update the keymap cache.
-  updateActiveLayers();
+  // Update the keymap cache. Only the keys covered by the removed layer can
+  // have changed.
+  updateActiveLayers(layer);
 
   kaleidoscope::Hooks::onLayerChange();
 }
@@ -54,6 +54,7 @@
    uint8_t layer_count                                                  __NL__ \
       = sizeof(keymaps_linear) / sizeof(*keymaps_linear);               __NL__ \
                                                                         __NL__ \
+  _INIT_KEYMAP_OPAQUE_KEYS                                              __NL__ \
   _INIT_SKETCH_EXPLORATION                                              __NL__ \
   _INIT_HID_GETSHORTNAME
 
@@ -128,6 +129,25 @@ class Layer_ {
 
   static Key getKeyFromPROGMEM(uint8_t layer, KeyAddr key_addr);
 
+  // To keep the active layer keymap up to date without looking up every key on
+  // every active layer, each keymap source also provides a bitmap of the keys
+  // that are not transparent on each layer. A `GetOpaqueKeysFunction` returns
+  // one byte of that bitmap: bit `n` is set if the key with the index
+  // `(block * 8) + n` (by `KeyAddr::toInt()`) is not transparent on `layer`.
+  typedef uint8_t (*GetOpaqueKeysFunction)(uint8_t layer, uint8_t block);
+
+  static uint8_t getOpaqueKeysFromPROGMEM(uint8_t layer, uint8_t block);
+  static uint8_t getOpaqueKeysFromGetKey(GetKeyFunction get_key,
+                                         uint8_t layer,
+                                         uint8_t block);
+
+  // Plugins that provide their own keymap should use this instead of assigning
+  // to `getKey` directly, so that the bitmaps come from the same source. If
+  // `getKey` is replaced some other way, the bitmaps get computed with calls to
+  // `getKey` instead, which is much slower.
+  static void setKeymapSource(GetKeyFunction get_key,
+                              GetOpaqueKeysFunction get_opaque_keys);
+
   static void updateActiveLayers(void);
 
  private:
@@ -141,6 +161,14 @@ class Layer_ {
   static int8_t active_layers_[MAX_ACTIVE_LAYERS];
   static uint8_t active_layer_keymap_[kaleidoscope_internal::device.numKeys()];
 
+  static constexpr uint8_t opaque_key_blocks_ = (kaleidoscope_internal::device.numKeys() + 7) / 8;
+  static GetOpaqueKeysFunction getOpaqueKeys_;
+  static GetKeyFunction opaque_keys_source_;
+
+  static uint8_t opaqueKeys(uint8_t layer, uint8_t block);
+  static void updateActiveLayers(uint8_t layer);
+  static void updateActiveLayerBlock(uint8_t block, uint8_t keys);
+
   static int8_t stackPosition(uint8_t layer);
   static void remove(uint8_t stack_index);
   static uint8_t unshifted(uint8_t layer);
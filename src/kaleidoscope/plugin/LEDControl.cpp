@@ -19,7 +19,6 @@
 #include <Arduino.h>                   // for PSTR, strncmp_P
 #include <Kaleidoscope-FocusSerial.h>  // for Focus, FocusSerial
 
-#include "kaleidoscope/KeyAddrMap.h"               // for KeyAddrMap<>::Iterator, KeyAddrMap
 #include "kaleidoscope/KeyEvent.h"                 // for KeyEvent
 #include "kaleidoscope/KeyMap.h"                   // for KeyMap
 #include "kaleidoscope/LiveKeys.h"                 // for LiveKeys, live_keys
@@ -38,11 +37,13 @@ uint8_t LEDControl::mode_id_       = uninitialized_mode_id;
 uint8_t LEDControl::num_led_modes_ = LEDModeManager::numLEDModes();
 LEDMode *LEDControl::cur_led_mode_ = nullptr;
 bool LEDControl::enabled_          = true;
+bool LEDControl::leds_changed_     = true;
 
 LEDControl::LEDControl(void) {
 }
 uint8_t LEDControl::sync_interval_   = 32;
 uint16_t LEDControl::last_sync_time_ = 0;
+Timer LEDControl::sync_timer_{LEDControl::onSyncTimeout};
 
 void LEDControl::next_mode() {
   ++mode_id_;
@@ -112,11 +113,18 @@ void LEDControl::set_all_leds_to(cRGB color) {
 }
 
 void LEDControl::setCrgbAt(uint8_t led_index, cRGB crgb) {
+  // LED modes often repaint LEDs with the color they already have, so only an
+  // actual change makes the next sync send anything.
+  if (Runtime.device().LEDs().isValid(led_index)) {
+    cRGB old_color = Runtime.device().getCrgbAt(led_index);
+    if (old_color.r != crgb.r || old_color.g != crgb.g || old_color.b != crgb.b)
+      leds_changed_ = true;
+  }
   Runtime.device().setCrgbAt(led_index, crgb);
 }
 
 void LEDControl::setCrgbAt(KeyAddr key_addr, cRGB color) {
-  Runtime.device().setCrgbAt(key_addr, color);
+  setCrgbAt(Runtime.device().getLedIndex(key_addr), color);
 }
 
 cRGB LEDControl::getCrgbAt(uint8_t led_index) {
@@ -135,6 +143,11 @@ void LEDControl::syncLeds(void) {
   // efficiently.
   Hooks::beforeSyncingLeds();
 
+  // If nothing changed since the last sync, there is nothing to send.
+  if (!leds_changed_)
+    return;
+  leds_changed_ = false;
+
   Runtime.device().syncLeds();
 }
 
@@ -147,6 +160,9 @@ EventHandlerResult LEDControl::onSetup() {
     set_mode(0);
   }
 
+  if (enabled_)
+    startSyncTimer();
+
   return EventHandlerResult::OK;
 }
 
@@ -154,12 +170,18 @@ void LEDControl::disable() {
   set_all_leds_to(CRGB(0, 0, 0));
   Runtime.device().syncLeds();
   enabled_ = false;
+  Runtime.stopTimer(sync_timer_);
 }
 
 void LEDControl::enable() {
   enabled_ = true;
   refreshAll();
   Runtime.device().syncLeds();
+  startSyncTimer();
+}
+
+void LEDControl::startSyncTimer() {
+  Runtime.startTimer(sync_timer_, last_sync_time_, sync_interval_);
 }
 
 EventHandlerResult LEDControl::onKeyEvent(KeyEvent &event) {
@@ -171,8 +193,8 @@ EventHandlerResult LEDControl::onKeyEvent(KeyEvent &event) {
       // First, check for an active shift key.
       bool shift_active = false;
       // This change should be back-ported to #904
-      for (Key active_key : live_keys.all()) {
-        if (active_key.isKeyboardShift()) {
+      for (KeyAddr key_addr : live_keys.active()) {
+        if (live_keys.read(key_addr).isKeyboardShift()) {
           shift_active = true;
           break;
         }
@@ -199,17 +221,14 @@ EventHandlerResult LEDControl::onKeyEvent(KeyEvent &event) {
   return EventHandlerResult::EVENT_CONSUMED;
 }
 
-EventHandlerResult LEDControl::afterEachCycle() {
-  if (!enabled_)
-    return EventHandlerResult::OK;
-
-  if (Runtime.hasTimeExpired(last_sync_time_, sync_interval_)) {
-    syncLeds();
-    last_sync_time_ += sync_interval_;
-    update();
-  }
-
-  return EventHandlerResult::OK;
+void LEDControl::onSyncTimeout() {
+  syncLeds();
+  last_sync_time_ += sync_interval_;
+  update();
+  // If we've fallen behind (e.g. after the LEDs have been disabled for a
+  // while), the deadline will already have passed, and the timer will expire
+  // again next cycle, until we've caught up.
+  startSyncTimer();
 }
 
 
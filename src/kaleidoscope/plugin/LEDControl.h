@@ -21,6 +21,7 @@
 #include "kaleidoscope/KeyAddr.h"                  // for KeyAddr
 #include "kaleidoscope/KeyEvent.h"                 // for KeyEvent
 #include "kaleidoscope/Runtime.h"                  // for Runtime, Runtime_
+#include "kaleidoscope/Timer.h"                    // for Timer
 #include "kaleidoscope/device/device.h"            // for cRGB, Device, Base<>::LEDDriver, Virtu...
 #include "kaleidoscope/event_handler_result.h"     // for EventHandlerResult
 #include "kaleidoscope/key_defs.h"                 // for Key, IS_INTERNAL, KEY_FLAGS, SYNTHETIC
@@ -100,11 +101,12 @@ class LEDControl : public kaleidoscope::Plugin {
 
   static void setSyncInterval(uint8_t interval) {
     sync_interval_ = interval;
+    if (sync_timer_.isPending())
+      startSyncTimer();
   }
 
   EventHandlerResult onSetup();
   EventHandlerResult onKeyEvent(KeyEvent &event);
-  EventHandlerResult afterEachCycle();
 
   static void disable();
   static void enable();
@@ -114,6 +116,7 @@ class LEDControl : public kaleidoscope::Plugin {
 
   static void setBrightness(uint8_t brightness) {
     Runtime.device().ledDriver().setBrightness(brightness);
+    leds_changed_ = true;
   }
   static uint8_t getBrightness() {
     return Runtime.device().ledDriver().getBrightness();
@@ -122,10 +125,16 @@ class LEDControl : public kaleidoscope::Plugin {
  private:
   static uint16_t last_sync_time_;
   static uint8_t sync_interval_;
+  static Timer sync_timer_;
   static uint8_t mode_id_;
   static uint8_t num_led_modes_;
   static LEDMode *cur_led_mode_;
   static bool enabled_;
+  // Whether any LED changed color since the last time they were synced.
+  static bool leds_changed_;
+
+  static void startSyncTimer();
+  static void onSyncTimeout();
 };
 
 
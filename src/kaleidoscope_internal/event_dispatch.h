@@ -39,6 +39,7 @@
 #include "kaleidoscope/macro_helpers.h"                                   // for __NL__, UNWRAP
 #include "kaleidoscope/plugin.h"  // IWYU pragma: keep
 #include "kaleidoscope_internal/eventhandler_signature_check.h"           // for _PREPARE_EVENT_...
+#include "kaleidoscope_internal/hook_profiling.h"                         // for _INIT_HOOK_PROF...
 #include "kaleidoscope_internal/sketch_exploration/plugin_exploration.h"  // for _INIT_PLUGIN_EX...
 #include "kaleidoscope_internal/sketch_exploration/sketch_exploration.h"  // IWYU pragma: keep
 
@@ -122,6 +123,14 @@
         return SHOULD_EXIT_IF_RESULT_NOT_OK;                              __NL__ \
       }                                                                   __NL__ \
                                                                           __NL__ \
+      template<typename Plugin__>                                         __NL__ \
+      static constexpr bool isImplementedBy() {                           __NL__ \
+        return HookVersionImplemented_##HOOK_NAME<                        __NL__ \
+                 Plugin__, HOOK_VERSION>::value;                          __NL__ \
+      }                                                                   __NL__ \
+                                                                          __NL__ \
+      _HOOK_PROFILING_HOOK_NAME(HOOK_NAME)                                __NL__ \
+                                                                          __NL__ \
       template<typename Plugin__,                                         __NL__ \
                typename... Args__>                                        __NL__ \
       static kaleidoscope::EventHandlerResult                             __NL__ \
@@ -166,7 +175,7 @@
 
 #define _INLINE_EVENT_HANDLER_FOR_PLUGIN(PLUGIN)                            \
                                                                      __NL__ \
-   result = EventHandler__::call(PLUGIN, hook_args...);              __NL__ \
+   result = _INLINE_EVENT_HANDLER_CALL(PLUGIN);                      __NL__ \
                                                                      __NL__ \
    if (EventHandler__::shouldExitIfResultNotOk() &&                  __NL__ \
        result != kaleidoscope::EventHandlerResult::OK) {             __NL__ \
@@ -193,6 +202,7 @@
     static kaleidoscope::EventHandlerResult apply(Args__&&... hook_args) {    __NL__ \
                                                                               __NL__ \
       kaleidoscope::EventHandlerResult result;                                __NL__ \
+      _HOOK_PROFILING_PLUGIN_INDEX                                            __NL__ \
       MAP(_INLINE_EVENT_HANDLER_FOR_PLUGIN, __VA_ARGS__)                      __NL__ \
                                                                               __NL__ \
       return result;                                                          __NL__ \
@@ -218,4 +228,8 @@
   /* LEDModeFactory entries                                                */ __NL__ \
   _INIT_LED_MODE_MANAGER(__VA_ARGS__)                                         __NL__ \
                                                                               __NL__ \
-  _INIT_PLUGIN_EXPLORATION(__VA_ARGS__)
+  _INIT_PLUGIN_EXPLORATION(__VA_ARGS__)                                       __NL__ \
+                                                                              __NL__ \
+  /* When profiling event handlers, this stores the plugin names, so they  */ __NL__ \
+  /* can be reported along with the statistics                             */ __NL__ \
+  _INIT_HOOK_PROFILING(__VA_ARGS__)
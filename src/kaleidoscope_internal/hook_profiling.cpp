@@ -0,0 +1,41 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope_internal/hook_profiling.h"
+
+#ifdef KALEIDOSCOPE_PROFILE_HOOKS
+
+namespace kaleidoscope_internal {
+
+HookProfile *hook_profiles = nullptr;
+
+void HookProfile::record(uint8_t index, const char *name, uint32_t elapsed) {
+  if (!registered) {
+    registered    = true;
+    plugin_index  = index;
+    hook_name     = name;
+    next          = hook_profiles;
+    hook_profiles = this;
+  }
+  ++count;
+  total_time += elapsed;
+  if (elapsed > max_time)
+    max_time = elapsed > UINT16_MAX ? UINT16_MAX : elapsed;
+}
+
+}  // namespace kaleidoscope_internal
+
+#endif  // ifdef KALEIDOSCOPE_PROFILE_HOOKS
@@ -0,0 +1,134 @@
+/* Kaleidoscope - Firmware for computer input devices
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Optional instrumentation of the event handler calls made by the
+// EventDispatcher.
+//
+// When the firmware is built with `KALEIDOSCOPE_PROFILE_HOOKS` defined, every
+// call to an event handler that a plugin actually implements is timed, and the
+// number of calls, the total time, and the longest single call are accumulated
+// in a `HookProfile` record for that (plugin, hook) pair. The records are only
+// created for handlers that exist, and they are linked into a list the first
+// time the handler gets called, so the table stays as small as possible.
+//
+// Without the flag, none of this exists, and the dispatch code is exactly the
+// same as it would be without this header.
+
+#pragma once
+
+#ifdef KALEIDOSCOPE_PROFILE_HOOKS
+
+#include <Arduino.h>  // for micros, PROGMEM
+#include <stdint.h>   // for uint8_t, uint16_t, uint32_t
+
+#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
+
+namespace kaleidoscope_internal {
+
+// This has to stay an aggregate without any initializers, so that the
+// function-local static instances below are zero-initialized at load time,
+// rather than being guarded by a run-time initialization check.
+struct HookProfile {
+  HookProfile *next;
+  const char *hook_name;  // in PROGMEM
+  uint8_t plugin_index;
+  bool registered;
+  uint16_t max_time;
+  uint32_t count;
+  uint32_t total_time;
+
+  void record(uint8_t index, const char *name, uint32_t elapsed);
+  void reset() {
+    count      = 0;
+    total_time = 0;
+    max_time   = 0;
+  }
+};
+
+// The head of the list of all profile records that have been used so far.
+extern HookProfile *hook_profiles;
+
+// The (stringified) argument list of `KALEIDOSCOPE_INIT_PLUGINS()`, used to
+// look up plugin names by index. Defined by `_INIT_HOOK_PROFILING()`.
+extern const char hook_profiling_plugin_names[];
+
+// Timestamp used for profiling, in microseconds.
+inline uint32_t hookProfilingTimestamp() {
+  return micros();
+}
+
+// Handlers that a plugin doesn't implement are called without any profiling,
+// so they still compile down to nothing at all.
+template<bool hook_is_implemented__>
+struct ProfiledEventHandler {
+  template<typename EventHandler__, typename Plugin__, Plugin__ *plugin__, typename... Args__>
+  static kaleidoscope::EventHandlerResult call(uint8_t /*plugin_index*/, Args__ &&...hook_args) {
+    return EventHandler__::call(*plugin__, hook_args...);
+  }
+};
+
+// The plugin instance is a template parameter, rather than just its type, so
+// that each instance gets its own profile record, even if a sketch uses more
+// than one instance of the same plugin class.
+template<>
+struct ProfiledEventHandler<true> {
+  template<typename EventHandler__, typename Plugin__, Plugin__ *plugin__, typename... Args__>
+  static kaleidoscope::EventHandlerResult call(uint8_t plugin_index, Args__ &&...hook_args) {
+    static HookProfile profile;
+
+    uint32_t start = hookProfilingTimestamp();
+    kaleidoscope::EventHandlerResult result =
+      EventHandler__::call(*plugin__, hook_args...);
+    profile.record(plugin_index, EventHandler__::hookName(),
+                   hookProfilingTimestamp() - start);
+    return result;
+  }
+};
+
+}  // namespace kaleidoscope_internal
+
+// clang-format off
+
+#define _INIT_HOOK_PROFILING(...)                                            \
+  namespace kaleidoscope_internal {                                          \
+  const char hook_profiling_plugin_names[] PROGMEM = #__VA_ARGS__;           \
+  }
+
+#define _HOOK_PROFILING_HOOK_NAME(HOOK_NAME)                                 \
+  static const char *hookName() {                                            \
+    return PSTR(#HOOK_NAME);                                                 \
+  }
+
+#define _HOOK_PROFILING_PLUGIN_INDEX                                         \
+  uint8_t plugin_index__ = 0;
+
+#define _INLINE_EVENT_HANDLER_CALL(PLUGIN)                                   \
+  kaleidoscope_internal::ProfiledEventHandler<                               \
+    EventHandler__::template isImplementedBy<decltype(PLUGIN)>()             \
+  >::template call<EventHandler__, decltype(PLUGIN), &PLUGIN>(               \
+    plugin_index__++, hook_args...)
+
+// clang-format on
+
+#else  // ifdef KALEIDOSCOPE_PROFILE_HOOKS
+
+#define _INIT_HOOK_PROFILING(...)
+#define _HOOK_PROFILING_HOOK_NAME(HOOK_NAME)
+#define _HOOK_PROFILING_PLUGIN_INDEX
+#define _INLINE_EVENT_HANDLER_CALL(PLUGIN) \
+  EventHandler__::call(PLUGIN, hook_args...)
+
+#endif  // ifdef KALEIDOSCOPE_PROFILE_HOOKS
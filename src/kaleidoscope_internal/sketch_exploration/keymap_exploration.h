@@ -169,6 +169,39 @@ struct HasKey {
   Key k_;
 };
 
+// Compile-time generation of per-layer bitmaps of the keys that are not
+// transparent (see `_INIT_KEYMAP_OPAQUE_KEYS` below).
+//
+template<uint16_t... _indices>
+struct IndexSequence {};
+
+template<uint16_t _n, uint16_t... _indices>
+struct MakeIndexSequence : MakeIndexSequence<_n - 1, _n - 1, _indices...> {};
+
+template<uint16_t... _indices>
+struct MakeIndexSequence<0, _indices...> {
+  typedef IndexSequence<_indices...> Type;
+};
+
+// COMPILE_TIME_USE_ONLY (see explanation below)
+//
+// Returns one byte of a layer's bitmap: bit `n` is set if the key at offset
+// `(block * 8) + n` is not transparent.
+//
+template<int _n_layers, int _layer_size>
+constexpr uint8_t opaqueKeysBlock(const Key (&keymap)[_n_layers][_layer_size],
+                                  uint8_t layer,
+                                  uint8_t block,
+                                  uint8_t bit = 0) {
+  return (bit >= 8)
+           ? 0
+           : ((((block * 8) + bit < _layer_size) &&
+               (keymap[layer][(block * 8) + bit] != Key_Transparent))
+                ? (1 << bit)
+                : 0) |
+               opaqueKeysBlock(keymap, layer, block, bit + 1);
+}
+
 extern void pluginsExploreSketch();
 
 //!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
@@ -295,6 +328,41 @@ extern void pluginsExploreSketch();
   } /* namespace sketch_exploration */                                         \
   } /* namespace kaleidoscope */
 
+// This macro generates a PROGMEM table with a bitmap of the non-transparent
+// keys of each layer of the sketch's keymap, for use by
+// `Layer_::updateActiveLayers()`, and points `keymaps_opaque_keys` at it.
+//
+#define _INIT_KEYMAP_OPAQUE_KEYS                                               \
+  namespace kaleidoscope { /* NOLINT(build/namespaces) */                      \
+  namespace sketch_exploration {                                               \
+                                                                               \
+    template<typename _Indices>                                                \
+    struct OpaqueKeys;                                                         \
+                                                                               \
+    template<uint16_t... _indices>                                             \
+    struct OpaqueKeys<IndexSequence<_indices...>> {                            \
+      static constexpr uint8_t blocks_per_layer                                \
+        = (sizeof(*::keymaps_linear) / sizeof(**::keymaps_linear) + 7) / 8;    \
+      static const uint8_t bitmaps[] PROGMEM;                                  \
+    };                                                                         \
+                                                                               \
+    template<uint16_t... _indices>                                             \
+    const uint8_t OpaqueKeys<IndexSequence<_indices...>>::bitmaps[] PROGMEM = {\
+      opaqueKeysBlock(::keymaps_linear,                                        \
+                      _indices / OpaqueKeys::blocks_per_layer,                 \
+                      _indices % OpaqueKeys::blocks_per_layer)...              \
+    };                                                                         \
+                                                                               \
+    typedef OpaqueKeys<MakeIndexSequence<                                      \
+      (sizeof(::keymaps_linear) / sizeof(*::keymaps_linear)) *                 \
+      ((sizeof(*::keymaps_linear) / sizeof(**::keymaps_linear) + 7) / 8)       \
+    >::Type> SketchOpaqueKeys;                                                 \
+  } /* namespace sketch_exploration */                                         \
+  } /* namespace kaleidoscope */                                               \
+                                                                               \
+  const uint8_t *const keymaps_opaque_keys                                     \
+    = kaleidoscope::sketch_exploration::SketchOpaqueKeys::bitmaps;
+
 // clang-format on
 
 }  // namespace sketch_exploration
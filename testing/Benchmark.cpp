@@ -0,0 +1,64 @@
+/* kailedoscope::sim - Simulator for Unit Testing Kaleidoscope
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testing/Benchmark.h"
+
+#include <algorithm>  // for sort
+#include <cstdio>     // for fprintf, fopen, fclose, FILE, stderr, stdout
+#include <cstdlib>    // for getenv
+
+namespace kaleidoscope {
+namespace testing {
+
+void Benchmark::record(const char *name, uint32_t events, std::vector<double> rounds) {
+  std::sort(rounds.begin(), rounds.end());
+  results_.push_back({name, events, rounds[rounds.size() / 2], rounds.front()});
+}
+
+bool Benchmark::writeResults() const {
+  const char *path = std::getenv("KALEIDOSCOPE_BENCHMARK_OUTPUT");
+  FILE *output     = stdout;
+  if (path != nullptr && *path != '\0') {
+    output = std::fopen(path, "w");
+    if (output == nullptr) {
+      std::fprintf(stderr, "Could not open %s for writing\n", path);
+      return false;
+    }
+  }
+
+  // The names are chosen by the benchmarks themselves, so they don't need any
+  // escaping.
+  std::fprintf(output, "{\"suite\": \"%s\", \"results\": [", suite_.c_str());
+  for (size_t i = 0; i < results_.size(); ++i) {
+    const Result &result = results_[i];
+    std::fprintf(output,
+                 "%s\n  {\"name\": \"%s\", \"events\": %u, "
+                 "\"ns_per_event\": %.2f, \"min_ns_per_event\": %.2f}",
+                 i == 0 ? "" : ",",
+                 result.name.c_str(),
+                 unsigned(result.events),
+                 result.median_ns_per_event,
+                 result.min_ns_per_event);
+  }
+  std::fprintf(output, "\n]}\n");
+
+  if (output != stdout)
+    std::fclose(output);
+  return true;
+}
+
+}  // namespace testing
+}  // namespace kaleidoscope
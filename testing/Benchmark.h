@@ -0,0 +1,83 @@
+/* kailedoscope::sim - Simulator for Unit Testing Kaleidoscope
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>   // for duration, steady_clock
+#include <cstdint>  // for uint32_t, uint8_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+namespace kaleidoscope {
+namespace testing {
+
+// Microbenchmarks for the virtual device.
+//
+// Each measurement calls a function a fixed number of times, in several
+// rounds, and records the time spent per event (as defined by the caller) in
+// each round. The median and the fastest round are reported; the median is what
+// should be tracked over time, and the fastest round shows how noisy the
+// measurement was. Timings are taken with the host's clock, so they are only
+// comparable between runs on the same machine.
+class Benchmark {
+ public:
+  explicit Benchmark(const char *suite)
+    : suite_(suite) {}
+
+  template<typename _Function>
+  void measure(const char *name,
+               uint32_t iterations,
+               uint32_t events_per_iteration,
+               _Function function) {
+    // One untimed call, so that the first round doesn't pay for cold caches,
+    // or for any lazy initialization the function triggers.
+    function();
+
+    std::vector<double> rounds;
+    for (uint8_t round = 0; round < rounds_per_measurement; ++round) {
+      auto start = std::chrono::steady_clock::now();
+      for (uint32_t i = 0; i < iterations; ++i)
+        function();
+      std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+      rounds.push_back(elapsed.count() / (double(iterations) * events_per_iteration));
+    }
+    record(name, iterations * events_per_iteration, rounds);
+  }
+
+  // Writes the results as a JSON object to the file named by the
+  // `KALEIDOSCOPE_BENCHMARK_OUTPUT` environment variable, or to stdout if that
+  // isn't set. Returns `false` if the file couldn't be written.
+  bool writeResults() const;
+
+  static constexpr uint8_t rounds_per_measurement = 5;
+
+ private:
+  struct Result {
+    std::string name;
+    uint32_t events;
+    double median_ns_per_event;
+    double min_ns_per_event;
+  };
+
+  std::string suite_;
+  std::vector<Result> results_;
+
+  void record(const char *name, uint32_t events, std::vector<double> rounds);
+};
+
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,137 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint8_t, uint32_t
+#include <vector>   // for vector
+
+#include "kaleidoscope/KeyAddr.h"          // for KeyAddr
+#include "kaleidoscope/KeyEvent.h"         // for KeyEvent
+#include "kaleidoscope/keyswitch_state.h"  // for IS_PRESSED, WAS_PRESSED
+
+namespace kaleidoscope {
+namespace testing {
+
+struct TraceEvent {
+  KeyAddr addr;
+  bool press;
+};
+
+// A small deterministic pseudo-random number generator, so that the traces are
+// the same on every run.
+class TraceRandom {
+ public:
+  explicit TraceRandom(uint32_t seed)
+    : state_(seed) {}
+  uint32_t next(uint32_t limit) {
+    state_ = state_ * 1664525 + 1013904223;
+    return (state_ >> 8) % limit;
+  }
+
+ private:
+  uint32_t state_;
+};
+
+// Generates a trace of a fast typist rolling over keys on the alphanumeric
+// block: up to `max_held` keys are held at once, and keys are mostly released
+// in the order they were pressed, but not always.
+inline std::vector<TraceEvent> rolloverTrace(size_t keystrokes,
+                                             uint8_t max_held,
+                                             uint32_t seed) {
+  TraceRandom random(seed);
+  std::vector<TraceEvent> trace;
+  std::vector<KeyAddr> held;
+  size_t pressed = 0;
+  while (pressed < keystrokes || !held.empty()) {
+    bool can_press = pressed < keystrokes && held.size() < max_held;
+    if (can_press && (held.empty() || random.next(3) != 0)) {
+      KeyAddr addr;
+      bool already_held;
+      do {
+        addr         = KeyAddr(1 + random.next(3), 1 + random.next(5));
+        already_held = false;
+        for (KeyAddr h : held)
+          already_held |= (h == addr);
+      } while (already_held);
+      held.push_back(addr);
+      trace.push_back({addr, true});
+      ++pressed;
+    } else {
+      size_t i = (random.next(4) == 0) ? random.next(held.size()) : 0;
+      trace.push_back({held[i], false});
+      held.erase(held.begin() + i);
+    }
+  }
+  return trace;
+}
+
+// The home row keys act as qukeys.
+inline bool isQukey(KeyAddr addr) {
+  return addr.row() == 2;
+}
+
+// Replays a trace through an event queue the way the Qukeys plugin uses it:
+// events are queued while a qukey press is at the head of the queue, and the
+// queue is searched on every new event to find out if the qukey has been
+// resolved. Once it is, the head of the queue is flushed one event at a time,
+// until another unresolved qukey press reaches the head. Returns a checksum of
+// the flushed events, which depends on their order (but not on their event IDs,
+// which differ from one replay to the next).
+template<typename _Queue>
+uint32_t replayQukeysTrace(_Queue &queue, const std::vector<TraceEvent> &trace) {
+  uint32_t checksum = 0;
+  auto flush        = [&]() {
+    checksum = checksum * 31 + queue.addr(0).toInt();
+    checksum = checksum * 31 + queue.isRelease(0);
+    queue.shift();
+  };
+  auto headIsResolved = [&]() {
+    if (queue.isRelease(0) || !isQukey(queue.addr(0)) || queue.isFull())
+      return true;
+    KeyAddr head = queue.addr(0);
+    for (uint8_t i{1}; i < queue.length(); ++i) {
+      if (queue.addr(i) == head)
+        return true;  // tapped
+      if (queue.isPress(i)) {
+        for (uint8_t j = i + 1; j < queue.length(); ++j) {
+          if (queue.isRelease(j) && queue.addr(j) == queue.addr(i))
+            return true;  // held, with a subsequent key overlapping
+        }
+      }
+    }
+    return false;
+  };
+
+  for (const TraceEvent &e : trace) {
+    KeyEvent event = KeyEvent::next(e.addr, e.press ? IS_PRESSED : WAS_PRESSED);
+    if (queue.isEmpty() && !(e.press && isQukey(e.addr))) {
+      checksum = checksum * 31 + e.addr.toInt();
+      continue;
+    }
+    queue.append(event);
+    while (!queue.isEmpty() && headIsResolved())
+      flush();
+  }
+  while (!queue.isEmpty())
+    flush();
+  return checksum;
+}
+
+}  // namespace testing
+}  // namespace kaleidoscope
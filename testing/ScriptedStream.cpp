@@ -0,0 +1,55 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testing/ScriptedStream.h"
+
+namespace kaleidoscope {
+namespace testing {
+
+void ScriptedStream::addInput(const std::string &input) {
+  input_ += input;
+}
+
+std::string ScriptedStream::takeOutput() {
+  std::string output;
+  output.swap(output_);
+  return output;
+}
+
+int ScriptedStream::available() {
+  return input_.size();
+}
+
+int ScriptedStream::read() {
+  int byte = peek();
+  if (byte >= 0)
+    input_.erase(0, 1);
+  return byte;
+}
+
+int ScriptedStream::peek() {
+  if (input_.empty())
+    return -1;
+  return uint8_t(input_[0]);
+}
+
+size_t ScriptedStream::write(uint8_t byte) {
+  output_ += char(byte);
+  return 1;
+}
+
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,49 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <Arduino.h>  // for Stream
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint8_t
+#include <string>     // for string
+
+namespace kaleidoscope {
+namespace testing {
+
+// A `Stream` that reads what a test gave it, and collects what is written to
+// it, for testing code that talks to the host, such as Focus (see
+// `Focus.setSerialPort()`).
+class ScriptedStream : public Stream {
+ public:
+  // Adds `input` to what is left to be read.
+  void addInput(const std::string &input);
+  // Returns everything written since the last call.
+  std::string takeOutput();
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t byte) override;
+  using Print::write;
+
+ private:
+  std::string input_;
+  std::string output_;
+};
+
+}  // namespace testing
+}  // namespace kaleidoscope
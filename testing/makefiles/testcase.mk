@@ -29,6 +29,11 @@ FQBN     	= $(shell cat sketch.yaml|grep default_fqbn | cut -d " " -f 2)
 
 pathsafe_fqbn   := $(subst :,_,${FQBN})
 
+# A testcase that needs its sketch built with extra flags (for features that
+# are compiled in only on request) sets `LOCAL_CFLAGS` in a `test.mk` of its
+# own. The sketch is built in its own directory, so this affects no other test.
+-include test.mk
+
 build_root       := ${top_dir}/_build/$(pathsafe_fqbn)
 
 
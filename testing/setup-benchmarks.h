@@ -0,0 +1,48 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2020  Eric Paniagua (epaniagua@google.com)
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// NOTE: This should always be the last header file included in benchmark
+// source files.
+
+#pragma once
+
+#include <HIDReportObserver.h>  // for HIDReportObserver
+#include <Kaleidoscope.h>       // IWYU pragma: keep
+
+// Kaleidoscope.h includes Arduino, which unwisely defines `min` and `max` as
+// preprocessor macros.  We need to undefine these macros before including any
+// files from the standard library.
+#undef min
+#undef max
+
+#include "testing/Benchmark.h"   // IWYU pragma: keep
+#include "testing/SimHarness.h"  // IWYU pragma: keep
+
+// Each benchmark sketch defines this function, which runs its measurements.
+void runBenchmarks(kaleidoscope::testing::Benchmark &benchmark);
+
+// The HID reports are dropped, rather than being logged or recorded, so that
+// the benchmarks measure the firmware, not the simulator.
+#define SETUP_BENCHMARKS(SUITE)                                    \
+  void executeTestFunction() {                                     \
+    setup(); /* setup Kaleidoscope */                              \
+    /* Turn off virtual_io's input. */                             \
+    Kaleidoscope.device().keyScanner().setEnableReadMatrix(false); \
+    HIDReportObserver::resetHook(nullptr);                         \
+    kaleidoscope::testing::Benchmark benchmark(SUITE);             \
+    runBenchmarks(benchmark);                                      \
+    exit(benchmark.writeResults() ? 0 : 1);                        \
+  }
@@ -0,0 +1,78 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cstdint>  // for uint8_t, uint16_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+namespace kaleidoscope {
+namespace testing {
+
+// Raw samples of a single keyswitch, one character per scan: `1` if the switch
+// was closed when it was sampled, `0` if it was open.
+struct BounceTrace {
+  const char *name;
+  const char *samples;
+};
+
+// clang-format off
+static const BounceTrace bounce_traces[] = {
+  // A switch that doesn't bounce at all.
+  {"clean",           "0000011111111111100000000000"},
+  // Contacts chattering for a few scans when the switch closes.
+  {"press-bounce",    "0000010110111111111111000000000"},
+  // Contacts chattering when the switch opens.
+  {"release-bounce",  "0000011111111111101001010000000000"},
+  // Chatter on both edges, with the longest bursts we expect from worn
+  // switches.
+  {"both-bounce",     "0000101101011111111111110101001000000000"},
+  // A tap so short that the switch only stays closed for two scans.
+  {"short-tap",       "0000011000000000"},
+};
+// clang-format on
+
+// A single scan's worth of noise on an otherwise idle switch.
+static const BounceTrace noise_trace = {"noise", "000000100000000000"};
+
+inline std::vector<uint16_t> traceSamples(const BounceTrace &trace) {
+  std::vector<uint16_t> samples;
+  for (const char *c = trace.samples; *c != '\0'; ++c)
+    samples.push_back(*c == '1');
+  return samples;
+}
+
+// Merges traces into a sequence of row states, with the samples of the trace
+// at index `n` in column `n`. Shorter traces are padded with their last sample.
+inline std::vector<uint16_t> mergeTraces(const std::vector<std::vector<uint16_t>> &traces) {
+  size_t length = 0;
+  for (const auto &trace : traces)
+    length = trace.size() > length ? trace.size() : length;
+
+  std::vector<uint16_t> rows(length, 0);
+  for (size_t col = 0; col < traces.size(); ++col) {
+    for (size_t i = 0; i < length; ++i) {
+      uint16_t sample = i < traces[col].size() ? traces[col][i] : traces[col].back();
+      rows[i] |= sample << col;
+    }
+  }
+  return rows;
+}
+
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,259 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>  // for uint16_t, uint8_t, uint32_t
+#include <string>    // for string
+#include <vector>    // for vector
+
+#include "./bounce_traces.h"                          // for BounceTrace, bounce_traces, noise_trace
+#include "kaleidoscope/driver/keyscanner/Debounce.h"  // for Counter, Eager, Asymmetric, Integrator, None
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using driver::keyscanner::debounce::Asymmetric;
+using driver::keyscanner::debounce::Counter;
+using driver::keyscanner::debounce::Eager;
+using driver::keyscanner::debounce::Integrator;
+using driver::keyscanner::debounce::None;
+
+// Feeds a sequence of raw samples of a row to a debouncer, and returns the
+// debounced state after each one.
+template<typename Debouncer>
+std::vector<uint16_t> debounceTrace(Debouncer &debouncer,
+                                    const std::vector<uint16_t> &samples) {
+  std::vector<uint16_t> states;
+  for (uint16_t sample : samples) {
+    uint16_t previous = debouncer.state();
+    uint16_t changes  = debouncer.debounce(sample);
+    EXPECT_EQ(changes, uint16_t(previous ^ debouncer.state()));
+    states.push_back(debouncer.state());
+  }
+  return states;
+}
+
+TEST(CounterDebouncer, RequiresFourStableSamples) {
+  Counter<uint16_t> debouncer;
+  std::vector<uint16_t> samples  = {1, 1, 1, 1, 1, 0, 0, 0, 0};
+  std::vector<uint16_t> expected = {0, 0, 0, 1, 1, 1, 1, 1, 0};
+  EXPECT_EQ(debounceTrace(debouncer, samples), expected);
+}
+
+TEST(CounterDebouncer, FiltersBounces) {
+  Counter<uint16_t> debouncer;
+  std::vector<uint16_t> samples  = {1, 0, 1, 1, 0, 1, 1, 1, 1};
+  std::vector<uint16_t> expected = {0, 0, 0, 0, 0, 0, 0, 0, 1};
+  EXPECT_EQ(debounceTrace(debouncer, samples), expected);
+}
+
+TEST(EagerDebouncer, ReportsFirstEdge) {
+  Eager<uint16_t, 4> debouncer;
+  EXPECT_EQ(debouncer.debounce(0b0101), 0b0101);
+  EXPECT_EQ(debouncer.state(), 0b0101);
+}
+
+TEST(EagerDebouncer, IgnoresBouncesDuringSettleWindow) {
+  Eager<uint16_t, 4> debouncer;
+  // The press is reported right away, the bounces that follow are ignored, and
+  // the release is reported on the first sample after the settle window.
+  std::vector<uint16_t> samples  = {1, 0, 1, 0, 1, 0, 0, 1, 0, 0};
+  std::vector<uint16_t> expected = {1, 1, 1, 1, 1, 0, 0, 0, 0, 0};
+  EXPECT_EQ(debounceTrace(debouncer, samples), expected);
+}
+
+TEST(EagerDebouncer, LocksOutKeysIndependently) {
+  Eager<uint16_t, 3> debouncer;
+  // Column 0 is pressed first, column 1 two scans later; each key's settle
+  // window starts with its own edge.
+  std::vector<uint16_t> samples  = {0b01, 0b00, 0b10, 0b01, 0b00, 0b00, 0b00};
+  std::vector<uint16_t> expected = {0b01, 0b01, 0b11, 0b11, 0b10, 0b10, 0b00};
+  EXPECT_EQ(debounceTrace(debouncer, samples), expected);
+}
+
+TEST(EagerDebouncer, HandlesAllColumns) {
+  Eager<uint16_t, 2> debouncer;
+  EXPECT_EQ(debouncer.debounce(0xffff), 0xffff);
+  EXPECT_EQ(debouncer.debounce(0x0000), 0x0000);
+  EXPECT_EQ(debouncer.debounce(0x0000), 0x0000);
+  EXPECT_EQ(debouncer.debounce(0x0000), 0xffff);
+  EXPECT_EQ(debouncer.state(), 0x0000);
+}
+
+// Returns the debounced states of a single key for a trace.
+template<typename Debouncer>
+std::vector<uint16_t> debounceSingleTrace(const BounceTrace &trace) {
+  Debouncer debouncer;
+  return debounceTrace(debouncer, traceSamples(trace));
+}
+
+// Returns the number of times the state toggles in a sequence of states.
+uint8_t countToggles(const std::vector<uint16_t> &states) {
+  uint8_t toggles = 0;
+  uint16_t last   = 0;
+  for (uint16_t state : states) {
+    if (state != last)
+      ++toggles;
+    last = state;
+  }
+  return toggles;
+}
+
+// Returns the number of scans between the first pressed sample of a trace and
+// the debounced press.
+template<typename Debouncer>
+int pressLatency(const BounceTrace &trace) {
+  std::vector<uint16_t> samples = traceSamples(trace);
+  std::vector<uint16_t> states  = debounceSingleTrace<Debouncer>(trace);
+  int first_sample = -1;
+  for (size_t i = 0; i < samples.size(); ++i) {
+    if (samples[i]) {
+      first_sample = i;
+      break;
+    }
+  }
+  for (size_t i = 0; i < states.size(); ++i) {
+    if (states[i])
+      return i - first_sample;
+  }
+  return -1;
+}
+
+// Properties every debouncer that is meant to filter chatter must have. The
+// settle window of the eager debouncer has to be longer than the bursts of
+// chatter in the traces, which last up to eight scans.
+template<typename Debouncer>
+class DebouncePolicy : public ::testing::Test {};
+
+typedef ::testing::Types<Counter<uint16_t>,
+                         Asymmetric<uint16_t, 1, 4>,
+                         Asymmetric<uint16_t, 2, 6>,
+                         Integrator<uint16_t, 4>,
+                         Eager<uint16_t, 8>>
+  FilteringPolicies;
+TYPED_TEST_SUITE(DebouncePolicy, FilteringPolicies);
+
+TYPED_TEST(DebouncePolicy, ReportsOnePressAndReleasePerBounceTrace) {
+  for (const BounceTrace &trace : bounce_traces) {
+    if (std::string(trace.name) == "short-tap")
+      continue;
+    std::vector<uint16_t> states = debounceSingleTrace<TypeParam>(trace);
+    EXPECT_EQ(countToggles(states), 2) << "trace: " << trace.name;
+    EXPECT_EQ(states.back(), 0) << "trace: " << trace.name;
+  }
+}
+
+TYPED_TEST(DebouncePolicy, DebouncesColumnsIndependently) {
+  // Running all the traces at once, each in its own column, must give the same
+  // result for every column as running them one at a time.
+  std::vector<std::vector<uint16_t>> traces;
+  for (const BounceTrace &trace : bounce_traces)
+    traces.push_back(traceSamples(trace));
+  traces.push_back(traceSamples(noise_trace));
+
+  std::vector<std::vector<uint16_t>> expected_columns;
+  for (const auto &samples : traces) {
+    TypeParam debouncer;
+    expected_columns.push_back(debounceTrace(debouncer, samples));
+  }
+
+  TypeParam debouncer;
+  std::vector<uint16_t> rows = debounceTrace(debouncer, mergeTraces(traces));
+  for (uint8_t col = 0; col < expected_columns.size(); ++col) {
+    std::vector<uint16_t> column;
+    for (size_t i = 0; i < rows.size(); ++i)
+      column.push_back((rows[i] >> col) & 1);
+    column.resize(expected_columns[col].size());
+    EXPECT_EQ(column, expected_columns[col]) << "column " << int(col);
+  }
+}
+
+TEST(DebouncePolicies, PressLatency) {
+  const BounceTrace &clean = bounce_traces[0];
+  EXPECT_EQ(pressLatency<None<uint16_t>>(clean), 0);
+  EXPECT_EQ(pressLatency<Counter<uint16_t>>(clean), 3);
+  EXPECT_EQ((pressLatency<Asymmetric<uint16_t, 1, 4>>(clean)), 0);
+  EXPECT_EQ((pressLatency<Asymmetric<uint16_t, 2, 6>>(clean)), 1);
+  EXPECT_EQ((pressLatency<Integrator<uint16_t, 4>>(clean)), 3);
+  EXPECT_EQ((pressLatency<Eager<uint16_t, 4>>(clean)), 0);
+
+  // Chatter delays the counting debouncers, but not the eager ones.
+  const BounceTrace &press_bounce = bounce_traces[1];
+  EXPECT_EQ(pressLatency<Counter<uint16_t>>(press_bounce), 8);
+  EXPECT_EQ((pressLatency<Integrator<uint16_t, 4>>(press_bounce)), 7);
+  EXPECT_EQ((pressLatency<Asymmetric<uint16_t, 1, 4>>(press_bounce)), 0);
+  EXPECT_EQ((pressLatency<Eager<uint16_t, 4>>(press_bounce)), 0);
+}
+
+TEST(DebouncePolicies, ShortSettleWindowChatters) {
+  EXPECT_GT(countToggles(debounceSingleTrace<None<uint16_t>>(bounce_traces[3])), 2);
+  EXPECT_GT((countToggles(debounceSingleTrace<Eager<uint16_t, 4>>(bounce_traces[3]))), 2);
+}
+
+TEST(DebouncePolicies, Noise) {
+  // The counting debouncers need more than one sample to accept a press, so
+  // they filter out a stray sample; the ones that accept presses immediately
+  // don't.
+  EXPECT_EQ(countToggles(debounceSingleTrace<Counter<uint16_t>>(noise_trace)), 0);
+  EXPECT_EQ((countToggles(debounceSingleTrace<Asymmetric<uint16_t, 2, 6>>(noise_trace))), 0);
+  EXPECT_EQ((countToggles(debounceSingleTrace<Integrator<uint16_t, 4>>(noise_trace))), 0);
+  EXPECT_EQ((countToggles(debounceSingleTrace<Asymmetric<uint16_t, 1, 4>>(noise_trace))), 2);
+  EXPECT_EQ((countToggles(debounceSingleTrace<Eager<uint16_t, 4>>(noise_trace))), 2);
+}
+
+TEST(DebouncePolicies, ShortTap) {
+  // A tap that is shorter than the debounce window is lost by the symmetric
+  // debouncers, but not by the ones that accept presses immediately.
+  const BounceTrace &short_tap = bounce_traces[4];
+  EXPECT_EQ(countToggles(debounceSingleTrace<Counter<uint16_t>>(short_tap)), 0);
+  EXPECT_EQ((countToggles(debounceSingleTrace<Asymmetric<uint16_t, 1, 4>>(short_tap))), 2);
+  EXPECT_EQ((countToggles(debounceSingleTrace<Eager<uint16_t, 4>>(short_tap))), 2);
+}
+
+TEST(DebouncePolicies, SymmetricAsymmetricMatchesCounter) {
+  // A small deterministic pseudo-random number generator, so that the samples
+  // are the same on every run.
+  uint32_t seed = 12345;
+  std::vector<uint16_t> samples;
+  for (int i = 0; i < 2000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    // Keep most keys stable from one sample to the next, so that the counters
+    // get a chance to reach the threshold.
+    uint16_t flips = (seed >> 16) & (seed >> 8);
+    samples.push_back((samples.empty() ? 0 : samples.back()) ^ flips);
+  }
+
+  Counter<uint16_t> counter;
+  Asymmetric<uint16_t, 4, 4> asymmetric;
+  EXPECT_EQ(debounceTrace(counter, samples), debounceTrace(asymmetric, samples));
+}
+
+TEST(DebouncePolicies, WideRows) {
+  Integrator<uint64_t, 3> debouncer;
+  uint64_t high = uint64_t(1) << 63;
+  EXPECT_EQ(debouncer.debounce(high | 1), 0u);
+  EXPECT_EQ(debouncer.debounce(high | 1), 0u);
+  EXPECT_EQ(debouncer.debounce(high), high);
+  EXPECT_EQ(debouncer.state(), high);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
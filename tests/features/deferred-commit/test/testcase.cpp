@@ -0,0 +1,74 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "kaleidoscope/driver/storage/DeferredCommit.h"  // for DeferredCommit
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using driver::storage::DeferredCommit;
+
+class DeferredCommitTest : public VirtualDeviceTest {
+ protected:
+  void SetUp() {
+    VirtualDeviceTest::SetUp();
+    DeferredCommit::cancel();
+    sim_.RunCycle();
+  }
+};
+
+TEST_F(DeferredCommitTest, FlushesAfterTheDelay) {
+  DeferredCommit::schedule(100);
+  EXPECT_TRUE(DeferredCommit::isScheduled());
+
+  sim_.RunForMillis(90);
+  EXPECT_TRUE(DeferredCommit::isScheduled());
+
+  sim_.RunForMillis(20);
+  EXPECT_FALSE(DeferredCommit::isScheduled());
+}
+
+TEST_F(DeferredCommitTest, FurtherCommitsPostponeTheFlush) {
+  DeferredCommit::schedule(100);
+  sim_.RunForMillis(60);
+  DeferredCommit::schedule(100);
+
+  // The first deadline passes without a flush.
+  sim_.RunForMillis(60);
+  EXPECT_TRUE(DeferredCommit::isScheduled());
+
+  sim_.RunForMillis(50);
+  EXPECT_FALSE(DeferredCommit::isScheduled());
+}
+
+TEST_F(DeferredCommitTest, CancelledCommitsDoNotFlush) {
+  DeferredCommit::schedule(100);
+  sim_.RunForMillis(50);
+  DeferredCommit::cancel();
+  EXPECT_FALSE(DeferredCommit::isScheduled());
+
+  sim_.RunForMillis(100);
+  EXPECT_FALSE(DeferredCommit::isScheduled());
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,51 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t
+
+#include "kaleidoscope/KeyAddr.h"               // for KeyAddr
+#include "kaleidoscope/KeyAddrMap.h"            // for KeyAddrMap
+#include "kaleidoscope/event_handler_result.h"  // for EventHandlerResult
+#include "kaleidoscope/plugin.h"                // for Plugin
+
+namespace kaleidoscope {
+namespace plugin {
+
+// Counts the `onKeyswitchHeld()` calls for each keyswitch.
+class HeldKeyswitchCounter : public kaleidoscope::Plugin {
+ public:
+  EventHandlerResult onSetup();
+  EventHandlerResult onKeyswitchHeld(KeyAddr key_addr);
+
+  uint8_t count(KeyAddr key_addr) {
+    return counts_[key_addr];
+  }
+  void reset() {
+    for (KeyAddr key_addr : KeyAddr::all())
+      counts_[key_addr] = 0;
+  }
+
+ private:
+  KeyAddrMap<uint8_t, KeyAddr::upper_limit> counts_;
+};
+
+}  // namespace plugin
+}  // namespace kaleidoscope
+
+extern kaleidoscope::plugin::HeldKeyswitchCounter HeldKeyswitchCounter;
@@ -0,0 +1,79 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "testing/setup-googletest.h"
+
+#include "../common.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+class KeyswitchHeld : public VirtualDeviceTest {
+ protected:
+  void SetUp() {
+    VirtualDeviceTest::SetUp();
+    // Discard any reports left over from a previous testcase.
+    RunCycle();
+    ::HeldKeyswitchCounter.reset();
+  }
+};
+
+TEST_F(KeyswitchHeld, CalledEveryCycleWhileHeld) {
+  KeyAddr key_1{0, 1};
+  KeyAddr key_2{0, 2};
+
+  sim_.Press(key_1);
+  sim_.RunCycles(5);
+  EXPECT_EQ(::HeldKeyswitchCounter.count(key_1), 5);
+  EXPECT_EQ(::HeldKeyswitchCounter.count(key_2), 0);
+
+  sim_.Press(key_2);
+  sim_.RunCycles(3);
+  EXPECT_EQ(::HeldKeyswitchCounter.count(key_1), 8);
+  EXPECT_EQ(::HeldKeyswitchCounter.count(key_2), 3);
+
+  sim_.Release(key_1);
+  sim_.RunCycles(4);
+  EXPECT_EQ(::HeldKeyswitchCounter.count(key_1), 8);
+  EXPECT_EQ(::HeldKeyswitchCounter.count(key_2), 7);
+
+  sim_.Release(key_2);
+  sim_.RunCycles(4);
+  EXPECT_EQ(::HeldKeyswitchCounter.count(key_2), 7);
+}
+
+TEST_F(KeyswitchHeld, HeldKeyProducesSingleReport) {
+  sim_.Press(0, 1);
+  auto state = RunCycle();
+  ASSERT_EQ(state->HIDReports()->Keyboard().size(), 1);
+
+  // Holding the key doesn't produce any new events.
+  sim_.RunCycles(10);
+  state = RunCycle();
+  EXPECT_EQ(state->HIDReports()->Keyboard().size(), 0);
+
+  sim_.Release(0, 1);
+  state = RunCycle();
+  EXPECT_EQ(state->HIDReports()->Keyboard().size(), 1);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
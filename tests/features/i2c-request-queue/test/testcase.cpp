@@ -0,0 +1,215 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>  // for uint8_t
+#include <vector>    // for vector
+
+#include "kaleidoscope/driver/i2c/MockWire.h"      // for MockWire
+#include "kaleidoscope/driver/i2c/RequestQueue.h"  // for Request, RequestQueue
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using driver::i2c::MockWire;
+using driver::i2c::Request;
+
+typedef driver::i2c::RequestQueue<MockWire, 6, 4> Queue;
+
+constexpr uint8_t left_hand  = 0x58;
+constexpr uint8_t right_hand = 0x5b;
+
+// What the callbacks below have seen, so tests can check it.
+struct Device {
+  uint8_t led_value = 0;
+  std::vector<uint8_t> last_read;
+  uint8_t last_status = 0xff;
+  uint8_t completed   = 0;
+};
+
+void prepareLEDs(const Request &request, uint8_t *data) {
+  const Device *device = static_cast<const Device *>(request.context);
+  for (uint8_t i = 0; i < request.length; i++)
+    data[i] = device->led_value + request.tag;
+}
+
+void onComplete(const Request &request, uint8_t status,
+                const uint8_t *data, uint8_t length) {
+  Device *device      = static_cast<Device *>(request.context);
+  device->last_status = status;
+  if (request.isRead())
+    device->last_read.assign(data, data + length);
+  ++device->completed;
+}
+
+Request keyRead(uint8_t address, Device &device) {
+  return Request{address, 4, Request::READ | Request::HIGH_PRIORITY, 0,
+                 &device, nullptr, onComplete};
+}
+
+Request ledWrite(uint8_t address, uint8_t bank, Device &device) {
+  return Request{address, 2, Request::WRITE, bank,
+                 &device, prepareLEDs, onComplete};
+}
+
+std::vector<uint8_t> addresses(const MockWire &wire) {
+  std::vector<uint8_t> result;
+  for (const MockWire::Transfer &transfer : wire.transfers)
+    result.push_back(transfer.address | (transfer.read ? 0x80 : 0));
+  return result;
+}
+
+TEST(I2CRequestQueue, HighPriorityRequestsGoFirst) {
+  Queue queue;
+  Device left, right;
+
+  ASSERT_TRUE(queue.submit(ledWrite(left_hand, 0, left)));
+  ASSERT_TRUE(queue.submit(keyRead(left_hand, left)));
+  ASSERT_TRUE(queue.submit(keyRead(right_hand, right)));
+  queue.run(1);
+
+  std::vector<uint8_t> expected = {left_hand | 0x80, right_hand | 0x80, left_hand};
+  EXPECT_EQ(addresses(queue.backend()), expected);
+  EXPECT_EQ(queue.pending(), 0);
+}
+
+TEST(I2CRequestQueue, LowPriorityRequestsAreSpreadOverRuns) {
+  Queue queue;
+  Device left;
+
+  for (uint8_t bank = 0; bank < 4; bank++)
+    ASSERT_TRUE(queue.submit(ledWrite(left_hand, bank, left)));
+
+  queue.run(0);
+  EXPECT_EQ(queue.backend().transfers.size(), 0u);
+
+  queue.run(3);
+  EXPECT_EQ(queue.backend().transfers.size(), 3u);
+  EXPECT_EQ(queue.pending(), 1);
+
+  queue.run(3);
+  EXPECT_EQ(queue.backend().transfers.size(), 4u);
+  EXPECT_EQ(queue.pending(), 0);
+
+  // Banks are sent in the order they were submitted.
+  for (uint8_t bank = 0; bank < 4; bank++)
+    EXPECT_EQ(queue.backend().transfers[bank].data[0], bank);
+}
+
+TEST(I2CRequestQueue, DuplicateRequestsAreCoalesced) {
+  Queue queue;
+  Device left, right;
+
+  ASSERT_TRUE(queue.submit(ledWrite(left_hand, 1, left)));
+  ASSERT_TRUE(queue.submit(ledWrite(left_hand, 1, left)));
+  ASSERT_TRUE(queue.submit(ledWrite(left_hand, 2, left)));
+  ASSERT_TRUE(queue.submit(ledWrite(right_hand, 1, right)));
+  EXPECT_EQ(queue.pending(), 3);
+}
+
+TEST(I2CRequestQueue, WritesSendTheLatestData) {
+  Queue queue;
+  Device left;
+
+  left.led_value = 10;
+  ASSERT_TRUE(queue.submit(ledWrite(left_hand, 0, left)));
+  left.led_value = 20;
+  ASSERT_TRUE(queue.submit(ledWrite(left_hand, 0, left)));
+  queue.run(1);
+
+  ASSERT_EQ(queue.backend().transfers.size(), 1u);
+  std::vector<uint8_t> expected = {20, 20};
+  EXPECT_EQ(queue.backend().transfers[0].data, expected);
+  EXPECT_EQ(left.last_status, 0);
+}
+
+TEST(I2CRequestQueue, ReadsReportTheirData) {
+  Queue queue;
+  Device left, right;
+
+  queue.backend().respond(left_hand, {1, 2, 3, 4});
+  queue.backend().respond(right_hand, {5, 6});
+  ASSERT_TRUE(queue.submit(keyRead(left_hand, left)));
+  ASSERT_TRUE(queue.submit(keyRead(right_hand, right)));
+  queue.run(0);
+
+  std::vector<uint8_t> expected = {1, 2, 3, 4};
+  EXPECT_EQ(left.last_status, 0);
+  EXPECT_EQ(left.last_read, expected);
+
+  // A short read is reported as a failure, along with what did arrive.
+  expected = {5, 6};
+  EXPECT_NE(right.last_status, 0);
+  EXPECT_EQ(right.last_read, expected);
+}
+
+TEST(I2CRequestQueue, MissingDevicesReportFailures) {
+  Queue queue;
+  Device left;
+
+  queue.backend().setAvailable(left_hand, false);
+  ASSERT_TRUE(queue.submit(keyRead(left_hand, left)));
+  ASSERT_TRUE(queue.submit(ledWrite(left_hand, 0, left)));
+  queue.run(1);
+
+  EXPECT_EQ(left.completed, 2);
+  EXPECT_NE(left.last_status, 0);
+  EXPECT_EQ(queue.pending(), 0);
+}
+
+TEST(I2CRequestQueue, BusyBackendDefersLowPriorityRequests) {
+  Queue queue;
+  Device left, right;
+
+  queue.backend().setWriteDuration(2);
+  ASSERT_TRUE(queue.submit(ledWrite(left_hand, 0, left)));
+  ASSERT_TRUE(queue.submit(ledWrite(left_hand, 1, left)));
+  queue.run(2);
+
+  // The second write has to wait for the first one to finish.
+  EXPECT_EQ(queue.backend().transfers.size(), 1u);
+  EXPECT_EQ(queue.pending(), 1);
+
+  // Reads still get through, after waiting for the write in progress.
+  ASSERT_TRUE(queue.submit(keyRead(right_hand, right)));
+  queue.run(2);
+  std::vector<uint8_t> expected = {left_hand, right_hand | 0x80, left_hand};
+  EXPECT_EQ(addresses(queue.backend()), expected);
+  EXPECT_EQ(queue.pending(), 0);
+}
+
+TEST(I2CRequestQueue, RejectsRequestsThatDoNotFit) {
+  Queue queue;
+  Device left;
+
+  Request too_long = ledWrite(left_hand, 0, left);
+  too_long.length  = 5;
+  EXPECT_FALSE(queue.submit(too_long));
+
+  for (uint8_t bank = 0; bank < 6; bank++)
+    ASSERT_TRUE(queue.submit(ledWrite(left_hand, bank, left)));
+  EXPECT_FALSE(queue.submit(ledWrite(left_hand, 6, left)));
+  // A request already in the queue is still accepted.
+  EXPECT_TRUE(queue.submit(ledWrite(left_hand, 3, left)));
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,104 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <deque>  // for deque
+
+#include "kaleidoscope/KeyAddrEventQueue.h"  // for RingKeyAddrEventQueue, ShiftingKeyAddrE...
+#include "testing/QueueTraces.h"             // for TraceRandom, replayQukeysTrace, rollove...
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+struct ReferenceEntry {
+  KeyAddr addr;
+  KeyEventId id;
+  bool release;
+};
+
+// Checks a queue against a simple reference model, using random operations.
+template<typename _Queue, uint8_t _capacity>
+void checkRandomOperations(uint32_t seed) {
+  _Queue queue;
+  std::deque<ReferenceEntry> reference;
+  TraceRandom random(seed);
+
+  for (int step = 0; step < 5000; ++step) {
+    uint32_t op = random.next(10);
+    if (op < 5) {
+      if (reference.size() < _capacity) {
+        KeyAddr addr(random.next(4), random.next(16));
+        bool release   = random.next(2);
+        KeyEvent event = KeyEvent::next(addr, release ? WAS_PRESSED : IS_PRESSED);
+        queue.append(event);
+        reference.push_back({addr, event.id(), release});
+      }
+    } else if (op < 8) {
+      uint8_t n = random.next(_capacity + 1);
+      queue.remove(n);
+      if (n < reference.size())
+        reference.erase(reference.begin() + n);
+    } else if (op < 9) {
+      uint8_t n = random.next(4);
+      queue.shift(n);
+      if (n >= reference.size()) {
+        reference.clear();
+      } else {
+        reference.erase(reference.begin(), reference.begin() + n);
+      }
+    } else if (random.next(10) == 0) {
+      queue.clear();
+      reference.clear();
+    }
+
+    ASSERT_EQ(queue.length(), reference.size()) << "step " << step;
+    ASSERT_EQ(queue.isFull(), reference.size() == _capacity);
+    for (uint8_t i = 0; i < queue.length(); ++i) {
+      ASSERT_EQ(queue.addr(i), reference[i].addr) << "step " << step << ", entry " << int(i);
+      ASSERT_EQ(queue.id(i), reference[i].id) << "step " << step << ", entry " << int(i);
+      ASSERT_EQ(queue.isRelease(i), reference[i].release) << "step " << step << ", entry " << int(i);
+    }
+  }
+}
+
+TEST(KeyAddrEventQueue, ShiftingQueueOperations) {
+  checkRandomOperations<ShiftingKeyAddrEventQueue<8>, 8>(1);
+  checkRandomOperations<ShiftingKeyAddrEventQueue<40>, 40>(2);
+}
+
+TEST(KeyAddrEventQueue, RingQueueOperations) {
+  checkRandomOperations<RingKeyAddrEventQueue<8>, 8>(1);
+  checkRandomOperations<RingKeyAddrEventQueue<13>, 13>(3);
+  checkRandomOperations<RingKeyAddrEventQueue<40>, 40>(2);
+}
+
+TEST(KeyAddrEventQueue, QukeysTracesMatch) {
+  for (uint8_t max_held = 2; max_held <= 6; ++max_held) {
+    auto trace = rolloverTrace(500, max_held, max_held);
+    ShiftingKeyAddrEventQueue<8> shifting;
+    RingKeyAddrEventQueue<8> ring;
+    EXPECT_EQ(replayQukeysTrace(shifting, trace), replayQukeysTrace(ring, trace))
+      << "max_held = " << int(max_held);
+  }
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,85 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>  // for uint8_t, uint16_t, uint32_t
+
+#include "kaleidoscope/driver/led/DirtyBanks.h"  // for DirtyBanks
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using driver::led::DirtyBanks;
+
+static_assert(sizeof(DirtyBanks<4>) == sizeof(uint8_t), "");
+static_assert(sizeof(DirtyBanks<9>) == sizeof(uint16_t), "");
+static_assert(sizeof(DirtyBanks<18>) == sizeof(uint32_t), "");
+
+template<uint8_t _bank_count>
+void clearAll(DirtyBanks<_bank_count> &banks) {
+  for (uint8_t bank = 0; bank < _bank_count; bank++)
+    banks.clear(bank);
+}
+
+TEST(LEDDirtyBanks, AllBanksStartOutDirty) {
+  DirtyBanks<9> banks;
+  for (uint8_t bank = 0; bank < 9; bank++)
+    EXPECT_TRUE(banks.isDirty(bank));
+
+  clearAll(banks);
+  EXPECT_FALSE(banks.any());
+
+  banks.markAll();
+  for (uint8_t bank = 0; bank < 9; bank++)
+    EXPECT_TRUE(banks.isDirty(bank));
+}
+
+TEST(LEDDirtyBanks, OnlyChangedColorsMarkTheirBank) {
+  DirtyBanks<4> banks;
+  clearAll(banks);
+
+  cRGB red   = CRGB(255, 0, 0);
+  cRGB green = CRGB(0, 255, 0);
+
+  banks.update(1, red, red);
+  EXPECT_FALSE(banks.any());
+
+  banks.update(2, red, green);
+  EXPECT_TRUE(banks.any());
+  EXPECT_FALSE(banks.isDirty(1));
+  EXPECT_TRUE(banks.isDirty(2));
+
+  banks.clear(2);
+  EXPECT_FALSE(banks.any());
+}
+
+TEST(LEDDirtyBanks, TracksBanksBeyondSixteen) {
+  DirtyBanks<18> banks;
+  clearAll(banks);
+
+  banks.mark(17);
+  EXPECT_TRUE(banks.isDirty(17));
+  EXPECT_FALSE(banks.isDirty(16));
+  EXPECT_FALSE(banks.isDirty(1));
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
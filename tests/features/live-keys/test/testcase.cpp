@@ -0,0 +1,156 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vector>  // for vector
+
+#include "kaleidoscope/KeyAddr.h"          // for KeyAddr
+#include "kaleidoscope/KeyAddrBitfield.h"  // for KeyAddrBitfield
+#include "kaleidoscope/LiveKeys.h"         // for LiveKeys, live_keys
+#include "kaleidoscope/Runtime.h"          // for Runtime, Runtime_
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+class LiveKeysActive : public VirtualDeviceTest {
+ protected:
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    live_keys.clear();
+  }
+
+  std::vector<KeyAddr> activeAddrs() {
+    std::vector<KeyAddr> result;
+    for (KeyAddr key_addr : live_keys.active())
+      result.push_back(key_addr);
+    return result;
+  }
+
+  // The addresses in the index, stray ones included.
+  std::vector<KeyAddr> indexedAddrs() {
+    std::vector<KeyAddr> result;
+    for (KeyAddr key_addr : live_keys.activeIndex())
+      result.push_back(key_addr);
+    return result;
+  }
+};
+
+TEST_F(LiveKeysActive, NothingActive) {
+  EXPECT_TRUE(activeAddrs().empty());
+}
+
+TEST_F(LiveKeysActive, VisitsActiveEntriesInOrder) {
+  live_keys.activate(KeyAddr(3, 15), Key_B);
+  live_keys.activate(KeyAddr(0, 1), Key_A);
+  live_keys.activate(KeyAddr(2, 3), Key_LeftShift);
+
+  std::vector<KeyAddr> expected = {KeyAddr(0, 1), KeyAddr(2, 3), KeyAddr(3, 15)};
+  EXPECT_EQ(activeAddrs(), expected);
+}
+
+TEST_F(LiveKeysActive, SkipsClearedAndMaskedEntries) {
+  live_keys.activate(KeyAddr(0, 1), Key_A);
+  live_keys.activate(KeyAddr(1, 1), Key_B);
+  live_keys.activate(KeyAddr(1, 2), Key_C);
+  live_keys.activate(KeyAddr(2, 2), Key_D);
+  live_keys.activate(KeyAddr(2, 5), Key_Masked);
+  live_keys.mask(KeyAddr(1, 1));
+  live_keys.clear(KeyAddr(1, 2));
+
+  std::vector<KeyAddr> expected = {KeyAddr(0, 1), KeyAddr(2, 2)};
+  EXPECT_EQ(activeAddrs(), expected);
+}
+
+TEST_F(LiveKeysActive, DirectWrites) {
+  // Writing through `operator[]` can't be tracked exactly, but it must never
+  // hide an active entry, and stale entries must not be visited.
+  live_keys[KeyAddr(1, 4)] = Key_A;
+  live_keys[KeyAddr(2, 4)] = Key_Inactive;
+  live_keys.activate(KeyAddr(3, 4), Key_B);
+  live_keys[KeyAddr(3, 4)] = Key_Masked;
+
+  std::vector<KeyAddr> expected = {KeyAddr(1, 4)};
+  EXPECT_EQ(activeAddrs(), expected);
+}
+
+TEST_F(LiveKeysActive, ReadsLeaveTheIndexExact) {
+  live_keys.activate(KeyAddr(1, 1), Key_A);
+  live_keys.activate(KeyAddr(2, 2), Key_B);
+
+  for (KeyAddr key_addr : KeyAddr::all()) {
+    live_keys.read(key_addr);
+    Runtime.lookupKey(key_addr);
+  }
+
+  std::vector<KeyAddr> expected = {KeyAddr(1, 1), KeyAddr(2, 2)};
+  EXPECT_EQ(indexedAddrs(), expected);
+}
+
+TEST_F(LiveKeysActive, KeyEventsLeaveTheIndexExact) {
+  sim_.Press(KeyAddr(0, 1));
+  sim_.RunCycle();
+  sim_.Press(KeyAddr(0, 2));
+  sim_.RunCycle();
+  EXPECT_EQ(indexedAddrs(), (std::vector<KeyAddr>{KeyAddr(0, 1), KeyAddr(0, 2)}));
+
+  sim_.Release(KeyAddr(0, 1));
+  sim_.RunCycle();
+  EXPECT_EQ(indexedAddrs(), std::vector<KeyAddr>{KeyAddr(0, 2)});
+
+  sim_.Release(KeyAddr(0, 2));
+  sim_.RunCycle();
+  EXPECT_TRUE(indexedAddrs().empty());
+}
+
+TEST_F(LiveKeysActive, ChangesWhileIterating) {
+  for (KeyAddr key_addr : KeyAddr::all())
+    live_keys.activate(key_addr, Key_A);
+
+  // Deactivating entries that have already been visited, or the current one,
+  // doesn't affect the iteration.
+  int count = 0;
+  for (KeyAddr key_addr : live_keys.active()) {
+    live_keys.clear(key_addr);
+    ++count;
+  }
+  EXPECT_EQ(count, int(KeyAddr::upper_limit));
+  EXPECT_TRUE(activeAddrs().empty());
+}
+
+TEST(KeyAddrBitfield, IteratesOverSetBitsInOrder) {
+  KeyAddrBitfield bitfield;
+  std::vector<KeyAddr> expected;
+  for (uint8_t i = 0; i < KeyAddr::upper_limit - 1; i += 5) {
+    bitfield.set(KeyAddr(i));
+    expected.push_back(KeyAddr(i));
+  }
+  KeyAddr last{uint8_t(KeyAddr::upper_limit - 1)};
+  bitfield.set(last);
+  expected.push_back(last);
+
+  std::vector<KeyAddr> visited;
+  for (KeyAddr key_addr : bitfield)
+    visited.push_back(key_addr);
+  EXPECT_EQ(visited, expected);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
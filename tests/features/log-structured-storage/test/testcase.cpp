@@ -0,0 +1,185 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "kaleidoscope/driver/storage/LogStructuredFlash.h"  // for LogStructuredFlash, LogStructuredFlashProps
+#include "kaleidoscope/driver/storage/SimulatedFlash.h"      // for SimulatedFlash
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using driver::storage::LogStructuredFlash;
+using driver::storage::LogStructuredFlashProps;
+using driver::storage::SimulatedFlash;
+
+// 32 bytes of data, in two banks of two 64 byte pages each, which leaves room
+// for 15 records per bank.
+struct TestStorageProps : LogStructuredFlashProps {
+  static constexpr uint16_t length        = 32;
+  static constexpr uint16_t page_size     = 64;
+  static constexpr uint8_t pages_per_bank = 2;
+  static constexpr uint16_t commit_delay  = 0;
+  typedef SimulatedFlash<page_size, pages_per_bank * 2> Flash;
+};
+
+typedef LogStructuredFlash<TestStorageProps> TestStorage;
+
+class LogStructuredStorage : public VirtualDeviceTest {
+ protected:
+  TestStorage storage_;
+
+  void SetUp() {
+    VirtualDeviceTest::SetUp();
+    storage_.setup();
+  }
+
+  // Simulates a reboot: the contents of the flash are kept, everything in RAM
+  // is thrown away.
+  void reload() {
+    TestStorage::Flash flash = storage_.flash();
+    storage_                 = TestStorage();
+    storage_.flash()         = flash;
+    storage_.setup();
+  }
+};
+
+TEST_F(LogStructuredStorage, StartsOutUninitialized) {
+  EXPECT_TRUE(storage_.isSliceUninitialized(0, TestStorageProps::length));
+  EXPECT_EQ(storage_.flash().totalEraseCount(), 0u);
+}
+
+TEST_F(LogStructuredStorage, DataSurvivesAReload) {
+  uint32_t value = 0x12345678;
+  storage_.put(6, value);
+  storage_.update(31, 42);
+  storage_.commit();
+
+  reload();
+
+  uint32_t result = 0;
+  storage_.get(6, result);
+  EXPECT_EQ(result, value);
+  EXPECT_EQ(storage_.read(31), 42);
+  EXPECT_TRUE(storage_.isSliceUninitialized(10, 20));
+}
+
+TEST_F(LogStructuredStorage, UnchangedDataIsNotWrittenAgain) {
+  storage_.update(0, 1);
+  storage_.commit();
+  uint32_t programs = storage_.flash().programCount();
+
+  storage_.update(0, 1);
+  storage_.commit();
+  EXPECT_EQ(storage_.flash().programCount(), programs);
+}
+
+TEST_F(LogStructuredStorage, ChangesAreAppended) {
+  storage_.update(0, 1);
+  storage_.commit();
+  uint32_t erases = storage_.flash().totalEraseCount();
+
+  // Each of these appends a single record, without erasing anything.
+  for (uint8_t i = 2; i < 10; i++) {
+    uint32_t programs = storage_.flash().programCount();
+    storage_.update(0, i);
+    storage_.commit();
+    EXPECT_EQ(storage_.flash().programCount(), programs + 1);
+  }
+  EXPECT_EQ(storage_.flash().totalEraseCount(), erases);
+
+  reload();
+  EXPECT_EQ(storage_.read(0), 9);
+}
+
+TEST_F(LogStructuredStorage, CompactionSpreadsTheWear) {
+  for (uint8_t i = 1; i <= 30; i++)
+    storage_.update(i, i);
+  storage_.commit();
+
+  // Rewriting a whole page on every commit would erase one 200 times.
+  for (uint8_t i = 0; i < 200; i++) {
+    storage_.update(0, i);
+    storage_.commit();
+  }
+
+  for (uint16_t page = 0; page < 4; page++)
+    EXPECT_LT(storage_.flash().eraseCount(page), 15u);
+
+  reload();
+  EXPECT_EQ(storage_.read(0), 199);
+  for (uint8_t i = 1; i <= 30; i++)
+    EXPECT_EQ(storage_.read(i), i);
+}
+
+TEST_F(LogStructuredStorage, CorruptedRecordsAreIgnored) {
+  storage_.update(0, 1);
+  storage_.commit();
+  storage_.update(0, 2);
+  storage_.commit();
+
+  // Flip a bit in the data of the last record, the one that wrote 2: the first
+  // bank starts with the header, followed by the two records.
+  storage_.flash().data()[2 * 8 + 2] ^= 0x01;
+
+  reload();
+  EXPECT_EQ(storage_.read(0), 1);
+
+  // Later records still get appended after the corrupted one.
+  storage_.update(0, 3);
+  storage_.commit();
+  reload();
+  EXPECT_EQ(storage_.read(0), 3);
+}
+
+TEST_F(LogStructuredStorage, PowerLossDuringCompactionKeepsTheOldData) {
+  for (uint8_t i = 0; i < 8; i++)
+    storage_.update(i * 4, i + 1);
+  storage_.commit();
+
+  // Fill the log up, so that the next commit compacts it.
+  for (uint8_t i = 0; i < 7; i++) {
+    storage_.update(0, 0x10 + i);
+    storage_.commit();
+  }
+
+  // Lose power after erasing the new bank, and writing some of the snapshot.
+  storage_.update(0, 0x20);
+  storage_.update(4, 0x20);
+  storage_.flash().cutPowerAfter(4);
+  storage_.commit();
+  storage_.flash().restorePower();
+
+  reload();
+  EXPECT_EQ(storage_.read(0), 0x16);
+  for (uint8_t i = 1; i < 8; i++)
+    EXPECT_EQ(storage_.read(i * 4), i + 1);
+
+  // The next commit completes the compaction.
+  storage_.update(0, 0x20);
+  storage_.commit();
+  reload();
+  EXPECT_EQ(storage_.read(0), 0x20);
+  for (uint8_t i = 1; i < 8; i++)
+    EXPECT_EQ(storage_.read(i * 4), i + 1);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,130 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kaleidoscope/driver/keyscanner/ScanRate.h"    // for ScanRateSettings
+#include "kaleidoscope/driver/keyscanner/ScanWakeup.h"  // for ScanWakeup
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using driver::keyscanner::ScanRateSettings;
+using driver::keyscanner::ScanWakeup;
+
+constexpr KeyAddr key_a{0, 0};
+
+TEST(ScanWakeup, TriggerOnlyWhenArmed) {
+  ScanWakeup wakeup;
+  EXPECT_FALSE(wakeup.trigger());
+  EXPECT_FALSE(wakeup.resume());
+
+  wakeup.arm();
+  EXPECT_TRUE(wakeup.isArmed());
+  EXPECT_FALSE(wakeup.resume());
+
+  EXPECT_TRUE(wakeup.trigger());
+  EXPECT_FALSE(wakeup.isArmed());
+  // Further interrupts before the keyscanner gets around to it don't matter.
+  EXPECT_FALSE(wakeup.trigger());
+
+  EXPECT_TRUE(wakeup.resume());
+  EXPECT_FALSE(wakeup.resume());
+}
+
+TEST(ScanWakeup, Disarm) {
+  ScanWakeup wakeup;
+  wakeup.arm();
+  wakeup.disarm();
+  EXPECT_FALSE(wakeup.isArmed());
+  EXPECT_FALSE(wakeup.trigger());
+  EXPECT_FALSE(wakeup.resume());
+}
+
+class ScanWakeupTest : public VirtualDeviceTest {
+ protected:
+  void SetUp() {
+    VirtualDeviceTest::SetUp();
+    keyScanner().setWakeupEnabled(true);
+    Runtime.device().setScanRate(ScanRateSettings{1000, 8000, 50});
+  }
+  void TearDown() {
+    keyScanner().setWakeupEnabled(false);
+  }
+
+  Device::KeyScanner &keyScanner() {
+    return Runtime.device().keyScanner();
+  }
+};
+
+TEST_F(ScanWakeupTest, SuspendsWhenIdle) {
+  sim_.RunForMillis(45);
+  EXPECT_FALSE(keyScanner().isScanSuspended());
+  sim_.RunForMillis(10);
+  EXPECT_TRUE(keyScanner().isScanSuspended());
+
+  // Nothing wakes it up but a keyswitch closing.
+  sim_.RunForMillis(500);
+  EXPECT_TRUE(keyScanner().isScanSuspended());
+}
+
+TEST_F(ScanWakeupTest, WakesUpOnPress) {
+  sim_.RunForMillis(60);
+  ASSERT_TRUE(keyScanner().isScanSuspended());
+
+  // The press that wakes the keyscanner up is not lost.
+  sim_.Press(key_a);
+  auto state = RunCycle();
+  EXPECT_FALSE(keyScanner().isScanSuspended());
+  EXPECT_EQ(Runtime.device().scanInterval(), 1000);
+  ASSERT_EQ(state->HIDReports()->Keyboard().size(), 1);
+  EXPECT_THAT(state->HIDReports()->Keyboard(0).ActiveKeycodes(),
+              ::testing::ElementsAre(Key_A.getKeyCode()));
+
+  // Holding the key keeps it awake.
+  sim_.RunForMillis(100);
+  EXPECT_FALSE(keyScanner().isScanSuspended());
+
+  sim_.Release(key_a);
+  state = RunCycle();
+  ASSERT_EQ(state->HIDReports()->Keyboard().size(), 1);
+  EXPECT_THAT(state->HIDReports()->Keyboard(0).ActiveKeycodes(),
+              ::testing::IsEmpty());
+
+  sim_.RunForMillis(60);
+  EXPECT_TRUE(keyScanner().isScanSuspended());
+}
+
+TEST_F(ScanWakeupTest, NeedsIdleScanning) {
+  Runtime.device().setScanRate(ScanRateSettings{1000, 0, 50});
+  sim_.RunForMillis(100);
+  EXPECT_FALSE(keyScanner().isScanSuspended());
+}
+
+TEST_F(ScanWakeupTest, ChangingScanRateWakesUp) {
+  sim_.RunForMillis(60);
+  ASSERT_TRUE(keyScanner().isScanSuspended());
+  Runtime.device().setScanRate(ScanRateSettings{1000, 8000, 50});
+  EXPECT_FALSE(keyScanner().isScanSuspended());
+  sim_.RunForMillis(45);
+  EXPECT_FALSE(keyScanner().isScanSuspended());
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,50 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdint.h>  // for uint8_t, uint32_t
+
+#include "kaleidoscope/Timer.h"  // for Timer
+
+namespace kaleidoscope {
+namespace testing {
+
+// Records the order in which the test timers expire, and when.
+struct TimerLog {
+  static constexpr uint8_t capacity = 16;
+
+  char ids[capacity];
+  uint32_t times[capacity];
+  uint8_t length;
+
+  void clear() {
+    length = 0;
+  }
+};
+
+extern TimerLog timer_log;
+
+extern Timer timer_a;
+extern Timer timer_b;
+extern Timer timer_c;
+
+// When non-zero, `timer_a` restarts itself with this interval when it expires.
+extern uint16_t timer_a_interval;
+
+}  // namespace testing
+}  // namespace kaleidoscope
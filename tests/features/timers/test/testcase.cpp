@@ -0,0 +1,152 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "testing/setup-googletest.h"
+
+#include "../common.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+class Timers : public VirtualDeviceTest {
+ protected:
+  void SetUp() {
+    VirtualDeviceTest::SetUp();
+    Runtime.stopTimer(timer_a);
+    Runtime.stopTimer(timer_b);
+    Runtime.stopTimer(timer_c);
+    Runtime.setIdleSleepInterval(0);
+    timer_a_interval = 0;
+    timer_log.clear();
+  }
+
+  uint32_t Now() {
+    return Runtime.millisAtCycleStart();
+  }
+};
+
+TEST_F(Timers, ExpireInDeadlineOrder) {
+  sim_.RunCycle();
+  uint32_t start = Now();
+  Runtime.startTimer(timer_a, 30);
+  Runtime.startTimer(timer_b, 10);
+  Runtime.startTimer(timer_c, 10);
+  EXPECT_TRUE(timer_a.isPending());
+
+  sim_.RunForMillis(50);
+
+  ASSERT_EQ(timer_log.length, 3);
+  EXPECT_EQ(timer_log.ids[0], 'b');
+  EXPECT_EQ(timer_log.ids[1], 'c');
+  EXPECT_EQ(timer_log.ids[2], 'a');
+  // Same semantics as `Runtime.hasTimeExpired(start, timeout)`: the callback
+  // gets called in the first cycle that starts `timeout` ms after `start`.
+  EXPECT_EQ(timer_log.times[0] - start, 10u);
+  EXPECT_EQ(timer_log.times[1] - start, 10u);
+  EXPECT_EQ(timer_log.times[2] - start, 30u);
+  EXPECT_FALSE(timer_a.isPending());
+}
+
+TEST_F(Timers, StartTimeInThePast) {
+  sim_.RunForMillis(20);
+  uint16_t start = Now() - 15;
+  Runtime.startTimer(timer_a, start, uint16_t(20));
+
+  sim_.RunForMillis(10);
+
+  ASSERT_EQ(timer_log.length, 1);
+  EXPECT_EQ(uint16_t(timer_log.times[0] - start), 20);
+}
+
+TEST_F(Timers, StopAndRestart) {
+  sim_.RunCycle();
+  uint32_t start = Now();
+  Runtime.startTimer(timer_a, 10);
+  Runtime.startTimer(timer_b, 10);
+  Runtime.stopTimer(timer_a);
+  EXPECT_FALSE(timer_a.isPending());
+
+  sim_.RunForMillis(5);
+  // Restarting a pending timer replaces its deadline.
+  Runtime.startTimer(timer_b, 10);
+
+  sim_.RunForMillis(30);
+
+  ASSERT_EQ(timer_log.length, 1);
+  EXPECT_EQ(timer_log.ids[0], 'b');
+  EXPECT_EQ(timer_log.times[0] - start, 15u);
+}
+
+TEST_F(Timers, PeriodicTimer) {
+  sim_.RunCycle();
+  uint32_t start   = Now();
+  timer_a_interval = 4;
+  Runtime.startTimer(timer_a, timer_a_interval);
+
+  sim_.RunForMillis(20);
+  // The timer has already been restarted, so it will expire once more.
+  timer_a_interval = 0;
+  sim_.RunForMillis(20);
+
+  ASSERT_EQ(timer_log.length, 6);
+  for (uint8_t i = 0; i < timer_log.length; ++i) {
+    EXPECT_EQ(timer_log.ids[i], 'a');
+    EXPECT_EQ(timer_log.times[i] - start, 4u * (i + 1));
+  }
+}
+
+TEST_F(Timers, IdleSleepUntilNextDeadline) {
+  sim_.RunCycle();
+  uint32_t start = Now();
+  Runtime.startTimer(timer_a, 40);
+  Runtime.setIdleSleepInterval(100);
+
+  // With nothing else to do, the keyboard sleeps until the timer's deadline at
+  // the end of the next cycle.
+  sim_.RunCycles(2);
+  EXPECT_EQ(Now() - start, 40u);
+  ASSERT_EQ(timer_log.length, 1);
+  EXPECT_EQ(timer_log.times[0] - start, 40u);
+
+  // With no timers pending, it sleeps for the full interval.
+  start = Now();
+  sim_.RunCycle();
+  EXPECT_EQ(Now() - start, 100u);
+
+  // But not while a key is held.
+  sim_.Press(0, 1);
+  sim_.RunCycle();
+  start = Now();
+  sim_.RunCycle();
+  EXPECT_EQ(Now() - start, 1u);
+  sim_.Release(0, 1);
+  sim_.RunCycle();
+
+  // Or when idle sleep is disabled.
+  Runtime.setIdleSleepInterval(0);
+  sim_.RunCycle();
+  start = Now();
+  sim_.RunCycle();
+  EXPECT_EQ(Now() - start, 1u);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,84 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <Kaleidoscope.h>
+
+#include "./common.h"
+
+// *INDENT-OFF*
+KEYMAPS(
+    [0] = KEYMAP_STACKED
+    (
+        Key_NoKey, Key_1, Key_2, Key_3, Key_4, Key_5, Key_NoKey,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___,
+
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___
+    ),
+)
+// *INDENT-ON*
+
+namespace kaleidoscope {
+namespace testing {
+
+TimerLog timer_log;
+uint16_t timer_a_interval = 0;
+
+static void record(char id) {
+  if (timer_log.length < TimerLog::capacity) {
+    timer_log.ids[timer_log.length]   = id;
+    timer_log.times[timer_log.length] = Runtime.millisAtCycleStart();
+    ++timer_log.length;
+  }
+}
+
+static void onTimerA() {
+  record('a');
+  if (timer_a_interval != 0)
+    Runtime.startTimer(timer_a, timer_a_interval);
+}
+
+static void onTimerB() {
+  record('b');
+}
+
+static void onTimerC() {
+  record('c');
+}
+
+Timer timer_a{onTimerA};
+Timer timer_b{onTimerB};
+Timer timer_c{onTimerC};
+
+}  // namespace testing
+}  // namespace kaleidoscope
+
+void setup() {
+  Kaleidoscope.setup();
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
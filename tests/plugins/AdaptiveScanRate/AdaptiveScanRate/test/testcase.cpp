@@ -0,0 +1,136 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Kaleidoscope-AdaptiveScanRate.h>
+
+#include "kaleidoscope/driver/keyscanner/ScanRate.h"  // for ScanRate, ScanRateSettings
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using driver::keyscanner::ScanRate;
+using driver::keyscanner::ScanRateSettings;
+
+constexpr KeyAddr key_a{0, 0};
+
+TEST(ScanRate, StaysActiveWithoutIdleInterval) {
+  ScanRate scan_rate;
+  scan_rate.setSettings(ScanRateSettings{1500, 0, 10}, 0);
+  EXPECT_FALSE(scan_rate.update(false, 1000));
+  EXPECT_FALSE(scan_rate.isIdle());
+  EXPECT_EQ(scan_rate.interval(), 1500);
+}
+
+TEST(ScanRate, SwitchesAfterTimeout) {
+  ScanRate scan_rate;
+  scan_rate.setSettings(ScanRateSettings{1500, 20000, 100}, 0);
+  EXPECT_FALSE(scan_rate.update(true, 10));
+  EXPECT_FALSE(scan_rate.update(false, 109));
+  EXPECT_EQ(scan_rate.interval(), 1500);
+
+  EXPECT_TRUE(scan_rate.update(false, 110));
+  EXPECT_TRUE(scan_rate.isIdle());
+  EXPECT_EQ(scan_rate.interval(), 20000);
+  EXPECT_FALSE(scan_rate.update(false, 500));
+
+  // The first activity switches back right away.
+  EXPECT_TRUE(scan_rate.update(true, 501));
+  EXPECT_FALSE(scan_rate.isIdle());
+  EXPECT_EQ(scan_rate.interval(), 1500);
+}
+
+TEST(ScanRate, HandlesTimerWraparound) {
+  ScanRate scan_rate;
+  scan_rate.setSettings(ScanRateSettings{1500, 20000, 100}, 0xffffffc0);
+  EXPECT_FALSE(scan_rate.update(false, 0x10));
+  EXPECT_TRUE(scan_rate.update(false, 0x24));
+}
+
+class AdaptiveScanRateTest : public VirtualDeviceTest {
+ protected:
+  void SetUp() {
+    VirtualDeviceTest::SetUp();
+    ASSERT_TRUE(::AdaptiveScanRate.setSettings(ScanRateSettings{1000, 8000, 50}));
+  }
+
+  uint16_t scanInterval() {
+    return Runtime.device().scanInterval();
+  }
+};
+
+TEST_F(AdaptiveScanRateTest, Settings) {
+  ScanRateSettings settings = ::AdaptiveScanRate.settings();
+  EXPECT_EQ(settings.interval, 1000);
+  EXPECT_EQ(settings.idle_interval, 8000);
+  EXPECT_EQ(settings.idle_timeout, 50);
+}
+
+TEST_F(AdaptiveScanRateTest, RejectsZeroInterval) {
+  EXPECT_FALSE(::AdaptiveScanRate.setSettings(ScanRateSettings{0, 8000, 50}));
+  EXPECT_EQ(::AdaptiveScanRate.settings().interval, 1000);
+  EXPECT_EQ(scanInterval(), 1000);
+}
+
+TEST_F(AdaptiveScanRateTest, RejectsIdleIntervalShorterThanInterval) {
+  EXPECT_FALSE(::AdaptiveScanRate.setSettings(ScanRateSettings{1000, 500, 50}));
+  EXPECT_EQ(::AdaptiveScanRate.settings().idle_interval, 8000);
+
+  EXPECT_FALSE(::AdaptiveScanRate.setSettings(ScanRateSettings{9000, 8000, 50}));
+  EXPECT_EQ(::AdaptiveScanRate.settings().interval, 1000);
+
+  EXPECT_TRUE(::AdaptiveScanRate.setSettings(ScanRateSettings{8000, 8000, 50}));
+}
+
+TEST_F(AdaptiveScanRateTest, IdleAfterTimeout) {
+  sim_.RunForMillis(45);
+  EXPECT_EQ(scanInterval(), 1000);
+  sim_.RunForMillis(10);
+  EXPECT_EQ(scanInterval(), 8000);
+}
+
+TEST_F(AdaptiveScanRateTest, ActiveOnFirstPress) {
+  sim_.RunForMillis(60);
+  ASSERT_EQ(scanInterval(), 8000);
+
+  sim_.Press(key_a);
+  sim_.RunCycle();
+  EXPECT_EQ(scanInterval(), 1000);
+
+  // Holding a key keeps the scan rate up.
+  sim_.RunForMillis(100);
+  EXPECT_EQ(scanInterval(), 1000);
+
+  // The timeout starts when the last key is released.
+  sim_.Release(key_a);
+  sim_.RunForMillis(45);
+  EXPECT_EQ(scanInterval(), 1000);
+  sim_.RunForMillis(10);
+  EXPECT_EQ(scanInterval(), 8000);
+}
+
+TEST_F(AdaptiveScanRateTest, DisabledIdleScanning) {
+  EXPECT_TRUE(::AdaptiveScanRate.setSettings(ScanRateSettings{1000, 0, 50}));
+  sim_.RunForMillis(100);
+  EXPECT_EQ(scanInterval(), 1000);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
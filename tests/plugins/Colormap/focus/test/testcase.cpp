@@ -0,0 +1,158 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <string>  // for string, to_string
+
+#include "kaleidoscope/plugin/Colormap.h"     // for ColormapEffect
+#include "kaleidoscope/plugin/FocusSerial.h"  // for Focus
+#include "testing/ScriptedStream.h"           // for ScriptedStream
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+// The sketch sets up two colormap layers.
+constexpr uint8_t layers = 2;
+
+constexpr char terminator[] = "\r\n.\r\n";
+
+class ColormapFocus : public VirtualDeviceTest {
+ protected:
+  ScriptedStream stream_;
+
+  void SetUp() {
+    VirtualDeviceTest::SetUp();
+    ::Focus.setSerialPort(stream_);
+    for (uint8_t layer = 0; layer < layers; layer++) {
+      for (uint16_t pos = 0; pos < Runtime.device().led_count; pos++)
+        ::ColormapEffect.updateColorIndexAtPosition(layer, pos, 0);
+    }
+  }
+
+  // Sends a request, and returns the response.
+  std::string request(const std::string &input) {
+    stream_.addInput(input + "\n");
+    for (int i = 0; i < 100 && stream_.available(); i++)
+      sim_.RunCycle();
+    EXPECT_EQ(stream_.available(), 0);
+    return stream_.takeOutput();
+  }
+
+  // The palette indexes from a position on, read with `colormap.map.range`.
+  std::string range(uint8_t layer, uint8_t index, uint8_t count) {
+    return request("colormap.map.range " + std::to_string(layer) + " " +
+                   std::to_string(index) + " " + std::to_string(count));
+  }
+
+  static std::string last() {
+    return std::to_string(Runtime.device().led_count - 1);
+  }
+};
+
+TEST_F(ColormapFocus, SetWritesTheIndexesFromThePosition) {
+  EXPECT_EQ(request("colormap.map.set 1 3 5 6 7"), terminator);
+
+  EXPECT_EQ(range(1, 2, 5), std::string("0 5 6 7 0 ") + terminator);
+  EXPECT_EQ(range(0, 3, 1), std::string("0 ") + terminator);
+}
+
+TEST_F(ColormapFocus, SetContinuesOnTheNextLayer) {
+  EXPECT_EQ(request("colormap.map.set 0 " + last() + " 5 6"), terminator);
+
+  EXPECT_EQ(range(0, Runtime.device().led_count - 1, 2), std::string("5 6 ") + terminator);
+}
+
+TEST_F(ColormapFocus, SetIgnoresIndexesPastTheLastLayer) {
+  EXPECT_EQ(request("colormap.map.set 1 " + last() + " 5 6"), terminator);
+
+  EXPECT_EQ(range(1, Runtime.device().led_count - 1, 2), std::string("5 ") + terminator);
+  EXPECT_EQ(range(0, 0, 1), std::string("0 ") + terminator);
+}
+
+TEST_F(ColormapFocus, SetIgnoresAnInvalidLayer) {
+  EXPECT_EQ(request("colormap.map.set 2 0 5"), terminator);
+  EXPECT_EQ(request("colormap.map.set 65535 0 5"), terminator);
+
+  EXPECT_EQ(range(0, 0, 1), std::string("0 ") + terminator);
+  EXPECT_EQ(range(1, 0, 1), std::string("0 ") + terminator);
+}
+
+TEST_F(ColormapFocus, SetIgnoresAnInvalidIndex) {
+  std::string index = std::to_string(Runtime.device().led_count);
+  EXPECT_EQ(request("colormap.map.set 0 " + index + " 5"), terminator);
+
+  // The index doesn't carry over to the next layer.
+  EXPECT_EQ(range(1, 0, 1), std::string("0 ") + terminator);
+}
+
+TEST_F(ColormapFocus, SetWithoutIndexesWritesNothing) {
+  EXPECT_EQ(request("colormap.map.set 1 3"), terminator);
+  EXPECT_EQ(request("colormap.map.set 1"), terminator);
+  EXPECT_EQ(request("colormap.map.set"), terminator);
+
+  EXPECT_EQ(range(1, 3, 1), std::string("0 ") + terminator);
+  EXPECT_EQ(range(1, 0, 1), std::string("0 ") + terminator);
+  EXPECT_EQ(range(0, 0, 1), std::string("0 ") + terminator);
+}
+
+TEST_F(ColormapFocus, RangeStopsAtTheLastLayer) {
+  ::ColormapEffect.updateColorIndexAtPosition(1, Runtime.device().led_count - 1, 9);
+
+  EXPECT_EQ(request("colormap.map.range 1 " + last() + " 10"), std::string("9 ") + terminator);
+}
+
+TEST_F(ColormapFocus, RangeSendsNothingOutOfRange) {
+  std::string index = std::to_string(Runtime.device().led_count);
+  EXPECT_EQ(request("colormap.map.range 2 0 1"), terminator);
+  EXPECT_EQ(request("colormap.map.range 0 " + index + " 1"), terminator);
+}
+
+TEST_F(ColormapFocus, RangeWithoutACountSendsNothing) {
+  EXPECT_EQ(request("colormap.map.range 1 3"), terminator);
+  EXPECT_EQ(request("colormap.map.range 1"), terminator);
+  EXPECT_EQ(request("colormap.map.range"), terminator);
+}
+
+TEST_F(ColormapFocus, HelpListsTheVariants) {
+  std::string help = request("help");
+
+  EXPECT_NE(help.find("colormap.map\r\n"), std::string::npos);
+  EXPECT_NE(help.find("colormap.map.binary\r\n"), std::string::npos);
+  EXPECT_NE(help.find("colormap.map.set\r\n"), std::string::npos);
+  EXPECT_NE(help.find("colormap.map.range\r\n"), std::string::npos);
+  EXPECT_NE(help.find("palette\r\n"), std::string::npos);
+  // Each command is listed once, from its table.
+  EXPECT_EQ(help.find("colormap.map\r\n"), help.rfind("colormap.map\r\n"));
+}
+
+TEST_F(ColormapFocus, MapSendsAndWritesTheIndexes) {
+  EXPECT_EQ(request("colormap.map 0 1 2 3"), terminator);
+  EXPECT_EQ(request("colormap.map").substr(0, 8), "0 1 2 3 ");
+  EXPECT_EQ(range(0, 0, 4), std::string("0 1 2 3 ") + terminator);
+}
+
+TEST_F(ColormapFocus, PaletteSendsAndWritesTheColors) {
+  EXPECT_EQ(request("palette 1 2 3 4 5 6"), terminator);
+  EXPECT_EQ(request("palette").substr(0, 12), "1 2 3 4 5 6 ");
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
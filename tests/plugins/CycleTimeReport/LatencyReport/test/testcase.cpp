@@ -0,0 +1,127 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <Kaleidoscope-CycleTimeReport.h>
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using plugin::LatencyHistogram;
+
+constexpr KeyAddr key_a{0, 0};
+constexpr KeyAddr key_spacecadet{0, 1};
+constexpr KeyAddr key_volume_up{0, 2};
+constexpr KeyAddr key_mouse_button{0, 3};
+
+class LatencyReportTest : public VirtualDeviceTest {
+ protected:
+  void SetUp() {
+    VirtualDeviceTest::SetUp();
+    ::LatencyReport.reset();
+  }
+
+  const LatencyHistogram &Histogram(plugin::LatencyReport::ReportType type) {
+    return ::LatencyReport.histogram(type);
+  }
+};
+
+TEST_F(LatencyReportTest, KeyboardReportsInTheSameCycle) {
+  sim_.Press(key_a);
+  sim_.RunCycle();
+  sim_.Release(key_a);
+  sim_.RunCycle();
+
+  const LatencyHistogram &keyboard = Histogram(plugin::LatencyReport::KEYBOARD);
+  EXPECT_EQ(keyboard.count(), 2u);
+  EXPECT_EQ(keyboard.max(), 0u);
+  EXPECT_EQ(keyboard.bucket(0), 2);
+  EXPECT_EQ(Histogram(plugin::LatencyReport::CONSUMER_CONTROL).count(), 0u);
+  EXPECT_EQ(Histogram(plugin::LatencyReport::MOUSE).count(), 0u);
+}
+
+TEST_F(LatencyReportTest, ReportTypesAreSeparate) {
+  sim_.Press(key_volume_up);
+  sim_.RunCycle();
+  sim_.Release(key_volume_up);
+  sim_.RunCycle();
+  sim_.Press(key_mouse_button);
+  sim_.RunCycle();
+  sim_.Release(key_mouse_button);
+  sim_.RunCycle();
+
+  EXPECT_EQ(Histogram(plugin::LatencyReport::KEYBOARD).count(), 0u);
+  EXPECT_EQ(Histogram(plugin::LatencyReport::CONSUMER_CONTROL).count(), 2u);
+  EXPECT_EQ(Histogram(plugin::LatencyReport::MOUSE).count(), 1u);
+}
+
+// SpaceCadet holds back the press of a key until it knows whether it was a tap
+// or not, which shows up as latency.
+TEST_F(LatencyReportTest, DelayedByPlugin) {
+  sim_.Press(key_spacecadet);
+  sim_.RunForMillis(5);
+  sim_.Release(key_spacecadet);
+  sim_.RunCycle();
+
+  const LatencyHistogram &keyboard = Histogram(plugin::LatencyReport::KEYBOARD);
+  ASSERT_EQ(keyboard.count(), 1u);
+  EXPECT_EQ(keyboard.max(), 5000u);
+  EXPECT_EQ(keyboard.bucket(LatencyHistogram::bucketIndex(5000)), 1);
+
+  sim_.Press(key_spacecadet);
+  sim_.RunForMillis(20);
+  sim_.Release(key_spacecadet);
+  sim_.RunCycle();
+
+  // The timeout is 10ms, so the key takes at most that long to get reported.
+  ASSERT_EQ(keyboard.count(), 3u);
+  EXPECT_LE(keyboard.max(), 10000u);
+  EXPECT_EQ(keyboard.min(), 0u);
+  EXPECT_LE(keyboard.percentile(99), 10000u);
+}
+
+TEST_F(LatencyReportTest, Histogram) {
+  EXPECT_EQ(LatencyHistogram::bucketIndex(0), 0);
+  EXPECT_EQ(LatencyHistogram::bucketIndex(1), 1);
+  EXPECT_EQ(LatencyHistogram::bucketIndex(2), 2);
+  EXPECT_EQ(LatencyHistogram::bucketIndex(3), 2);
+  EXPECT_EQ(LatencyHistogram::bucketIndex(1000), 10);
+  EXPECT_EQ(LatencyHistogram::bucketIndex(0xffffffff),
+            LatencyHistogram::bucket_count - 1);
+
+  LatencyHistogram histogram;
+  for (int i = 0; i < 99; ++i)
+    histogram.record(100);
+  EXPECT_EQ(histogram.percentile(99), 100u);
+  histogram.record(3000);
+  // The percentile is only as precise as the bucket it falls into.
+  EXPECT_EQ(histogram.percentile(99), 127u);
+  EXPECT_EQ(histogram.percentile(100), 3000u);
+  histogram.record(3000);
+  EXPECT_EQ(histogram.count(), 101u);
+  EXPECT_EQ(histogram.min(), 100u);
+  // The bucket for 3000 goes up to 4095, but no sample was that long.
+  EXPECT_EQ(histogram.percentile(99), 3000u);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
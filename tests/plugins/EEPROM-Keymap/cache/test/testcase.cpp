@@ -0,0 +1,132 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <string>  // for string
+
+#include "kaleidoscope/plugin/EEPROM-Keymap.h"      // for EEPROMKeymap
+#include "kaleidoscope/plugin/FocusSerial.h"        // for Focus
+#include "kaleidoscope/plugin/focusserial/Frame.h"  // for Frame
+#include "testing/ScriptedStream.h"                 // for ScriptedStream
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+constexpr KeyAddr key_addr{0, 0};
+
+// The first EEPROM layer comes after the one in the sketch's keymap.
+constexpr uint8_t eeprom_layer = 1;
+
+class EEPROMKeymapCache : public VirtualDeviceTest {
+ protected:
+  ScriptedStream stream_;
+
+  void SetUp() {
+    VirtualDeviceTest::SetUp();
+    ::Focus.setSerialPort(stream_);
+    ::EEPROMKeymap.updateKey(key_addr.toInt(), Key_B);
+    Layer.move(eeprom_layer);
+  }
+
+  void TearDown() {
+    Layer.move(0);
+  }
+
+  // Writes a key straight to storage, bypassing the plugin.
+  void writeToStorage(Key key) {
+    uint16_t pos = ::EEPROMKeymap.keymap_base() + key_addr.toInt() * 2;
+    Runtime.storage().update(pos, key.getFlags());
+    Runtime.storage().update(pos + 1, key.getKeyCode());
+  }
+
+  // Writes a key to storage with `eeprom.contents.binary`.
+  void writeWithFocus(Key key) {
+    plugin::focusserial::Frame frame;
+    frame.length     = 2;
+    frame.sequence   = 0;
+    frame.payload[0] = key.getFlags();
+    frame.payload[1] = key.getKeyCode();
+    uint16_t crc     = frame.crc();
+
+    uint16_t pos = ::EEPROMKeymap.keymap_base() + key_addr.toInt() * 2;
+    stream_.addInput("eeprom.contents.binary " + std::to_string(pos) + " 2\n");
+    stream_.addInput(std::string{char(frame.length), char(frame.sequence),
+                                 char(frame.payload[0]), char(frame.payload[1]),
+                                 char(crc & 0xff), char(crc >> 8)});
+    // The transfer runs over as many cycles as it takes, and the response
+    // ends once it's over.
+    std::string output;
+    for (int i = 0; i < 100 && output.find("\r\n.\r\n") == std::string::npos; i++) {
+      sim_.RunCycle();
+      output += stream_.takeOutput();
+    }
+    EXPECT_EQ(stream_.available(), 0);
+  }
+};
+
+TEST_F(EEPROMKeymapCache, LooksUpKeysFromStorage) {
+  EXPECT_EQ(Layer.lookupActiveLayer(key_addr), eeprom_layer);
+  EXPECT_EQ(Layer.lookupOnActiveLayer(key_addr), Key_B);
+}
+
+TEST_F(EEPROMKeymapCache, RepeatedLookupsAreServedFromTheCache) {
+  EXPECT_EQ(Layer.lookupOnActiveLayer(key_addr), Key_B);
+
+  writeToStorage(Key_C);
+  EXPECT_EQ(Layer.lookupOnActiveLayer(key_addr), Key_B);
+}
+
+TEST_F(EEPROMKeymapCache, UpdatingAKeyUpdatesTheCache) {
+  EXPECT_EQ(Layer.lookupOnActiveLayer(key_addr), Key_B);
+
+  ::EEPROMKeymap.updateKey(key_addr.toInt(), Key_C);
+  EXPECT_EQ(Layer.lookupOnActiveLayer(key_addr), Key_C);
+}
+
+TEST_F(EEPROMKeymapCache, LookupsOnOtherLayersReplaceTheCachedKey) {
+  EXPECT_EQ(Layer.lookupOnActiveLayer(key_addr), Key_B);
+  writeToStorage(Key_C);
+
+  ::EEPROMKeymap.updateKey(Runtime.device().numKeys() + key_addr.toInt(), Key_D);
+  EXPECT_EQ(::EEPROMKeymap.getKey(1, key_addr), Key_D);
+  EXPECT_EQ(Layer.lookupOnActiveLayer(key_addr), Key_C);
+}
+
+TEST_F(EEPROMKeymapCache, WritingStorageWithFocusUpdatesTheCache) {
+  EXPECT_EQ(Layer.lookupOnActiveLayer(key_addr), Key_B);
+
+  writeWithFocus(Key_C);
+  EXPECT_EQ(Layer.lookupOnActiveLayer(key_addr), Key_C);
+}
+
+TEST_F(EEPROMKeymapCache, WritingStorageWithFocusUpdatesTheActiveLayers) {
+  Layer.activate(0);
+  Layer.activate(eeprom_layer);
+  EXPECT_EQ(Layer.lookupActiveLayer(key_addr), eeprom_layer);
+
+  // The key becomes transparent, so the one on the layer below shows.
+  writeWithFocus(Key_Transparent);
+  EXPECT_EQ(Layer.lookupActiveLayer(key_addr), 0);
+  EXPECT_EQ(Layer.lookupOnActiveLayer(key_addr), Key_A);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
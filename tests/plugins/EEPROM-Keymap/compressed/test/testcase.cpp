@@ -0,0 +1,258 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <initializer_list>  // for initializer_list
+#include <string>            // for string, to_string
+#include <utility>           // for pair
+
+#include "kaleidoscope/plugin/EEPROM-Keymap.h"  // for EEPROMKeymap
+#include "kaleidoscope/plugin/FocusSerial.h"    // for Focus
+#include "testing/ScriptedStream.h"             // for ScriptedStream
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+// The sketch sets up four layers, with room for eight non-transparent keys.
+constexpr uint8_t layers   = 4;
+constexpr uint8_t max_keys = 8;
+
+class EEPROMKeymapCompressed : public VirtualDeviceTest {
+ protected:
+  ScriptedStream stream_;
+
+  void SetUp() {
+    VirtualDeviceTest::SetUp();
+    ::Focus.setSerialPort(stream_);
+    for (uint16_t pos = 0; pos < layers * Runtime.device().numKeys(); pos++)
+      ::EEPROMKeymap.updateKey(pos, Key_Transparent);
+  }
+
+  void TearDown() {
+    Layer.move(0);
+  }
+
+  void updateKey(uint8_t layer, KeyAddr key_addr, Key key) {
+    ::EEPROMKeymap.updateKey(layer * Runtime.device().numKeys() + key_addr.toInt(), key);
+  }
+
+  // Sends the given keys with `keymap.custom`, starting from the first key of
+  // the first layer, with the rest of the ones in `count` transparent.
+  void upload(uint16_t count, std::initializer_list<std::pair<uint16_t, Key>> keys) {
+    std::string request = "keymap.custom";
+    for (uint16_t pos = 0; pos < count; pos++) {
+      Key key = Key_Transparent;
+      for (auto &k : keys) {
+        if (k.first == pos)
+          key = k.second;
+      }
+      request += " " + std::to_string(key.getRaw());
+    }
+    stream_.addInput(request + "\n");
+    for (int i = 0; i < 1000 && stream_.available(); i++)
+      sim_.RunCycle();
+    EXPECT_EQ(stream_.available(), 0);
+    stream_.takeOutput();
+  }
+
+  uint16_t pos(uint8_t layer, KeyAddr key_addr) {
+    return layer * Runtime.device().numKeys() + key_addr.toInt();
+  }
+};
+
+TEST_F(EEPROMKeymapCompressed, KeysAreTransparentUntilSet) {
+  for (uint8_t layer = 0; layer < layers; layer++) {
+    for (auto key_addr : KeyAddr::all())
+      EXPECT_EQ(::EEPROMKeymap.getKey(layer, key_addr), Key_Transparent);
+  }
+}
+
+TEST_F(EEPROMKeymapCompressed, KeysAreStoredOnTheirLayer) {
+  updateKey(2, KeyAddr{1, 3}, Key_C);
+  updateKey(0, KeyAddr{3, 0}, Key_A);
+  updateKey(2, KeyAddr{0, 5}, Key_B);
+  updateKey(3, KeyAddr{0, 0}, Key_D);
+
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{3, 0}), Key_A);
+  EXPECT_EQ(::EEPROMKeymap.getKey(2, KeyAddr{0, 5}), Key_B);
+  EXPECT_EQ(::EEPROMKeymap.getKey(2, KeyAddr{1, 3}), Key_C);
+  EXPECT_EQ(::EEPROMKeymap.getKey(3, KeyAddr{0, 0}), Key_D);
+  EXPECT_EQ(::EEPROMKeymap.getKey(1, KeyAddr{3, 0}), Key_Transparent);
+  EXPECT_EQ(::EEPROMKeymap.getKey(2, KeyAddr{0, 0}), Key_Transparent);
+}
+
+TEST_F(EEPROMKeymapCompressed, ClearingAKeyKeepsTheOthers) {
+  updateKey(1, KeyAddr{0, 1}, Key_A);
+  updateKey(1, KeyAddr{0, 2}, Key_B);
+  updateKey(2, KeyAddr{0, 1}, Key_C);
+
+  updateKey(1, KeyAddr{0, 1}, Key_Transparent);
+  EXPECT_EQ(::EEPROMKeymap.getKey(1, KeyAddr{0, 1}), Key_Transparent);
+  EXPECT_EQ(::EEPROMKeymap.getKey(1, KeyAddr{0, 2}), Key_B);
+  EXPECT_EQ(::EEPROMKeymap.getKey(2, KeyAddr{0, 1}), Key_C);
+
+  updateKey(1, KeyAddr{0, 2}, Key_D);
+  EXPECT_EQ(::EEPROMKeymap.getKey(1, KeyAddr{0, 2}), Key_D);
+  EXPECT_EQ(::EEPROMKeymap.getKey(2, KeyAddr{0, 1}), Key_C);
+}
+
+TEST_F(EEPROMKeymapCompressed, KeysBeyondTheCapacityAreIgnored) {
+  for (uint8_t i = 0; i < max_keys; i++)
+    updateKey(0, KeyAddr{i}, Key_A);
+  updateKey(1, KeyAddr{0, 0}, Key_B);
+  EXPECT_EQ(::EEPROMKeymap.getKey(1, KeyAddr{0, 0}), Key_Transparent);
+
+  // Changing a stored key needs no more room, and clearing one makes room.
+  updateKey(0, KeyAddr{uint8_t(0)}, Key_C);
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{uint8_t(0)}), Key_C);
+  updateKey(0, KeyAddr{uint8_t(1)}, Key_Transparent);
+  updateKey(1, KeyAddr{0, 0}, Key_B);
+  EXPECT_EQ(::EEPROMKeymap.getKey(1, KeyAddr{0, 0}), Key_B);
+}
+
+TEST_F(EEPROMKeymapCompressed, LayersFollowTheStoredKeys) {
+  // The first EEPROM layer comes after the one in the sketch's keymap.
+  KeyAddr key_addr{1, 1};
+  updateKey(0, key_addr, Key_B);
+  Layer.move(1);
+
+  EXPECT_EQ(Layer.lookupActiveLayer(key_addr), 1);
+  EXPECT_EQ(Layer.lookupOnActiveLayer(key_addr), Key_B);
+
+  updateKey(0, key_addr, Key_Transparent);
+  Layer.updateActiveLayers();
+  EXPECT_EQ(Layer.lookupActiveLayer(key_addr), 0);
+}
+
+TEST_F(EEPROMKeymapCompressed, UploadsAreStoredInOrder) {
+  upload(layers * Runtime.device().numKeys(),
+         {{pos(0, KeyAddr{0, 1}), Key_A},
+          {pos(1, KeyAddr{2, 3}), Key_B},
+          {pos(3, KeyAddr{3, 15}), Key_C}});
+
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{0, 1}), Key_A);
+  EXPECT_EQ(::EEPROMKeymap.getKey(1, KeyAddr{2, 3}), Key_B);
+  EXPECT_EQ(::EEPROMKeymap.getKey(3, KeyAddr{3, 15}), Key_C);
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{0, 0}), Key_Transparent);
+  EXPECT_EQ(::EEPROMKeymap.getKey(2, KeyAddr{2, 3}), Key_Transparent);
+
+  // The counts are right too, so single keys can still be inserted.
+  updateKey(2, KeyAddr{0, 0}, Key_D);
+  EXPECT_EQ(::EEPROMKeymap.getKey(2, KeyAddr{0, 0}), Key_D);
+  EXPECT_EQ(::EEPROMKeymap.getKey(3, KeyAddr{3, 15}), Key_C);
+}
+
+TEST_F(EEPROMKeymapCompressed, UploadsReplaceTheStoredKeys) {
+  updateKey(0, KeyAddr{1, 0}, Key_A);
+  updateKey(1, KeyAddr{1, 0}, Key_B);
+  upload(layers * Runtime.device().numKeys(), {{pos(1, KeyAddr{1, 1}), Key_C}});
+
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{1, 0}), Key_Transparent);
+  EXPECT_EQ(::EEPROMKeymap.getKey(1, KeyAddr{1, 0}), Key_Transparent);
+  EXPECT_EQ(::EEPROMKeymap.getKey(1, KeyAddr{1, 1}), Key_C);
+}
+
+TEST_F(EEPROMKeymapCompressed, PartialUploadsKeepTheKeysAfterThem) {
+  updateKey(0, KeyAddr{0, 0}, Key_A);
+  updateKey(2, KeyAddr{0, 0}, Key_B);
+  updateKey(3, KeyAddr{1, 2}, Key_C);
+
+  // More keys than were stored on the first layer, so the ones after it have to
+  // make room.
+  upload(Runtime.device().numKeys(),
+         {{pos(0, KeyAddr{0, 1}), Key_D},
+          {pos(0, KeyAddr{0, 2}), Key_E},
+          {pos(0, KeyAddr{0, 3}), Key_F}});
+
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{0, 0}), Key_Transparent);
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{0, 1}), Key_D);
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{0, 2}), Key_E);
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{0, 3}), Key_F);
+  EXPECT_EQ(::EEPROMKeymap.getKey(2, KeyAddr{0, 0}), Key_B);
+  EXPECT_EQ(::EEPROMKeymap.getKey(3, KeyAddr{1, 2}), Key_C);
+
+  // And fewer, so they move back.
+  upload(Runtime.device().numKeys(), {});
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{0, 1}), Key_Transparent);
+  EXPECT_EQ(::EEPROMKeymap.getKey(2, KeyAddr{0, 0}), Key_B);
+  EXPECT_EQ(::EEPROMKeymap.getKey(3, KeyAddr{1, 2}), Key_C);
+  updateKey(1, KeyAddr{0, 0}, Key_G);
+  EXPECT_EQ(::EEPROMKeymap.getKey(1, KeyAddr{0, 0}), Key_G);
+  EXPECT_EQ(::EEPROMKeymap.getKey(3, KeyAddr{1, 2}), Key_C);
+}
+
+TEST_F(EEPROMKeymapCompressed, UploadedKeysBeyondTheCapacityAreIgnored) {
+  updateKey(3, KeyAddr{0, 0}, Key_A);
+  upload(Runtime.device().numKeys(),
+         {{0, Key_B}, {1, Key_B}, {2, Key_B}, {3, Key_B}, {4, Key_B},
+          {5, Key_B}, {6, Key_B}, {7, Key_C}, {8, Key_D}});
+
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{uint8_t(6)}), Key_B);
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{uint8_t(7)}), Key_Transparent);
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{uint8_t(8)}), Key_Transparent);
+  EXPECT_EQ(::EEPROMKeymap.getKey(3, KeyAddr{0, 0}), Key_A);
+}
+
+TEST_F(EEPROMKeymapCompressed, KeysPressedDuringAnUploadFallThrough) {
+  // The sketch's own layer has `P` there, below the first EEPROM layer.
+  KeyAddr key_addr{0, 5};
+  updateKey(0, key_addr, Key_B);
+  Layer.move(1);
+  EXPECT_EQ(Layer.lookupOnActiveLayer(key_addr), Key_B);
+
+  // The first part of an upload puts a key before the stored one.
+  stream_.addInput("keymap.custom " + std::to_string(Key_Transparent.getRaw()) +
+                   " " + std::to_string(Key_A.getRaw()) + " ");
+  sim_.RunCycles(10);
+  EXPECT_EQ(stream_.takeOutput(), "");
+
+  // Until the upload is over, the custom layers are left out.
+  sim_.Press(key_addr);
+  auto state = RunCycle();
+  ASSERT_EQ(state->HIDReports()->Keyboard().size(), 1);
+  EXPECT_THAT(state->HIDReports()->Keyboard(0).ActiveKeycodes(),
+              ::testing::ElementsAre(Key_P.getKeyCode()));
+  sim_.Release(key_addr);
+  sim_.RunCycles(2);
+
+  std::string rest;
+  for (uint8_t i = 2; i < 5; i++)
+    rest += std::to_string(Key_Transparent.getRaw()) + " ";
+  stream_.addInput(rest + std::to_string(Key_C.getRaw()) + "\n");
+  for (int i = 0; i < 100 && stream_.available(); i++)
+    sim_.RunCycle();
+  stream_.takeOutput();
+
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, KeyAddr{0, 1}), Key_A);
+  EXPECT_EQ(::EEPROMKeymap.getKey(0, key_addr), Key_C);
+  Layer.updateActiveLayers();
+  EXPECT_EQ(Layer.lookupOnActiveLayer(key_addr), Key_C);
+}
+
+TEST_F(EEPROMKeymapCompressed, BinaryTransfersAreRefused) {
+  stream_.addInput("keymap.custom.binary\n");
+  for (int i = 0; i < 100 && stream_.available(); i++)
+    sim_.RunCycle();
+
+  EXPECT_EQ(stream_.takeOutput(), std::string(1, plugin::FocusSerial::NAK) + "\r\n.\r\n");
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,159 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <string>  // for string, to_string
+
+#include "kaleidoscope/plugin/EEPROM-Keymap.h"  // for EEPROMKeymap
+#include "kaleidoscope/plugin/FocusSerial.h"    // for Focus
+#include "testing/ScriptedStream.h"             // for ScriptedStream
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+// The sketch sets up two EEPROM layers.
+constexpr uint8_t layers = 2;
+
+constexpr char terminator[] = "\r\n.\r\n";
+
+class EEPROMKeymapFocus : public VirtualDeviceTest {
+ protected:
+  ScriptedStream stream_;
+
+  void SetUp() {
+    VirtualDeviceTest::SetUp();
+    ::Focus.setSerialPort(stream_);
+    for (uint16_t pos = 0; pos < layers * Runtime.device().numKeys(); pos++)
+      ::EEPROMKeymap.updateKey(pos, Key_Transparent);
+  }
+
+  // Sends a request, and returns the response.
+  std::string request(const std::string &input) {
+    stream_.addInput(input + "\n");
+    for (int i = 0; i < 100 && stream_.available(); i++)
+      sim_.RunCycle();
+    EXPECT_EQ(stream_.available(), 0);
+    return stream_.takeOutput();
+  }
+
+  static std::string raw(Key key) {
+    return std::to_string(key.getRaw());
+  }
+
+  Key getKey(uint8_t layer, uint8_t index) {
+    return ::EEPROMKeymap.getKey(layer, KeyAddr(index));
+  }
+};
+
+TEST_F(EEPROMKeymapFocus, SetWritesTheKeysFromThePosition) {
+  EXPECT_EQ(request("keymap.custom.set 1 3 " + raw(Key_A) + " " + raw(Key_B)), terminator);
+
+  EXPECT_EQ(getKey(1, 2), Key_Transparent);
+  EXPECT_EQ(getKey(1, 3), Key_A);
+  EXPECT_EQ(getKey(1, 4), Key_B);
+  EXPECT_EQ(getKey(1, 5), Key_Transparent);
+  EXPECT_EQ(getKey(0, 3), Key_Transparent);
+}
+
+TEST_F(EEPROMKeymapFocus, SetContinuesOnTheNextLayer) {
+  uint8_t last = Runtime.device().numKeys() - 1;
+  request("keymap.custom.set 0 " + std::to_string(last) + " " + raw(Key_A) + " " + raw(Key_B));
+
+  EXPECT_EQ(getKey(0, last), Key_A);
+  EXPECT_EQ(getKey(1, 0), Key_B);
+}
+
+TEST_F(EEPROMKeymapFocus, SetIgnoresKeysPastTheLastLayer) {
+  uint8_t last = Runtime.device().numKeys() - 1;
+  EXPECT_EQ(request("keymap.custom.set 1 " + std::to_string(last) + " " +
+                    raw(Key_A) + " " + raw(Key_B)),
+            terminator);
+
+  EXPECT_EQ(getKey(1, last), Key_A);
+  EXPECT_EQ(getKey(0, 0), Key_Transparent);
+  EXPECT_EQ(getKey(1, 0), Key_Transparent);
+}
+
+TEST_F(EEPROMKeymapFocus, SetIgnoresAnInvalidLayer) {
+  EXPECT_EQ(request("keymap.custom.set 2 0 " + raw(Key_A)), terminator);
+  EXPECT_EQ(request("keymap.custom.set 255 0 " + raw(Key_A)), terminator);
+
+  for (uint8_t layer = 0; layer < layers; layer++)
+    EXPECT_EQ(getKey(layer, 0), Key_Transparent);
+}
+
+TEST_F(EEPROMKeymapFocus, SetIgnoresAnInvalidIndex) {
+  std::string index = std::to_string(Runtime.device().numKeys());
+  EXPECT_EQ(request("keymap.custom.set 0 " + index + " " + raw(Key_A)), terminator);
+
+  // The index doesn't carry over to the next layer.
+  EXPECT_EQ(getKey(1, 0), Key_Transparent);
+}
+
+TEST_F(EEPROMKeymapFocus, SetWithoutKeysWritesNothing) {
+  EXPECT_EQ(request("keymap.custom.set 1 3"), terminator);
+  EXPECT_EQ(request("keymap.custom.set 1"), terminator);
+  EXPECT_EQ(request("keymap.custom.set"), terminator);
+
+  EXPECT_EQ(getKey(1, 3), Key_Transparent);
+  EXPECT_EQ(getKey(1, 0), Key_Transparent);
+  EXPECT_EQ(getKey(0, 0), Key_Transparent);
+}
+
+TEST_F(EEPROMKeymapFocus, RangeSendsTheKeysFromThePosition) {
+  ::EEPROMKeymap.updateKey(Runtime.device().numKeys() + 3, Key_A);
+  ::EEPROMKeymap.updateKey(Runtime.device().numKeys() + 4, Key_B);
+
+  EXPECT_EQ(request("keymap.custom.range 1 2 3"),
+            raw(Key_Transparent) + " " + raw(Key_A) + " " + raw(Key_B) + " " + terminator);
+}
+
+TEST_F(EEPROMKeymapFocus, RangeStopsAtTheLastLayer) {
+  uint8_t last = Runtime.device().numKeys() - 1;
+  ::EEPROMKeymap.updateKey(Runtime.device().numKeys() + last, Key_A);
+
+  EXPECT_EQ(request("keymap.custom.range 1 " + std::to_string(last) + " 10"),
+            raw(Key_A) + " " + terminator);
+}
+
+TEST_F(EEPROMKeymapFocus, RangeSendsNothingOutOfRange) {
+  std::string index = std::to_string(Runtime.device().numKeys());
+  EXPECT_EQ(request("keymap.custom.range 2 0 1"), terminator);
+  EXPECT_EQ(request("keymap.custom.range 0 " + index + " 1"), terminator);
+}
+
+TEST_F(EEPROMKeymapFocus, RangeWithoutACountSendsNothing) {
+  EXPECT_EQ(request("keymap.custom.range 1 3"), terminator);
+  EXPECT_EQ(request("keymap.custom.range 1"), terminator);
+  EXPECT_EQ(request("keymap.custom.range"), terminator);
+}
+
+TEST_F(EEPROMKeymapFocus, HelpListsTheVariants) {
+  std::string help = request("help");
+
+  EXPECT_NE(help.find("keymap.custom\r\n"), std::string::npos);
+  EXPECT_NE(help.find("keymap.custom.binary\r\n"), std::string::npos);
+  EXPECT_NE(help.find("keymap.custom.set\r\n"), std::string::npos);
+  EXPECT_NE(help.find("keymap.custom.range\r\n"), std::string::npos);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,120 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <Kaleidoscope.h>
+#include <Kaleidoscope-FocusSerial.h>
+
+// *INDENT-OFF*
+KEYMAPS(
+    [0] = KEYMAP_STACKED
+    (
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___,
+
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___
+    ),
+)
+// *INDENT-ON*
+
+namespace kaleidoscope {
+namespace plugin {
+
+// `test.a` and `test.qxh` have the same hash, and so do `test.b` and
+// `test.qxk`, which is handled in `onFocusEvent()` rather than registered.
+static constexpr char cmd_a[] PROGMEM   = "test.a";
+static constexpr char cmd_qxh[] PROGMEM = "test.qxh";
+static constexpr char cmd_b[] PROGMEM   = "test.b";
+
+static_assert(focusserial::hashCommand("test.a") == focusserial::hashCommand("test.qxh"),
+              "test.a and test.qxh are meant to collide");
+static_assert(focusserial::hashCommand("test.b") == focusserial::hashCommand("test.qxk"),
+              "test.b and test.qxk are meant to collide");
+
+static void testA() {
+  ::Focus.send(F("a"));
+}
+
+static void testQxh() {
+  ::Focus.send(F("qxh"));
+}
+
+static void testB() {
+  ::Focus.send(F("b"));
+}
+
+static const focusserial::Command test_commands[] PROGMEM = {
+  FOCUS_COMMAND(cmd_a, testA),
+  FOCUS_COMMAND(cmd_qxh, testQxh),
+  FOCUS_COMMAND(cmd_b, testB),
+};
+
+class TestCommands : public Plugin {
+ public:
+  EventHandlerResult onSetup() {
+    ::Focus.registerCommands(table_);
+    return EventHandlerResult::OK;
+  }
+
+  // The registered commands are handled here too, with a different response,
+  // to tell which one ran.
+  EventHandlerResult onFocusEvent(const char *input) {
+    if (::Focus.inputMatchesHelp(input))
+      return ::Focus.printHelp(PSTR("test.qxk"), PSTR("test.legacy"));
+
+    if (::Focus.inputMatchesCommand(input, PSTR("test.qxk"))) {
+      ::Focus.send(F("qxk"));
+    } else if (::Focus.inputMatchesCommand(input, PSTR("test.legacy"))) {
+      ::Focus.send(F("legacy"));
+    } else if (::Focus.inputMatchesCommand(input, cmd_a) ||
+               ::Focus.inputMatchesCommand(input, cmd_qxh) ||
+               ::Focus.inputMatchesCommand(input, cmd_b)) {
+      ::Focus.send(F("onFocusEvent"));
+    } else {
+      return EventHandlerResult::OK;
+    }
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+ private:
+  static focusserial::CommandTable table_;
+};
+
+focusserial::CommandTable TestCommands::table_(test_commands);
+
+}  // namespace plugin
+}  // namespace kaleidoscope
+
+kaleidoscope::plugin::TestCommands TestCommands;
+
+KALEIDOSCOPE_INIT_PLUGINS(Focus, TestCommands);
+
+void setup() {
+  Kaleidoscope.setup();
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
@@ -0,0 +1,126 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <initializer_list>  // for initializer_list
+#include <string>            // for string
+
+#include "kaleidoscope/plugin/FocusSerial.h"           // for Focus, FocusSerial
+#include "kaleidoscope/plugin/focusserial/Commands.h"  // for Command, CommandTable, FOCUS_COMMAND
+#include "testing/ScriptedStream.h"                    // for ScriptedStream
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+constexpr char terminator[] = "\r\n.\r\n";
+
+constexpr char cmd_extra[] PROGMEM = "test.extra";
+
+void testExtra() {
+  ::Focus.send(F("extra"));
+}
+
+const plugin::focusserial::Command extra_commands[] PROGMEM = {
+  FOCUS_COMMAND(cmd_extra, testExtra),
+};
+plugin::focusserial::CommandTable extra_command_table(extra_commands);
+
+// Counts how often `help` lists `command`.
+size_t countLines(const std::string &help, const std::string &command) {
+  size_t count = 0;
+  for (size_t pos = help.find(command + "\r\n"); pos != std::string::npos;
+       pos     = help.find(command + "\r\n", pos + 1)) {
+    if (pos == 0 || help[pos - 1] == '\n')
+      count++;
+  }
+  return count;
+}
+
+class FocusCommands : public VirtualDeviceTest {
+ protected:
+  ScriptedStream stream_;
+
+  void SetUp() override {
+    ::Focus.setSerialPort(stream_);
+  }
+
+  // Sends a request, and returns the response.
+  std::string request(const std::string &input) {
+    stream_.addInput(input + "\n");
+    for (int i = 0; i < 100 && stream_.available(); i++)
+      sim_.RunCycle();
+    EXPECT_EQ(stream_.available(), 0);
+    return stream_.takeOutput();
+  }
+};
+
+// The sketch's plugin registers `test.a`, `test.qxh` and `test.b`, and answers
+// them in `onFocusEvent()` too, with `onFocusEvent`, so a registered command
+// that falls through to `onFocusEvent()` shows up in the response.
+TEST_F(FocusCommands, DispatchesRegisteredCommands) {
+  EXPECT_EQ(request("test.a"), std::string("a ") + terminator);
+  EXPECT_EQ(request("test.b"), std::string("b ") + terminator);
+}
+
+TEST_F(FocusCommands, CollidingHashesAreToldApartByName) {
+  EXPECT_EQ(request("test.qxh"), std::string("qxh ") + terminator);
+  EXPECT_EQ(request("test.a"), std::string("a ") + terminator);
+}
+
+TEST_F(FocusCommands, CollidingUnregisteredCommandsFallBackToOnFocusEvent) {
+  // Its hash is that of `test.b`.
+  EXPECT_EQ(request("test.qxk"), std::string("qxk ") + terminator);
+}
+
+TEST_F(FocusCommands, UnregisteredCommandsFallBackToOnFocusEvent) {
+  EXPECT_EQ(request("test.legacy"), std::string("legacy ") + terminator);
+
+  // Commands nobody handles get an empty response.
+  EXPECT_EQ(request("test.unknown"), terminator);
+}
+
+TEST_F(FocusCommands, PrefixesOfCommandsAreNotDispatched) {
+  EXPECT_EQ(request("test"), terminator);
+  EXPECT_EQ(request("test.aa"), terminator);
+}
+
+TEST_F(FocusCommands, RegisteringATableTwiceHasNoEffect) {
+  ::Focus.registerCommands(extra_command_table);
+  ::Focus.registerCommands(extra_command_table);
+
+  EXPECT_EQ(request("test.extra"), std::string("extra ") + terminator);
+  EXPECT_EQ(request("test.a"), std::string("a ") + terminator);
+  std::string help = request("help");
+  EXPECT_EQ(countLines(help, "test.extra"), 1U);
+  EXPECT_EQ(countLines(help, "test.a"), 1U);
+}
+
+TEST_F(FocusCommands, HelpListsAllCommands) {
+  std::string help = request("help");
+
+  for (const char *command : {"help", "device.reset", "led.modes", "plugins",
+                              "focus.binary", "test.a", "test.qxh", "test.b",
+                              "test.qxk", "test.legacy"})
+    EXPECT_EQ(countLines(help, command), 1U) << command;
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
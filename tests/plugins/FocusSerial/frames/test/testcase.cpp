@@ -0,0 +1,110 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vector>  // for vector
+
+#include "kaleidoscope/plugin/focusserial/Frame.h"  // for Frame, FrameReader
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using plugin::focusserial::Frame;
+using plugin::focusserial::FrameReader;
+
+class FocusFrames : public VirtualDeviceTest {
+ protected:
+  FrameReader reader_;
+
+  // Encodes a frame the way it goes over the wire.
+  std::vector<uint8_t> encode(std::vector<uint8_t> payload, uint8_t sequence = 0) {
+    Frame frame;
+    frame.length   = payload.size();
+    frame.sequence = sequence;
+    for (uint8_t i = 0; i < frame.length; i++)
+      frame.payload[i] = payload[i];
+    uint16_t crc = frame.crc();
+
+    std::vector<uint8_t> bytes{frame.length, frame.sequence};
+    bytes.insert(bytes.end(), payload.begin(), payload.end());
+    bytes.push_back(crc & 0xff);
+    bytes.push_back(crc >> 8);
+    return bytes;
+  }
+
+  // Feeds all the bytes to the reader, and returns the status after the last.
+  FrameReader::Status feed(const std::vector<uint8_t> &bytes) {
+    FrameReader::Status status = FrameReader::Status::INCOMPLETE;
+    for (size_t i = 0; i < bytes.size(); i++) {
+      status = reader_.consume(bytes[i]);
+      if (i + 1 < bytes.size()) {
+        EXPECT_EQ(status, FrameReader::Status::INCOMPLETE) << "at byte " << i;
+      }
+    }
+    return status;
+  }
+};
+
+TEST_F(FocusFrames, DecodesAFrame) {
+  EXPECT_EQ(feed(encode({1, 2, 3, 10, 255})), FrameReader::Status::COMPLETE);
+  ASSERT_EQ(reader_.frame().length, 5);
+  EXPECT_EQ(reader_.frame().payload[3], 10);
+  EXPECT_EQ(reader_.frame().payload[4], 255);
+}
+
+TEST_F(FocusFrames, DecodesAnEmptyFrame) {
+  EXPECT_EQ(feed(encode({})), FrameReader::Status::COMPLETE);
+  EXPECT_EQ(reader_.frame().length, 0);
+}
+
+TEST_F(FocusFrames, DecodesConsecutiveFrames) {
+  EXPECT_EQ(feed(encode({1, 2})), FrameReader::Status::COMPLETE);
+  EXPECT_EQ(feed(encode({3})), FrameReader::Status::COMPLETE);
+  ASSERT_EQ(reader_.frame().length, 1);
+  EXPECT_EQ(reader_.frame().payload[0], 3);
+}
+
+TEST_F(FocusFrames, RejectsCorruptFrames) {
+  std::vector<uint8_t> bytes = encode({1, 2, 3});
+  bytes[3] ^= 0x40;
+  EXPECT_EQ(feed(bytes), FrameReader::Status::CORRUPT);
+
+  // The next frame is read normally.
+  EXPECT_EQ(feed(encode({4})), FrameReader::Status::COMPLETE);
+}
+
+TEST_F(FocusFrames, DecodesTheSequenceNumber) {
+  EXPECT_EQ(feed(encode({1}, 7)), FrameReader::Status::COMPLETE);
+  EXPECT_EQ(reader_.frame().sequence, 7);
+}
+
+TEST_F(FocusFrames, ChecksTheSequenceNumber) {
+  std::vector<uint8_t> bytes = encode({1, 2}, 3);
+  bytes[1]                   = 4;
+  EXPECT_EQ(feed(bytes), FrameReader::Status::CORRUPT);
+}
+
+TEST_F(FocusFrames, RejectsOverlongFrames) {
+  EXPECT_EQ(reader_.consume(Frame::max_payload + 1), FrameReader::Status::CORRUPT);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
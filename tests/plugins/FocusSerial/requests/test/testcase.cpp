@@ -0,0 +1,210 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include "kaleidoscope/plugin/focusserial/RequestReader.h"  // for RequestReader
+#include "testing/ScriptedStream.h"                         // for ScriptedStream
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using plugin::focusserial::RequestReader;
+
+constexpr char terminator[] = "\r\n.\r\n";
+
+// What the command handler does, and what it saw. `keymap.custom` streams its
+// arguments, other commands read `arguments_to_read` of them.
+std::vector<std::string> commands;
+std::vector<long> arguments;
+std::vector<uint16_t> streamed;
+uint16_t streamed_count;
+uint8_t arguments_to_read;
+
+RequestReader *reader;
+ScriptedStream *stream;
+
+void onArgument(uint16_t index, uint16_t value) {
+  EXPECT_EQ(index, streamed.size());
+  streamed.push_back(value);
+}
+
+void onEnd(uint16_t count) {
+  streamed_count = count;
+}
+
+void onCommand(const char *command) {
+  commands.push_back(command);
+  if (commands.back() == "keymap.custom") {
+    reader->streamArguments(onArgument, onEnd);
+    return;
+  }
+  for (uint8_t i = 0; i < arguments_to_read; i++)
+    arguments.push_back(reader->parseInt(*stream));
+}
+
+class FocusRequests : public VirtualDeviceTest {
+ protected:
+  RequestReader reader_{onCommand};
+  ScriptedStream stream_;
+
+  void SetUp() override {
+    reader            = &reader_;
+    stream            = &stream_;
+    arguments_to_read = 0;
+    streamed_count    = 0;
+    commands.clear();
+    arguments.clear();
+    streamed.clear();
+  }
+
+  // Processes whatever input there is, the way `Focus` does once per cycle.
+  void process() {
+    reader_.process(stream_, 1000);
+  }
+  // Processes until all the input has been read.
+  void processAll() {
+    for (int i = 0; i < 100 && stream_.available(); i++)
+      process();
+    EXPECT_EQ(stream_.available(), 0);
+  }
+};
+
+TEST_F(FocusRequests, DispatchesACommand) {
+  stream_.addInput("version\n");
+  processAll();
+
+  ASSERT_EQ(commands.size(), 1U);
+  EXPECT_EQ(commands[0], "version");
+  EXPECT_EQ(stream_.takeOutput(), terminator);
+  EXPECT_FALSE(reader_.busy());
+}
+
+TEST_F(FocusRequests, DispatchesAnEmptyLine) {
+  stream_.addInput("\n");
+  processAll();
+
+  ASSERT_EQ(commands.size(), 1U);
+  EXPECT_EQ(commands[0], "");
+  EXPECT_EQ(stream_.takeOutput(), terminator);
+}
+
+TEST_F(FocusRequests, HandlerReadsItsArguments) {
+  arguments_to_read = 2;
+  stream_.addInput("layer 3 42\nversion\n");
+  processAll();
+
+  ASSERT_EQ(commands.size(), 2U);
+  EXPECT_EQ(commands[0], "layer");
+  EXPECT_EQ(commands[1], "version");
+  EXPECT_EQ(arguments, (std::vector<long>{3, 42, 0, 0}));
+  EXPECT_EQ(stream_.takeOutput(), std::string(terminator) + terminator);
+}
+
+TEST_F(FocusRequests, IgnoresArgumentsTheHandlerDidNotRead) {
+  arguments_to_read = 1;
+  stream_.addInput("layer 3 42 7\nversion\n");
+  processAll();
+
+  ASSERT_EQ(commands.size(), 2U);
+  EXPECT_EQ(commands[1], "version");
+  EXPECT_EQ(arguments[0], 3);
+  EXPECT_EQ(stream_.takeOutput(), std::string(terminator) + terminator);
+}
+
+TEST_F(FocusRequests, HandlerReadingPastTheLineKeepsTheNextRequest) {
+  // The handler expects more arguments than there are, so `parseInt()` reads
+  // the end of the line, then times out. The request is over right away, and
+  // the next one, which the host sends once it got the response, is intact.
+  arguments_to_read = 2;
+  stream_.addInput("layer 3\n");
+  processAll();
+
+  EXPECT_EQ(arguments, (std::vector<long>{3, 0}));
+  EXPECT_EQ(stream_.takeOutput(), terminator);
+  EXPECT_FALSE(reader_.busy());
+
+  arguments_to_read = 0;
+  stream_.addInput("version\n");
+  processAll();
+
+  ASSERT_EQ(commands.size(), 2U);
+  EXPECT_EQ(commands[1], "version");
+  EXPECT_EQ(stream_.takeOutput(), terminator);
+}
+
+TEST_F(FocusRequests, TerminatesWithoutWaitingForTheRestOfTheLine) {
+  // Whatever has not arrived of the line once the handler is done is not
+  // waited for.
+  stream_.addInput("version");
+  processAll();
+  EXPECT_TRUE(reader_.busy());
+  EXPECT_TRUE(commands.empty());
+
+  stream_.addInput(" 1 2");
+  processAll();
+  ASSERT_EQ(commands.size(), 1U);
+  EXPECT_EQ(stream_.takeOutput(), terminator);
+  EXPECT_FALSE(reader_.busy());
+}
+
+TEST_F(FocusRequests, StreamsArguments) {
+  stream_.addInput("keymap.custom 1 22");
+  processAll();
+
+  EXPECT_EQ(streamed, (std::vector<uint16_t>{1}));
+  EXPECT_TRUE(reader_.busy());
+  EXPECT_EQ(stream_.takeOutput(), "");
+
+  stream_.addInput("2 333\nversion\n");
+  processAll();
+
+  EXPECT_EQ(streamed, (std::vector<uint16_t>{1, 222, 333}));
+  EXPECT_EQ(streamed_count, 3);
+  ASSERT_EQ(commands.size(), 2U);
+  EXPECT_EQ(commands[1], "version");
+  EXPECT_EQ(stream_.takeOutput(), std::string(terminator) + terminator);
+}
+
+TEST_F(FocusRequests, EndsAStreamedRequestAfterTheTimeout) {
+  stream_.addInput("keymap.custom 1 2");
+  processAll();
+  EXPECT_TRUE(reader_.busy());
+
+  sim_.RunForMillis(stream_.getTimeout() + 10);
+  process();
+
+  EXPECT_EQ(streamed, (std::vector<uint16_t>{1, 2}));
+  EXPECT_EQ(streamed_count, 2);
+  EXPECT_EQ(stream_.takeOutput(), terminator);
+  EXPECT_FALSE(reader_.busy());
+}
+
+TEST_F(FocusRequests, NotesTheEndOfTheLine) {
+  // `skipLine()` reads up to the end of the line, and not beyond it.
+  stream_.addInput("1 2\nversion\n");
+  reader_.skipLine(stream_);
+  EXPECT_EQ(reader_.readByte(stream_), 'v');
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
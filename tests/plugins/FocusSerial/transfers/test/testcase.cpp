@@ -0,0 +1,178 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include "kaleidoscope/plugin/FocusSerial.h"        // for Focus, FocusSerial
+#include "kaleidoscope/plugin/focusserial/Frame.h"  // for Frame
+#include "testing/ScriptedStream.h"                 // for ScriptedStream
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using plugin::FocusSerial;
+using plugin::focusserial::Frame;
+
+constexpr KeyAddr key_addr_A{0, 0};
+
+// The end of a response.
+const std::string end = "\r\n.\r\n";
+
+class FocusTransfers : public VirtualDeviceTest {
+ protected:
+  ScriptedStream stream_;
+
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    ::Focus.setSerialPort(stream_);
+    for (uint16_t i = 0; i < 8; i++)
+      Runtime.storage().update(i, 0xff);
+  }
+
+  // Runs cycles until the response is over, and returns it.
+  std::string response(int max_cycles = 100) {
+    std::string output;
+    for (int i = 0; i < max_cycles && output.find(end) == std::string::npos; i++) {
+      sim_.RunCycle();
+      output += stream_.takeOutput();
+    }
+    return output;
+  }
+
+  // Encodes a frame the way it goes over the wire.
+  std::string encode(std::vector<uint8_t> payload, uint8_t sequence) {
+    Frame frame;
+    frame.length   = payload.size();
+    frame.sequence = sequence;
+    for (uint8_t i = 0; i < frame.length; i++)
+      frame.payload[i] = payload[i];
+    uint16_t crc = frame.crc();
+
+    std::string bytes{char(frame.length), char(frame.sequence)};
+    bytes.append(payload.begin(), payload.end());
+    bytes.push_back(crc & 0xff);
+    bytes.push_back(crc >> 8);
+    return bytes;
+  }
+
+  std::vector<uint8_t> storage(uint16_t size) {
+    std::vector<uint8_t> bytes;
+    for (uint16_t i = 0; i < size; i++)
+      bytes.push_back(Runtime.storage().read(i));
+    return bytes;
+  }
+};
+
+TEST_F(FocusTransfers, SendsNumberedFrames) {
+  Runtime.storage().update(0, 1);
+  Runtime.storage().update(1, 2);
+  stream_.addInput("test.send\n");
+  stream_.addInput(std::string(1, FocusSerial::ACK));
+
+  EXPECT_EQ(response(), encode({1, 2}, 0) + encode({}, 1) + "true " + end);
+}
+
+TEST_F(FocusTransfers, SendsTheWindowAgainAfterANak) {
+  Runtime.storage().update(0, 1);
+  Runtime.storage().update(1, 2);
+  stream_.addInput("test.send\n");
+  stream_.addInput(std::string(1, FocusSerial::NAK));
+  stream_.addInput(std::string(1, FocusSerial::ACK));
+
+  std::string window = encode({1, 2}, 0) + encode({}, 1);
+  EXPECT_EQ(response(), window + window + "true " + end);
+}
+
+TEST_F(FocusTransfers, ReceivesFrames) {
+  stream_.addInput("test.receive 1 4\n");
+  stream_.addInput(encode({1, 2}, 0));
+  stream_.addInput(encode({3, 4}, 1));
+
+  EXPECT_EQ(response(), std::string(3, FocusSerial::ACK) + "true " + end);
+  EXPECT_EQ(storage(6), (std::vector<uint8_t>{0xff, 1, 2, 3, 4, 0xff}));
+}
+
+TEST_F(FocusTransfers, AcknowledgesAResentFrameWithoutWritingIt) {
+  // The ACK of the first frame got lost, so the host sends it again.
+  stream_.addInput("test.receive 0 4\n");
+  stream_.addInput(encode({1, 2}, 0));
+  stream_.addInput(encode({1, 2}, 0));
+  stream_.addInput(encode({3, 4}, 1));
+
+  EXPECT_EQ(response(), std::string(4, FocusSerial::ACK) + "true " + end);
+  EXPECT_EQ(storage(5), (std::vector<uint8_t>{1, 2, 3, 4, 0xff}));
+}
+
+TEST_F(FocusTransfers, RejectsAnEmptyFrameBeforeTheEnd) {
+  stream_.addInput("test.receive 0 4\n");
+  stream_.addInput(encode({}, 0));
+
+  // Nothing follows, so the transfer gives up once the NAK goes unanswered.
+  EXPECT_EQ(response(10000),
+            std::string(1, FocusSerial::ACK) + std::string(1, FocusSerial::NAK) + "false " + end);
+  EXPECT_EQ(storage(8), std::vector<uint8_t>(8, 0xff));
+}
+
+TEST_F(FocusTransfers, StopsDiscardingInputAfterTheTimeout) {
+  // A corrupt frame, followed by a host that never stops sending.
+  stream_.addInput("test.receive 0 4\n");
+  std::string corrupt = encode({1, 2}, 0);
+  corrupt.back() ^= 0xff;
+  stream_.addInput(corrupt);
+
+  std::string output;
+  for (int i = 0; i < 10000 && output.find(end) == std::string::npos; i++) {
+    stream_.addInput(std::string(8, '\x7f'));
+    sim_.RunCycle();
+    output += stream_.takeOutput();
+  }
+  EXPECT_NE(output.find(std::string("false ") + end), std::string::npos);
+  EXPECT_EQ(storage(8), std::vector<uint8_t>(8, 0xff));
+}
+
+TEST_F(FocusTransfers, RejectsAnInvalidRange) {
+  stream_.addInput("test.receive 6 4\n");
+
+  EXPECT_EQ(response(), std::string(1, FocusSerial::NAK) + "false " + end);
+  EXPECT_EQ(storage(8), std::vector<uint8_t>(8, 0xff));
+}
+
+TEST_F(FocusTransfers, KeysAreScannedDuringATransfer) {
+  stream_.addInput("test.receive 0 4\n");
+  stream_.addInput(encode({1, 2}, 0));
+  sim_.RunCycles(10);
+  EXPECT_EQ(stream_.takeOutput(), std::string(2, FocusSerial::ACK));
+
+  // The second frame is late, and a key is pressed meanwhile.
+  sim_.Press(key_addr_A);
+  auto state = RunCycle();
+  ASSERT_EQ(state->HIDReports()->Keyboard().size(), 1);
+  EXPECT_THAT(state->HIDReports()->Keyboard(0).ActiveKeycodes(),
+              ::testing::ElementsAre(Key_A.getKeyCode()));
+
+  stream_.addInput(encode({3, 4}, 1));
+  EXPECT_EQ(response(), std::string(1, FocusSerial::ACK) + "true " + end);
+  EXPECT_EQ(storage(5), (std::vector<uint8_t>{1, 2, 3, 4, 0xff}));
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
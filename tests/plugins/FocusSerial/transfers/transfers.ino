@@ -0,0 +1,79 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <Kaleidoscope.h>
+#include <Kaleidoscope-FocusSerial.h>
+
+// *INDENT-OFF*
+KEYMAPS(
+    [0] = KEYMAP_STACKED
+    (
+        Key_A, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___,
+
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___, ___, ___, ___,
+        ___, ___, ___, ___,
+        ___
+    ),
+)
+// *INDENT-ON*
+
+namespace kaleidoscope {
+namespace plugin {
+
+// Transfers the first few bytes of storage with `test.send` and `test.receive`,
+// and reports whether the transfer succeeded at the end of the response.
+class TestTransfers : public kaleidoscope::Plugin {
+ public:
+  EventHandlerResult onFocusEvent(const char *input) {
+    if (::Focus.inputMatchesCommand(input, PSTR("test.send"))) {
+      ::Focus.sendStorage(0, 2, report);
+    } else if (::Focus.inputMatchesCommand(input, PSTR("test.receive"))) {
+      ::Focus.receiveStorage(0, 8, report);
+    } else {
+      return EventHandlerResult::OK;
+    }
+    return EventHandlerResult::EVENT_CONSUMED;
+  }
+
+ private:
+  static void report(bool success) {
+    ::Focus.send(success);
+  }
+};
+
+}  // namespace plugin
+}  // namespace kaleidoscope
+
+kaleidoscope::plugin::TestTransfers TestTransfers;
+
+KALEIDOSCOPE_INIT_PLUGINS(Focus, TestTransfers);
+
+void setup() {
+  Kaleidoscope.setup();
+}
+
+void loop() {
+  Kaleidoscope.loop();
+}
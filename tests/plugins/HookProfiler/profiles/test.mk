@@ -0,0 +1,2 @@
+# The profiling has to be compiled into the whole sketch, libraries included.
+export LOCAL_CFLAGS += -DKALEIDOSCOPE_PROFILE_HOOKS
@@ -0,0 +1,119 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>  // for istringstream
+#include <string>   // for string
+
+#include "kaleidoscope/plugin/FocusSerial.h"  // for Focus
+#include "testing/ScriptedStream.h"           // for ScriptedStream
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+using ::testing::Ge;
+using ::testing::Gt;
+
+// The end of a response.
+const std::string end = "\r\n.\r\n";
+
+// The least time, in microseconds, each call of `BusyPlugin`'s hook takes.
+constexpr uint32_t busy_hook_time = 3000;
+
+// One line of `profile.hooks`.
+struct Profile {
+  uint32_t count      = 0;
+  uint32_t total_time = 0;
+  uint32_t max_time   = 0;
+};
+
+class HookProfiles : public VirtualDeviceTest {
+ protected:
+  ScriptedStream stream_;
+
+  void SetUp() override {
+    VirtualDeviceTest::SetUp();
+    ::Focus.setSerialPort(stream_);
+  }
+
+  // Sends a command, and returns its response (without the end marker).
+  std::string command(const std::string &input) {
+    stream_.addInput(input + "\n");
+    std::string output;
+    for (int i = 0; i < 10 && output.find(end) == std::string::npos; i++) {
+      sim_.RunCycle();
+      output += stream_.takeOutput();
+    }
+    EXPECT_NE(output.find(end), std::string::npos) << "No response to " << input;
+    return output.substr(0, output.find(end));
+  }
+
+  // Finds the profile of a plugin's hook in a report.
+  bool find(const std::string &report, const std::string &plugin,
+            const std::string &hook, Profile &profile) {
+    std::istringstream words(report);
+    std::string name, hook_name;
+    while (words >> name) {
+      if (name != plugin)
+        continue;
+      if (words >> hook_name >> profile.count >> profile.total_time >> profile.max_time &&
+          hook_name == hook)
+        return true;
+    }
+    return false;
+  }
+};
+
+TEST_F(HookProfiles, CountsAndTimesEachPluginsHooks) {
+  EXPECT_EQ(command("profile.reset"), "");
+  sim_.RunCycles(10);
+  std::string report = command("profile.hooks");
+
+  // The report is sent from Focus' own `afterEachCycle()`, so the hooks of the
+  // plugins before it have already run in that cycle too.
+  Profile busy, idle;
+  ASSERT_TRUE(find(report, "BusyPlugin", "afterEachCycle", busy)) << report;
+  ASSERT_TRUE(find(report, "IdlePlugin", "afterEachCycle", idle)) << report;
+
+  EXPECT_EQ(busy.count, 11u);
+  EXPECT_EQ(idle.count, 11u);
+
+  EXPECT_THAT(busy.max_time, Ge(busy_hook_time));
+  EXPECT_THAT(busy.total_time, Ge(busy.count * busy_hook_time));
+  EXPECT_THAT(busy.total_time, Gt(idle.total_time))
+    << "More time should be spent in the busy hook than in the idle one";
+  EXPECT_THAT(busy.max_time * busy.count, Ge(busy.total_time));
+  EXPECT_THAT(idle.max_time * idle.count, Ge(idle.total_time));
+}
+
+TEST_F(HookProfiles, StartsOverAfterAReset) {
+  sim_.RunCycles(5);
+  EXPECT_EQ(command("profile.reset"), "");
+  std::string report = command("profile.hooks");
+
+  Profile busy;
+  ASSERT_TRUE(find(report, "BusyPlugin", "afterEachCycle", busy)) << report;
+  EXPECT_EQ(busy.count, 1u)
+    << "Only the hook of the cycle with the report should be counted";
+  EXPECT_EQ(busy.max_time, busy.total_time);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
@@ -0,0 +1,106 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "kaleidoscope/plugin/IdleLEDs.h"    // for IdleLEDs
+#include "kaleidoscope/plugin/LEDControl.h"  // for LEDControl
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+constexpr KeyAddr key_a{0, 0};
+
+// Longer than the interval between two LED updates.
+constexpr uint32_t led_sync_delay = 50;
+
+class IdleLEDsTimer : public VirtualDeviceTest {
+ protected:
+  void SetUp() {
+    VirtualDeviceTest::SetUp();
+    ::IdleLEDs.setIdleTimeoutSeconds(1);
+    ::LEDControl.enable();
+    tapKey();
+  }
+
+  // Restarts the idle timeout.
+  void tapKey() {
+    sim_.Press(key_a);
+    sim_.RunCycle();
+    sim_.Release(key_a);
+    sim_.RunCycle();
+  }
+};
+
+TEST_F(IdleLEDsTimer, TurnsTheLEDsOffWhenIdle) {
+  sim_.RunForMillis(990);
+  EXPECT_TRUE(::LEDControl.isEnabled());
+  sim_.RunForMillis(20);
+  EXPECT_FALSE(::LEDControl.isEnabled());
+
+  tapKey();
+  EXPECT_TRUE(::LEDControl.isEnabled());
+}
+
+TEST_F(IdleLEDsTimer, KeyPressesRestartTheTimeout) {
+  sim_.RunForMillis(600);
+  tapKey();
+  sim_.RunForMillis(600);
+  EXPECT_TRUE(::LEDControl.isEnabled());
+  sim_.RunForMillis(500);
+  EXPECT_FALSE(::LEDControl.isEnabled());
+}
+
+TEST_F(IdleLEDsTimer, SettingTheTimeoutRestartsTheTimer) {
+  ::IdleLEDs.setIdleTimeoutSeconds(0);
+  sim_.RunForMillis(1500);
+  EXPECT_TRUE(::LEDControl.isEnabled());
+
+  // The timeout still counts from the last key press.
+  ::IdleLEDs.setIdleTimeoutSeconds(2);
+  sim_.RunForMillis(400);
+  EXPECT_TRUE(::LEDControl.isEnabled());
+  sim_.RunForMillis(200);
+  EXPECT_FALSE(::LEDControl.isEnabled());
+}
+
+TEST_F(IdleLEDsTimer, LEDsTurnedBackOnAfterTheTimeoutGoOffAgain) {
+  // Someone else turns the LEDs off, so the timeout finds nothing to do.
+  ::LEDControl.disable();
+  sim_.RunForMillis(1100);
+
+  ::LEDControl.enable();
+  sim_.RunForMillis(led_sync_delay);
+  EXPECT_FALSE(::LEDControl.isEnabled());
+}
+
+TEST_F(IdleLEDsTimer, RaisingTheLimitDirectlyStartsTheTimer) {
+  ::IdleLEDs.setIdleTimeoutSeconds(0);
+  sim_.RunForMillis(100);
+
+  ::IdleLEDs.idle_time_limit = 1000;
+  sim_.RunForMillis(850);
+  EXPECT_TRUE(::LEDControl.isEnabled());
+  sim_.RunForMillis(50 + led_sync_delay);
+  EXPECT_FALSE(::LEDControl.isEnabled());
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope
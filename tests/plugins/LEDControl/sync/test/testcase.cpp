@@ -0,0 +1,77 @@
+/* -*- mode: c++ -*-
+ * Copyright (C) 2022  Keyboard.io, Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <Kaleidoscope-LEDControl.h>
+#include <stdint.h>  // for uint32_t
+
+#include "testing/setup-googletest.h"
+
+SETUP_GOOGLETEST();
+
+namespace kaleidoscope {
+namespace testing {
+namespace {
+
+constexpr KeyAddr key_addr{0, 0};
+
+class LEDSync : public VirtualDeviceTest {
+ protected:
+  void SetUp() {
+    VirtualDeviceTest::SetUp();
+    // Let the initial frame get synced.
+    sim_.RunForMillis(100);
+  }
+
+  uint32_t syncCount() {
+    return Runtime.device().ledDriver().syncCount();
+  }
+};
+
+TEST_F(LEDSync, UnchangedFramesAreNotSynced) {
+  uint32_t syncs = syncCount();
+  sim_.RunForMillis(500);
+  EXPECT_EQ(syncCount(), syncs);
+
+  // Repainting an LED with the color it already has changes nothing either.
+  ::LEDControl.refreshAt(key_addr);
+  sim_.RunForMillis(100);
+  EXPECT_EQ(syncCount(), syncs);
+}
+
+TEST_F(LEDSync, ChangedFramesAreSyncedOnce) {
+  uint32_t syncs = syncCount();
+  ::LEDControl.setCrgbAt(key_addr, CRGB(0, 0, 160));
+  sim_.RunForMillis(100);
+  EXPECT_EQ(syncCount(), syncs + 1);
+  EXPECT_EQ(::LEDControl.getCrgbAt(key_addr).b, 160);
+
+  ::LEDControl.refreshAt(key_addr);
+  sim_.RunForMillis(100);
+  EXPECT_EQ(syncCount(), syncs + 2);
+  EXPECT_EQ(::LEDControl.getCrgbAt(key_addr).r, 160);
+}
+
+TEST_F(LEDSync, BrightnessChangesAreSynced) {
+  uint32_t syncs = syncCount();
+  ::LEDControl.setBrightness(::LEDControl.getBrightness());
+  sim_.RunForMillis(100);
+  EXPECT_EQ(syncCount(), syncs + 1);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace kaleidoscope